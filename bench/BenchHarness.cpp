@@ -0,0 +1,333 @@
+#include "BenchHarness.h"
+#include "Tokenizer.h"
+#include "AllocTracker.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+namespace hft {
+namespace bench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedNs(Clock::time_point start, Clock::time_point end) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+// Smallest back-to-back clock reading difference, subtracted from per-op samples
+double measureTimerOverhead() {
+    double best = 1e9;
+    for (int i = 0; i < 1000; ++i) {
+        auto a = Clock::now();
+        auto b = Clock::now();
+        best = std::min(best, elapsedNs(a, b));
+    }
+    return best;
+}
+
+void summarize(std::vector<double>& values, BenchResult& result) {
+    std::sort(values.begin(), values.end());
+    result.samples = values.size();
+    if (values.empty()) {
+        return;
+    }
+    result.min = values.front();
+    result.max = values.back();
+    result.p50 = percentile(values, 50.0);
+    result.p90 = percentile(values, 90.0);
+    result.p99 = percentile(values, 99.0);
+
+    double sum = 0.0;
+    for (double v : values) sum += v;
+    result.mean = sum / values.size();
+    double ss = 0.0;
+    for (double v : values) ss += (v - result.mean) * (v - result.mean);
+    result.stddev = values.size() > 1 ? std::sqrt(ss / (values.size() - 1)) : 0.0;
+}
+
+void writeJsonString(std::FILE* f, const std::string& text) {
+    std::fputc('"', f);
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            std::fputc('\\', f);
+            std::fputc(c, f);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            std::fprintf(f, "\\u%04x", c);
+        } else {
+            std::fputc(c, f);
+        }
+    }
+    std::fputc('"', f);
+}
+
+void writeParams(std::FILE* f, const std::vector<std::pair<std::string, std::string>>& params) {
+    std::fputc('{', f);
+    for (size_t i = 0; i < params.size(); ++i) {
+        if (i > 0) std::fputs(", ", f);
+        writeJsonString(f, params[i].first);
+        std::fputs(": ", f);
+        writeJsonString(f, params[i].second);
+    }
+    std::fputc('}', f);
+}
+
+// Measured-rep counter totals divided per operation, plus IPC when both sides opened
+std::vector<std::pair<std::string, double>> perOpCounters(const PerfReading& before, const PerfReading& after,
+                                                          double ops) {
+    std::vector<std::pair<std::string, double>> out;
+    double delta[PERF_EVENT_COUNT];
+    for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        delta[i] = after.values[i] - before.values[i];
+        if (after.valid[i] && before.valid[i]) {
+            out.emplace_back(PerfCounters::name(static_cast<PerfEvent>(i)), delta[i] / ops);
+        }
+    }
+    size_t cycles = static_cast<size_t>(PerfEvent::CYCLES);
+    size_t instructions = static_cast<size_t>(PerfEvent::INSTRUCTIONS);
+    if (after.valid[cycles] && after.valid[instructions] && delta[cycles] > 0.0) {
+        out.emplace_back("ipc", delta[instructions] / delta[cycles]);
+    }
+    return out;
+}
+
+} // namespace
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+BenchRunner::BenchRunner(const BenchOptions& opts)
+    : options(opts), timer_overhead_ns(measureTimerOverhead()) {
+    if (!options.perf || options.list_only) {
+        return;
+    }
+    counters.reset(new PerfCounters());
+    if (!counters->open()) {
+        std::cerr << "Perf counters unavailable: " << counters->getUnavailableReason() << "; timing only\n";
+        counters.reset();
+    } else if (!counters->getUnavailableReason().empty()) {
+        std::cerr << "Perf counters: " << counters->getUnavailableReason() << "\n";
+    }
+}
+
+void BenchRunner::add(Benchmark benchmark) {
+    benchmarks.push_back(std::move(benchmark));
+}
+
+std::string BenchRunner::displayName(const Benchmark& benchmark) {
+    std::string name = benchmark.name;
+    if (!benchmark.params.empty()) {
+        name += '[';
+        for (size_t i = 0; i < benchmark.params.size(); ++i) {
+            if (i > 0) name += ',';
+            name += benchmark.params[i].first + '=' + benchmark.params[i].second;
+        }
+        name += ']';
+    }
+    return name;
+}
+
+BenchResult BenchRunner::runOne(Benchmark& benchmark) {
+    BenchResult result;
+    result.name = benchmark.name;
+    result.params = benchmark.params;
+    result.ops_per_rep = benchmark.ops_per_rep;
+    result.per_op = benchmark.per_op;
+
+    std::vector<double> op_samples;
+    if (benchmark.per_op) {
+        op_samples.reserve(benchmark.ops_per_rep * options.repetitions);
+    }
+
+    size_t ops = benchmark.ops_per_rep;
+    uint64_t measured_allocs = 0;
+    PerfReading counters_before = {};
+    if (counters) {
+        counters_before = counters->read();
+    }
+    for (size_t rep = 0; rep < options.warmup + options.repetitions; ++rep) {
+        if (benchmark.setup) {
+            benchmark.setup();
+        }
+        bool measured = rep >= options.warmup;
+        AllocScope allocs;
+
+        // Counters run for whole measured repetitions only; for per-op
+        // benchmarks that includes the clock reads between operations
+        if (measured && counters) {
+            counters->enable();
+        }
+
+        if (!benchmark.per_op) {
+            auto start = Clock::now();
+            benchmark.run(0, ops);
+            auto end = Clock::now();
+            if (measured && counters) {
+                counters->disable();
+            }
+            if (measured) {
+                result.rep_ns_per_op.push_back(elapsedNs(start, end) / ops);
+                measured_allocs += allocs.allocations();
+            }
+            continue;
+        }
+
+        double rep_total = 0.0;
+        for (size_t i = 0; i < ops; ++i) {
+            auto start = Clock::now();
+            benchmark.run(i, i + 1);
+            auto end = Clock::now();
+            double ns = std::max(0.0, elapsedNs(start, end) - timer_overhead_ns);
+            rep_total += ns;
+            if (measured) {
+                op_samples.push_back(ns);  // Reserved up front, so no allocation is counted
+            }
+        }
+        if (measured && counters) {
+            counters->disable();
+        }
+        if (measured) {
+            result.rep_ns_per_op.push_back(rep_total / ops);
+            measured_allocs += allocs.allocations();
+        }
+    }
+
+    if (AllocTracker::isInstalled()) {
+        result.allocs_per_op = static_cast<double>(measured_allocs) / (ops * options.repetitions);
+    }
+    if (counters) {
+        result.counters = perOpCounters(counters_before, counters->read(),
+                                        static_cast<double>(ops * options.repetitions));
+    }
+
+    if (benchmark.per_op) {
+        summarize(op_samples, result);
+    } else {
+        std::vector<double> reps = result.rep_ns_per_op;
+        summarize(reps, result);
+    }
+    return result;
+}
+
+std::vector<BenchResult> BenchRunner::runAll() {
+    std::vector<BenchResult> results;
+
+    if (!options.list_only) {
+        std::printf("%-56s %10s %10s %10s %10s %12s %10s\n", "benchmark (ns/op)", "p50", "p90", "p99", "mean", "ops/s",
+                    "allocs/op");
+    }
+    for (Benchmark& benchmark : benchmarks) {
+        std::string name = displayName(benchmark);
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        if (options.list_only) {
+            std::printf("%s\n", name.c_str());
+            continue;
+        }
+
+        BenchResult result = runOne(benchmark);
+        double ops_per_sec = result.mean > 0.0 ? 1e9 / result.mean : 0.0;
+        char allocs[16] = "-";
+        if (result.allocs_per_op >= 0.0) {
+            std::snprintf(allocs, sizeof(allocs), "%.2f", result.allocs_per_op);
+        }
+        std::printf("%-56s %10.1f %10.1f %10.1f %10.1f %12.0f %10s%s\n", name.c_str(), result.p50, result.p90,
+                    result.p99, result.mean, ops_per_sec, allocs, result.per_op ? "  (per-op)" : "");
+        if (!result.counters.empty()) {
+            std::printf("    per op:");
+            for (const auto& counter : result.counters) {
+                std::printf("  %s %.2f", counter.first.c_str(), counter.second);
+            }
+            std::printf("\n");
+        }
+        std::fflush(stdout);
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+bool BenchRunner::writeJson(const std::string& path, const std::vector<BenchResult>& results,
+                            const std::vector<std::pair<std::string, std::string>>& context) const {
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) {
+        std::cerr << "Could not write " << path << "\n";
+        return false;
+    }
+
+    std::fprintf(f, "{\n  \"schema\": 1,\n  \"unit\": \"ns/op\",\n  \"context\": ");
+    writeParams(f, context);
+    std::fprintf(f, ",\n  \"warmup\": %zu,\n  \"repetitions\": %zu,\n  \"timer_overhead_ns\": %.1f,\n",
+                 options.warmup, options.repetitions, timer_overhead_ns);
+    std::fprintf(f, "  \"benchmarks\": [");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        std::fprintf(f, "%s\n    {\"name\": ", i > 0 ? "," : "");
+        writeJsonString(f, r.name);
+        std::fprintf(f, ", \"params\": ");
+        writeParams(f, r.params);
+        std::fprintf(f, ", \"mode\": \"%s\", \"ops_per_rep\": %zu, \"samples\": %zu,\n",
+                     r.per_op ? "per_op" : "batch", r.ops_per_rep, r.samples);
+        std::fprintf(f, "     \"min\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f, "
+                        "\"mean\": %.3f, \"stddev\": %.3f,\n",
+                     r.min, r.p50, r.p90, r.p99, r.max, r.mean, r.stddev);
+        if (r.allocs_per_op >= 0.0) {
+            std::fprintf(f, "     \"allocs_per_op\": %.4f,\n", r.allocs_per_op);
+        }
+        if (!r.counters.empty()) {
+            std::fprintf(f, "     \"counters\": {");
+            for (size_t k = 0; k < r.counters.size(); ++k) {
+                std::fprintf(f, "%s\"%s\": %.4f", k > 0 ? ", " : "", r.counters[k].first.c_str(),
+                             r.counters[k].second);
+            }
+            std::fprintf(f, "},\n");
+        }
+        std::fprintf(f, "     \"rep_ns_per_op\": [");
+        for (size_t k = 0; k < r.rep_ns_per_op.size(); ++k) {
+            std::fprintf(f, "%s%.3f", k > 0 ? ", " : "", r.rep_ns_per_op[k]);
+        }
+        std::fprintf(f, "]}");
+    }
+    std::fprintf(f, "\n  ]\n}\n");
+    std::fclose(f);
+    return true;
+}
+
+bool BenchRunner::parseArgs(int argc, char* argv[], BenchOptions& out) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        uint64_t number = 0;
+        if (arg == "--list") {
+            out.list_only = true;
+        } else if (arg == "--perf") {
+            out.perf = true;
+        } else if (arg == "--filter" && has_value) {
+            out.filter = argv[++i];
+        } else if (arg == "--json" && has_value) {
+            out.json_path = argv[++i];
+        } else if (arg == "--reps" && has_value && utils::parseUInt64(argv[i + 1], number) && number > 0) {
+            out.repetitions = number;
+            ++i;
+        } else if (arg == "--warmup" && has_value && utils::parseUInt64(argv[i + 1], number)) {
+            out.warmup = number;
+            ++i;
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--filter TEXT] [--reps N] [--warmup N] [--json FILE] [--list] [--perf]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace bench
+} // namespace hft
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "PerfCounters.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace hft {
+namespace bench {
+
+// Minimal microbenchmark harness.
+//
+// A benchmark pre-generates its workload in setup() (untimed, before every
+// repetition) and then executes operations [begin, end) of it in run().
+// Batch benchmarks time each repetition as a whole and report ns/op per
+// repetition; per-op benchmarks time every operation individually (minus the
+// measured clock overhead) to expose tail latency. Either way the raw
+// per-repetition ns/op values are kept so results can be compared
+// statistically across runs (tools/bench_compare.py). Heap allocations made
+// by run() are counted via AllocTracker when the interposer is linked, and
+// with --perf the measured repetitions are also wrapped in perf counters.
+struct Benchmark {
+    std::string name;                                        // "group/case"
+    std::vector<std::pair<std::string, std::string>> params; // Reported verbatim
+    size_t ops_per_rep = 1000;
+    bool per_op = false;
+    std::function<void()> setup;
+    std::function<void(size_t begin, size_t end)> run;
+};
+
+struct BenchResult {
+    std::string name;
+    std::vector<std::pair<std::string, std::string>> params;
+    size_t ops_per_rep = 0;
+    bool per_op = false;
+    std::vector<double> rep_ns_per_op;  // One value per measured repetition
+    size_t samples = 0;                 // Values behind the percentiles
+    double min = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    double stddev = 0.0;
+    double allocs_per_op = -1.0;        // Heap allocations inside run(); -1 without the interposer
+    // Per-op perf counters ("cycles", "ipc", ...); only the events that opened
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+struct BenchOptions {
+    size_t warmup = 3;
+    size_t repetitions = 20;
+    std::string filter;     // Substring of "name" or "name[params]"
+    std::string json_path;  // Empty: no JSON output
+    bool list_only = false;
+    bool perf = false;      // Capture perf counters; timing only if unavailable
+};
+
+class BenchRunner {
+private:
+    BenchOptions options;
+    std::vector<Benchmark> benchmarks;
+    double timer_overhead_ns;
+    std::unique_ptr<PerfCounters> counters;  // Null unless --perf and something opened
+
+    BenchResult runOne(Benchmark& benchmark);
+
+public:
+    explicit BenchRunner(const BenchOptions& opts);
+
+    void add(Benchmark benchmark);
+    const BenchOptions& getOptions() const { return options; }
+    double getTimerOverheadNs() const { return timer_overhead_ns; }
+
+    // Runs every benchmark matching the filter, printing a table as it goes
+    std::vector<BenchResult> runAll();
+
+    bool writeJson(const std::string& path, const std::vector<BenchResult>& results,
+                   const std::vector<std::pair<std::string, std::string>>& context) const;
+
+    // --filter S, --reps N, --warmup N, --json FILE, --list, --perf; false on bad arguments
+    static bool parseArgs(int argc, char* argv[], BenchOptions& out);
+
+    static std::string displayName(const Benchmark& benchmark);
+};
+
+// Nearest-rank percentile (0-100) of ascending values
+double percentile(const std::vector<double>& sorted, double p);
+
+// Keeps a value (and the work producing it) from being optimized away
+template<typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+} // namespace bench
+} // namespace hft
@@ -0,0 +1,138 @@
+#include "PerfCounters.h"
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace hft {
+namespace bench {
+
+namespace {
+
+const char* const EVENT_NAMES[PERF_EVENT_COUNT] = {
+    "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "page_faults", "context_switches"};
+
+#ifdef __linux__
+struct EventConfig {
+    uint32_t type;
+    uint64_t config;
+};
+
+const EventConfig EVENT_CONFIGS[PERF_EVENT_COUNT] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+};
+
+// value, time enabled, time running
+struct RawCount {
+    uint64_t value;
+    uint64_t enabled;
+    uint64_t running;
+};
+#endif
+
+} // namespace
+
+PerfCounters::PerfCounters() {
+    for (int& fd : fds) {
+        fd = -1;
+    }
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (int fd : fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+bool PerfCounters::open() {
+#ifdef __linux__
+    bool any = false;
+    std::string missing;
+    int first_errno = 0;
+    for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = EVENT_CONFIGS[i].type;
+        attr.config = EVENT_CONFIGS[i].config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fd >= 0) {
+            fds[i] = static_cast<int>(fd);
+            any = true;
+        } else {
+            if (first_errno == 0) {
+                first_errno = errno;
+            }
+            missing += missing.empty() ? "" : ", ";
+            missing += EVENT_NAMES[i];
+        }
+    }
+    if (!missing.empty()) {
+        reason = missing + " unavailable (" + std::strerror(first_errno) + ")";
+    }
+    return any;
+#else
+    reason = "perf_event_open is Linux-only";
+    return false;
+#endif
+}
+
+void PerfCounters::enable() {
+#ifdef __linux__
+    prctl(PR_TASK_PERF_EVENTS_ENABLE);
+#endif
+}
+
+void PerfCounters::disable() {
+#ifdef __linux__
+    prctl(PR_TASK_PERF_EVENTS_DISABLE);
+#endif
+}
+
+PerfReading PerfCounters::read() const {
+    PerfReading reading;
+    for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        reading.valid[i] = false;
+        reading.values[i] = 0.0;
+#ifdef __linux__
+        RawCount raw;
+        if (fds[i] < 0 || ::read(fds[i], &raw, sizeof(raw)) != static_cast<ssize_t>(sizeof(raw))) {
+            continue;
+        }
+        reading.valid[i] = true;
+        // Scale up if the kernel multiplexed the counter off the PMU
+        reading.values[i] = (raw.running > 0 && raw.running < raw.enabled)
+            ? static_cast<double>(raw.value) * raw.enabled / raw.running
+            : static_cast<double>(raw.value);
+#endif
+    }
+    return reading;
+}
+
+const char* PerfCounters::name(PerfEvent event) {
+    return EVENT_NAMES[static_cast<size_t>(event)];
+}
+
+} // namespace bench
+} // namespace hft
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace hft {
+namespace bench {
+
+enum class PerfEvent {
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_MISSES,        // L1 data cache read misses
+    LLC_MISSES,        // Last-level cache misses
+    BRANCH_MISSES,
+    PAGE_FAULTS,       // Software events: available even without a PMU
+    CONTEXT_SWITCHES,
+    COUNT
+};
+
+constexpr size_t PERF_EVENT_COUNT = static_cast<size_t>(PerfEvent::COUNT);
+
+struct PerfReading {
+    bool valid[PERF_EVENT_COUNT];
+    double values[PERF_EVENT_COUNT];  // Scaled for multiplexing
+};
+
+// Linux perf_event_open counters for the calling thread, user space only.
+//
+// Every event is opened on its own, so a missing one (no PMU in a VM,
+// perf_event_paranoid, seccomp in a container) only drops that column; if
+// nothing opens, open() fails with a reason and callers fall back to timing.
+// enable()/disable() toggle all counters of the thread with one prctl, and
+// counts accumulate across toggles until the next read().
+class PerfCounters {
+private:
+    int fds[PERF_EVENT_COUNT];
+    std::string reason;
+
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool open();  // True if at least one event is available
+    bool isAvailable(PerfEvent event) const { return fds[static_cast<size_t>(event)] >= 0; }
+    const std::string& getUnavailableReason() const { return reason; }
+
+    void enable();
+    void disable();
+    PerfReading read() const;
+
+    static const char* name(PerfEvent event);
+};
+
+} // namespace bench
+} // namespace hft
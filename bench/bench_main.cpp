@@ -0,0 +1,720 @@
+#include "BenchHarness.h"
+#include "OrderBook.h"
+#include "PriceGenerator.h"
+#include "MarketMaker.h"
+#include "PnLCalculator.h"
+#include "PortfolioPnL.h"
+#include "SlidingStats.h"
+#include "NumericKernels.h"
+#include "Random.h"
+#include "Tokenizer.h"
+#include "TimestampFormatter.h"
+#include "Clock.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hft;
+using namespace hft::bench;
+
+namespace {
+
+// Every workload is generated from this seed so runs are comparable
+constexpr uint64_t WORKLOAD_SEED = 0x5eed2024;
+
+constexpr double MID_PRICE = 100.0;
+constexpr double TICK = 0.01;
+
+// Limit order flow around a fixed mid: distance from the touch is geometric
+// (most orders join or sit near the best levels, a long tail rests deep) and
+// sizes are lognormal around 100 shares, rounded to whole shares.
+struct OrderFlow {
+    Xoshiro256pp rng{WORKLOAD_SEED};
+
+    OrderSide side() { return (rng() & 1) ? OrderSide::BUY : OrderSide::SELL; }
+
+    double price(OrderSide side) {
+        int64_t ticks_away = 1;
+        while (rng.nextDouble() > 0.15 && ticks_away < 500) {
+            ++ticks_away;
+        }
+        double offset = ticks_away * TICK;
+        return std::round((side == OrderSide::BUY ? MID_PRICE - offset : MID_PRICE + offset) / TICK) * TICK;
+    }
+
+    double quantity() { return std::max(1.0, std::round(std::exp(rng.normal(std::log(100.0), 0.8)))); }
+};
+
+struct OrderSpec {
+    OrderSide side;
+    double price;
+    double quantity;
+};
+
+// Fills a fresh book with depth resting orders; returns their ids (and sides)
+std::vector<uint64_t> populate(OrderBook& book, OrderFlow& flow, size_t depth,
+                               std::vector<OrderSide>* sides = nullptr) {
+    std::vector<uint64_t> ids;
+    ids.reserve(depth);
+    if (sides) {
+        sides->clear();
+    }
+    for (size_t i = 0; i < depth; ++i) {
+        OrderSide side = flow.side();
+        ids.push_back(book.addOrder(side, OrderType::LIMIT, flow.price(side), flow.quantity()));
+        if (sides) {
+            sides->push_back(side);
+        }
+    }
+    return ids;
+}
+
+std::vector<std::pair<std::string, std::string>> depthParam(size_t depth) {
+    return {{"depth", std::to_string(depth)}};
+}
+
+void addOrderBookBenchmarks(BenchRunner& runner) {
+    // State shared between a benchmark's setup and run; rebuilt every repetition
+    // because fills and cancels change the book
+    struct State {
+        OrderFlow flow;
+        std::unique_ptr<OrderBook> book;
+        std::vector<uint64_t> ids;
+        std::vector<OrderSide> sides;
+        std::vector<OrderSpec> orders;
+        std::vector<double> sizes;
+    };
+    auto state = std::make_shared<State>();
+
+    for (size_t depth : {1000, 10000}) {
+        const size_t ops = 2000;
+
+        Benchmark add;
+        add.name = "orderbook/add";
+        add.params = depthParam(depth);
+        add.ops_per_rep = ops;
+        add.per_op = true;
+        add.setup = [state, depth, ops]() {
+            state->book = std::make_unique<OrderBook>("BENCH");
+            populate(*state->book, state->flow, depth);
+            state->orders.clear();
+            for (size_t i = 0; i < ops; ++i) {
+                OrderSide side = state->flow.side();
+                state->orders.push_back({side, state->flow.price(side), state->flow.quantity()});
+            }
+        };
+        add.run = [state](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const OrderSpec& o = state->orders[i];
+                doNotOptimize(state->book->addOrder(o.side, OrderType::LIMIT, o.price, o.quantity));
+            }
+        };
+        runner.add(add);
+
+        // Cancels hit random resting orders, not just the most recent ones
+        Benchmark cancel;
+        cancel.name = "orderbook/cancel";
+        cancel.params = depthParam(depth);
+        cancel.ops_per_rep = ops;
+        cancel.per_op = true;
+        cancel.setup = [state, depth, ops]() {
+            state->book = std::make_unique<OrderBook>("BENCH");
+            state->ids = populate(*state->book, state->flow, depth + ops);
+            for (size_t i = state->ids.size() - 1; i > 0; --i) {
+                size_t j = static_cast<size_t>(state->flow.rng.uniformInt(0, static_cast<int64_t>(i)));
+                std::swap(state->ids[i], state->ids[j]);
+            }
+        };
+        cancel.run = [state](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                doNotOptimize(state->book->cancelOrder(state->ids[i]));
+            }
+        };
+        runner.add(cancel);
+
+        // Amends re-price a random resting order to a fresh price on its side
+        Benchmark amend;
+        amend.name = "orderbook/amend";
+        amend.params = depthParam(depth);
+        amend.ops_per_rep = ops;
+        amend.per_op = true;
+        amend.setup = [state, depth, ops]() {
+            state->book = std::make_unique<OrderBook>("BENCH");
+            std::vector<uint64_t> resting = populate(*state->book, state->flow, depth, &state->sides);
+            state->ids.clear();
+            state->orders.clear();
+            for (size_t i = 0; i < ops; ++i) {
+                size_t k = static_cast<size_t>(state->flow.rng.uniformInt(0, static_cast<int64_t>(depth) - 1));
+                OrderSide side = state->sides[k];
+                state->ids.push_back(resting[k]);
+                state->orders.push_back({side, state->flow.price(side), state->flow.quantity()});
+            }
+        };
+        amend.run = [state](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const OrderSpec& o = state->orders[i];
+                doNotOptimize(state->book->modifyOrder(state->ids[i], o.price, o.quantity));
+            }
+        };
+        runner.add(amend);
+
+        // Marketable flow: exponential sizes (mean 300 shares) alternating sides
+        Benchmark sweep;
+        sweep.name = "orderbook/market_sweep";
+        sweep.params = depthParam(depth);
+        sweep.ops_per_rep = 500;
+        sweep.setup = [state, depth]() {
+            state->book = std::make_unique<OrderBook>("BENCH");
+            populate(*state->book, state->flow, depth);
+            state->sizes.resize(500);
+            state->flow.rng.fillExponential(state->sizes.data(), state->sizes.size(), 1.0 / 300.0);
+        };
+        sweep.run = [state](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                OrderSide side = (i & 1) ? OrderSide::SELL : OrderSide::BUY;
+                doNotOptimize(state->book->processMarketOrder(side, std::ceil(state->sizes[i])));
+            }
+        };
+        runner.add(sweep);
+
+        Benchmark top;
+        top.name = "orderbook/top_of_book";
+        top.params = depthParam(depth);
+        top.ops_per_rep = 10000;
+        // Queries don't change the book, so it is built once per depth
+        auto query_book = std::make_shared<std::unique_ptr<OrderBook>>();
+        top.setup = [state, query_book, depth]() {
+            if (!*query_book) {
+                *query_book = std::make_unique<OrderBook>("BENCH");
+                populate(**query_book, state->flow, depth);
+            }
+        };
+        top.run = [query_book](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                TopOfBook tob = (*query_book)->getTopOfBook();
+                doNotOptimize(tob);
+            }
+        };
+        runner.add(top);
+
+        Benchmark levels;
+        levels.name = "orderbook/depth";
+        levels.params = {{"depth", std::to_string(depth)}, {"levels", "10"}};
+        levels.ops_per_rep = 2000;
+        levels.setup = top.setup;
+        levels.run = [query_book](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                auto bids = (*query_book)->getTopBids(10);
+                auto asks = (*query_book)->getTopAsks(10);
+                doNotOptimize(bids.data());
+                doNotOptimize(asks.data());
+            }
+        };
+        runner.add(levels);
+    }
+}
+
+void addSimulationBenchmarks(BenchRunner& runner) {
+    Benchmark next_price;
+    next_price.name = "price/next_price";
+    next_price.ops_per_rep = 10000;
+    auto generator = std::make_shared<PriceGenerator>(MID_PRICE, 0.05, 0.2);
+    next_price.setup = [generator]() {
+        generator->reset(MID_PRICE);
+        generator->setSeed(WORKLOAD_SEED);
+    };
+    next_price.run = [generator](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            doNotOptimize(generator->generateNextPrice());
+        }
+    };
+    runner.add(next_price);
+
+    // One call for the whole repetition; ns/op is per generated price
+    Benchmark series;
+    series.name = "price/series";
+    series.params = {{"count", "10000"}};
+    series.ops_per_rep = 10000;
+    series.setup = next_price.setup;
+    series.run = [generator](size_t begin, size_t end) {
+        std::vector<double> prices = generator->generatePriceSeries(end - begin);
+        doNotOptimize(prices.data());
+    };
+    runner.add(series);
+
+    // A market maker quoting into a book that already has outside liquidity
+    struct MakerState {
+        std::shared_ptr<OrderBook> book;
+        std::shared_ptr<PriceGenerator> generator;
+        std::unique_ptr<MarketMaker> maker;
+    };
+    auto maker_state = std::make_shared<MakerState>();
+    Benchmark step;
+    step.name = "market_maker/step";
+    step.ops_per_rep = 1000;
+    step.setup = [maker_state]() {
+        OrderFlow flow;
+        maker_state->book = std::make_shared<OrderBook>("BENCH");
+        populate(*maker_state->book, flow, 1000);
+        maker_state->generator = std::make_shared<PriceGenerator>(MID_PRICE, 0.05, 0.2);
+        maker_state->generator->setSeed(WORKLOAD_SEED);
+        MarketMakerConfig config;
+        config.max_loss_limit = -1e12;
+        config.stop_loss_threshold = -1e12;
+        maker_state->maker = std::make_unique<MarketMaker>(maker_state->book, maker_state->generator, config);
+    };
+    step.run = [maker_state](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            maker_state->generator->generateNextPrice();
+            maker_state->maker->step();
+        }
+    };
+    runner.add(step);
+
+    // Fills alternate around a random-walk price so lots open and close
+    struct PnLState {
+        std::unique_ptr<PnLCalculator> calculator;
+        std::vector<double> prices;
+        std::vector<double> quantities;
+    };
+    auto pnl_state = std::make_shared<PnLState>();
+    auto pnl_setup = [pnl_state]() {
+        Xoshiro256pp rng(WORKLOAD_SEED);
+        pnl_state->calculator = std::make_unique<PnLCalculator>();
+        pnl_state->prices.resize(5000);
+        pnl_state->quantities.resize(5000);
+        double price = MID_PRICE;
+        for (size_t i = 0; i < pnl_state->prices.size(); ++i) {
+            price += rng.normal(0.0, 0.02);
+            pnl_state->prices[i] = std::round(price / TICK) * TICK;
+            pnl_state->quantities[i] = std::max(1.0, std::round(rng.exponential(1.0 / 100.0)));
+        }
+    };
+
+    Benchmark record;
+    record.name = "pnl/record_trade";
+    record.ops_per_rep = 5000;
+    record.setup = pnl_setup;
+    record.run = [pnl_state](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            pnl_state->calculator->recordTrade(pnl_state->prices[i], pnl_state->quantities[i], (i & 1) ? -1.0 : 1.0);
+        }
+    };
+    runner.add(record);
+
+    Benchmark mark;
+    mark.name = "pnl/mark_update";
+    mark.ops_per_rep = 5000;
+    mark.setup = [pnl_state, pnl_setup]() {
+        pnl_setup();
+        for (size_t i = 0; i < 200; ++i) {
+            pnl_state->calculator->recordTrade(pnl_state->prices[i], pnl_state->quantities[i], (i % 3) ? 1.0 : -1.0);
+        }
+    };
+    mark.run = [pnl_state](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            pnl_state->calculator->updateMarkPrice(pnl_state->prices[i]);
+        }
+    };
+    runner.add(mark);
+
+    // Book totals over 256 symbols and a growing number of accounts. The
+    // single pass and the worker pool reduce the same book; the pool only
+    // engages past 4096 slots per thread, so the smallest size measures
+    // both taking the single pass.
+    const size_t pool_threads = std::max(2u, std::thread::hardware_concurrency());
+    for (size_t accounts : {8, 256, 4096}) {
+        auto book = std::make_shared<std::unique_ptr<PortfolioPnL>>();
+        auto book_setup = [book, accounts]() {
+            if (*book) {
+                return;
+            }
+            Xoshiro256pp rng(WORKLOAD_SEED);
+            *book = std::make_unique<PortfolioPnL>(CostBasisMethod::AVERAGE_COST, 1);
+            std::vector<double> marks;
+            for (size_t s = 0; s < 256; ++s) {
+                (*book)->registerSymbol("SYM" + std::to_string(s));
+                marks.push_back(MID_PRICE + rng.normal(0.0, 5.0));
+            }
+            for (size_t a = 0; a < accounts; ++a) {
+                StrategyId account = (*book)->registerStrategy("ACCT" + std::to_string(a));
+                for (SymbolId s = 0; s < 256; ++s) {
+                    (*book)->applyFill(account, s, std::round(rng.normal(0.0, 100.0)), marks[s]);
+                }
+            }
+            (*book)->markToMarket(marks.data(), marks.size());
+        };
+        for (size_t threads : {size_t(1), pool_threads}) {
+            Benchmark totals;
+            totals.name = "portfolio/book_totals";
+            totals.params = {{"slots", std::to_string(accounts * 256)}, {"threads", std::to_string(threads)}};
+            totals.ops_per_rep = 1;
+            totals.setup = [book, book_setup, threads]() {
+                book_setup();
+                (*book)->setWorkerThreads(threads);
+            };
+            totals.run = [book](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    doNotOptimize((*book)->getBookTotals().total_pnl);
+                }
+            };
+            runner.add(totals);
+        }
+    }
+}
+
+void addUtilsBenchmarks(BenchRunner& runner) {
+    // Daily-like log returns shared by the numeric benchmarks
+    auto returns = std::make_shared<std::vector<double>>(20000);
+    auto other = std::make_shared<std::vector<double>>(20000);
+    auto output = std::make_shared<std::vector<double>>(20000);
+    {
+        Xoshiro256pp rng(WORKLOAD_SEED);
+        rng.fillNormal(returns->data(), returns->size(), 0.0003, 0.012);
+        rng.fillNormal(other->data(), other->size(), 0.0002, 0.015);
+    }
+
+    const size_t window = 252;
+    auto windowParams = std::vector<std::pair<std::string, std::string>>{
+        {"n", std::to_string(returns->size())}, {"window", std::to_string(window)}};
+
+    Benchmark mean;
+    mean.name = "sliding/rolling_mean";
+    mean.params = windowParams;
+    mean.ops_per_rep = 20;
+    mean.run = [returns, output, window](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            sliding::rollingMean(returns->data(), returns->size(), window, output->data());
+            doNotOptimize(output->front());
+        }
+    };
+    runner.add(mean);
+
+    Benchmark stddev;
+    stddev.name = "sliding/rolling_stddev";
+    stddev.params = windowParams;
+    stddev.ops_per_rep = 20;
+    stddev.run = [returns, output, window](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            sliding::rollingStddev(returns->data(), returns->size(), window, output->data());
+            doNotOptimize(output->front());
+        }
+    };
+    runner.add(stddev);
+
+    Benchmark minimum;
+    minimum.name = "sliding/rolling_min";
+    minimum.params = windowParams;
+    minimum.ops_per_rep = 20;
+    minimum.run = [returns, output, window](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            sliding::rollingMin(returns->data(), returns->size(), window, output->data());
+            doNotOptimize(output->front());
+        }
+    };
+    runner.add(minimum);
+
+    // Long series through the sliding-window kernels, at the scalar table
+    // and the best ISA. The 10M-sample inputs are generated on first use.
+    const size_t long_n = 10000000;
+    const size_t long_window = 100;
+    auto long_x = std::make_shared<std::vector<double>>();
+    auto long_y = std::make_shared<std::vector<double>>();
+    auto long_out = std::make_shared<std::vector<double>>();
+    auto prepare = [long_x, long_y, long_out, long_n]() {
+        if (long_x->empty()) {
+            Xoshiro256pp rng(WORKLOAD_SEED);
+            long_x->resize(long_n);
+            long_y->resize(long_n);
+            long_out->resize(long_n);
+            rng.fillNormal(long_x->data(), long_n, 0.0003, 0.012);
+            rng.fillNormal(long_y->data(), long_n, 0.0002, 0.015);
+        }
+    };
+    std::vector<kernels::Isa> long_isas = {kernels::Isa::SCALAR};
+    if (kernels::bestSupportedIsa() != kernels::Isa::SCALAR) {
+        long_isas.push_back(kernels::bestSupportedIsa());
+    }
+    for (kernels::Isa isa : long_isas) {
+        auto params = std::vector<std::pair<std::string, std::string>>{
+            {"isa", kernels::isaName(isa)}, {"n", std::to_string(long_n)}, {"window", std::to_string(long_window)}};
+        auto setup = [prepare, isa]() {
+            prepare();
+            kernels::setIsa(isa);
+        };
+        auto add = [&runner, &params, &setup](const std::string& name,
+                                              std::function<void(size_t, size_t)> run) {
+            Benchmark benchmark;
+            benchmark.name = name;
+            benchmark.params = params;
+            benchmark.ops_per_rep = 1;
+            benchmark.setup = setup;
+            benchmark.run = std::move(run);
+            runner.add(benchmark);
+        };
+
+        add("sliding/rolling_mean", [long_x, long_out, long_window](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                sliding::rollingMean(long_x->data(), long_x->size(), long_window, long_out->data());
+                doNotOptimize(long_out->front());
+            }
+        });
+        add("sliding/rolling_stddev", [long_x, long_out, long_window](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                sliding::rollingStddev(long_x->data(), long_x->size(), long_window, long_out->data());
+                doNotOptimize(long_out->front());
+            }
+        });
+        add("sliding/rolling_zscore", [long_x, long_out, long_window](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                sliding::rollingZScore(long_x->data(), long_x->size(), long_window, long_out->data());
+                doNotOptimize(long_out->front());
+            }
+        });
+        add("sliding/rolling_correlation", [long_x, long_y, long_out, long_window](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                sliding::rollingCorrelation(long_x->data(), long_y->data(), long_x->size(), long_window,
+                                            long_out->data());
+                doNotOptimize(long_out->front());
+            }
+        });
+        params.pop_back();
+        add("sliding/ema", [long_x, long_out](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                sliding::ema(long_x->data(), long_x->size(), 0.05, long_out->data());
+                doNotOptimize(long_out->front());
+            }
+        });
+    }
+
+    // Each kernel at every instruction set this CPU supports
+    const size_t n = 4096;
+    auto equity = std::make_shared<std::vector<double>>(n);
+    double level = 1e6;
+    for (size_t i = 0; i < n; ++i) {
+        level *= 1.0 + (*returns)[i];
+        (*equity)[i] = level;
+    }
+
+    for (kernels::Isa isa : {kernels::Isa::SCALAR, kernels::Isa::SSE4, kernels::Isa::AVX2, kernels::Isa::AVX512}) {
+        if (!kernels::isSupported(isa)) {
+            continue;
+        }
+        auto params = std::vector<std::pair<std::string, std::string>>{
+            {"isa", kernels::isaName(isa)}, {"n", std::to_string(n)}};
+        auto select = [isa]() { kernels::setIsa(isa); };
+
+        Benchmark sum;
+        sum.name = "kernels/sum";
+        sum.params = params;
+        sum.ops_per_rep = 2000;
+        sum.setup = select;
+        sum.run = [returns, n](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                doNotOptimize(kernels::sum(returns->data(), n));
+            }
+        };
+        runner.add(sum);
+
+        Benchmark variance;
+        variance.name = "kernels/variance";
+        variance.params = params;
+        variance.ops_per_rep = 2000;
+        variance.setup = select;
+        variance.run = [returns, n](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                doNotOptimize(kernels::variance(returns->data(), n, true));
+            }
+        };
+        runner.add(variance);
+
+        Benchmark drawdown;
+        drawdown.name = "kernels/max_drawdown";
+        drawdown.params = params;
+        drawdown.ops_per_rep = 2000;
+        drawdown.setup = select;
+        drawdown.run = [equity, n](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                doNotOptimize(kernels::maxDrawdown(equity->data(), n));
+            }
+        };
+        runner.add(drawdown);
+
+        Benchmark cross;
+        cross.name = "kernels/cross_moments";
+        cross.params = params;
+        cross.ops_per_rep = 2000;
+        cross.setup = select;
+        cross.run = [returns, other, n](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                kernels::CrossMoments m = kernels::crossMoments(returns->data(), other->data(), n, 0.0003, 0.0002);
+                doNotOptimize(m);
+            }
+        };
+        runner.add(cross);
+    }
+
+    // Event timestamps ~100us apart, as written by the CSV exports
+    Benchmark timestamp;
+    timestamp.name = "utils/format_timestamp";
+    timestamp.params = {{"precision", "micros"}};
+    timestamp.ops_per_rep = 20000;
+    timestamp.setup = []() { kernels::setIsa(kernels::bestSupportedIsa()); };
+    timestamp.run = [](size_t begin, size_t end) {
+        int64_t base = 1700000000LL * 1000000000LL;
+        char text[TimestampFormatter::MAX_LENGTH];
+        for (size_t i = begin; i < end; ++i) {
+            char* stop = TimestampFormatter::format(text, base + static_cast<int64_t>(i) * 100000);
+            doNotOptimize(stop);
+        }
+    };
+    runner.add(timestamp);
+
+    // A trade export row: split it and parse the numeric fields
+    Benchmark tokenize;
+    tokenize.name = "utils/tokenize_parse";
+    tokenize.ops_per_rep = 20000;
+    tokenize.run = [](size_t begin, size_t end) {
+        static const std::string row = "2024-03-01 14:30:05.123456,AAPL,BUY,150.25,200,30050.00,-12.75,1";
+        std::vector<std::string_view> fields;
+        for (size_t i = begin; i < end; ++i) {
+            utils::splitInto(row, ',', fields);
+            double price = 0.0;
+            double quantity = 0.0;
+            utils::parseDouble(fields[3], price);
+            utils::parseDouble(fields[4], quantity);
+            doNotOptimize(price * quantity);
+        }
+    };
+    runner.add(tokenize);
+
+    Benchmark normals;
+    normals.name = "rng/fill_normal";
+    normals.params = {{"n", "1024"}};
+    normals.ops_per_rep = 1024 * 200;
+    auto generator = std::make_shared<Xoshiro256pp>(WORKLOAD_SEED);
+    auto draws = std::make_shared<std::vector<double>>(1024);
+    normals.run = [generator, draws](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i += draws->size()) {
+            generator->fillNormal(draws->data(), std::min(draws->size(), end - i));
+            doNotOptimize(draws->front());
+        }
+    };
+    runner.add(normals);
+
+    // Timestamp reads: the hot-path Clock against the std clocks it replaced
+    Benchmark system_now;
+    system_now.name = "clock/system_clock_now";
+    system_now.ops_per_rep = 20000;
+    system_now.run = [](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            auto now = std::chrono::system_clock::now();
+            doNotOptimize(now);
+        }
+    };
+    runner.add(system_now);
+
+    Benchmark steady_now;
+    steady_now.name = "clock/steady_clock_now";
+    steady_now.ops_per_rep = 20000;
+    steady_now.run = [](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            auto now = std::chrono::steady_clock::now();
+            doNotOptimize(now);
+        }
+    };
+    runner.add(steady_now);
+
+    Benchmark clock_now;
+    clock_now.name = "clock/now";
+    clock_now.params = {{"source", Clock::source()}};
+    clock_now.ops_per_rep = 20000;
+    clock_now.run = [](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            uint64_t now = Clock::now();
+            doNotOptimize(now);
+        }
+    };
+    runner.add(clock_now);
+
+    Benchmark clock_precise;
+    clock_precise.name = "clock/now_precise";
+    clock_precise.params = {{"source", Clock::source()}};
+    clock_precise.ops_per_rep = 20000;
+    clock_precise.run = [](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            uint64_t now = Clock::nowPrecise();
+            doNotOptimize(now);
+        }
+    };
+    runner.add(clock_precise);
+
+    Benchmark wall_now;
+    wall_now.name = "clock/wall_now";
+    wall_now.params = {{"source", Clock::source()}};
+    wall_now.ops_per_rep = 20000;
+    wall_now.run = [](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            auto now = Clock::wallNow();
+            doNotOptimize(now);
+        }
+    };
+    runner.add(wall_now);
+}
+
+std::string currentTime() {
+    std::time_t now = std::time(nullptr);
+    std::tm utc{};
+    gmtime_r(&now, &utc);
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    return text;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!BenchRunner::parseArgs(argc, argv, options)) {
+        return 2;
+    }
+
+    rng::setMasterSeed(WORKLOAD_SEED);
+
+    BenchRunner runner(options);
+    addOrderBookBenchmarks(runner);
+    addSimulationBenchmarks(runner);
+    addUtilsBenchmarks(runner);
+
+    std::vector<BenchResult> results = runner.runAll();
+    kernels::setIsa(kernels::bestSupportedIsa());
+
+    if (!options.json_path.empty() && !options.list_only) {
+        std::vector<std::pair<std::string, std::string>> context = {
+            {"date", currentTime()},
+#if defined(__VERSION__)
+            {"compiler", __VERSION__},
+#endif
+#ifdef NDEBUG
+            {"assertions", "off"},
+#else
+            {"assertions", "on"},
+#endif
+            {"best_isa", kernels::isaName(kernels::bestSupportedIsa())},
+            {"clock", Clock::source()},
+        };
+        if (!runner.writeJson(options.json_path, results, context)) {
+            return 1;
+        }
+        std::cout << "Results written to " << options.json_path << "\n";
+    }
+    return 0;
+}
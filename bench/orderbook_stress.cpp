@@ -0,0 +1,438 @@
+// Concurrent OrderBook stress and scaling benchmark.
+//
+// Writer threads drive a mix of add/cancel/amend/market-sweep operations and
+// reader threads a mix of queries (including the status dump the engine's
+// printer polls) against one shared book for a fixed duration. Every
+// operation is timed individually, and the run is repeated at 1..N threads
+// to produce scaling curves of throughput and latency percentiles per
+// operation type. The same output can be produced for any future book
+// implementation and compared point by point.
+
+#include "BenchHarness.h"
+#include "OrderBook.h"
+#include "Random.h"
+#include "Tokenizer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hft;
+using namespace hft::bench;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint64_t WORKLOAD_SEED = 0x5eed2024;
+constexpr double MID_PRICE = 100.0;
+constexpr double TICK = 0.01;
+
+enum OpType { ADD, CANCEL, AMEND, SWEEP, TOP, DEPTH, DUMP, MID, OP_COUNT };
+
+const char* const OP_NAMES[OP_COUNT] = {"add", "cancel", "amend", "sweep", "top", "depth", "dump", "mid"};
+
+struct StressOptions {
+    size_t max_writers = 4;
+    size_t max_readers = 4;
+    size_t duration_ms = 500;   // Per measured point
+    size_t depth = 5000;        // Resting orders at the start of each point
+    std::string curve = "all";  // writers, readers, mixed or all
+    std::string writer_mix = "add:45,cancel:35,amend:15,sweep:5";
+    std::string reader_mix = "top:70,depth:25,dump:5";
+    std::string json_path;
+};
+
+// Cumulative weights over OpType, parsed from "name:weight,..." where every
+// name must be in [first, last]
+struct OpMix {
+    double cumulative[OP_COUNT] = {};
+
+    bool parse(const std::string& text, OpType first, OpType last) {
+        std::vector<std::string_view> entries;
+        utils::splitInto(text, ',', entries);
+        double weights[OP_COUNT] = {};
+        for (std::string_view entry : entries) {
+            size_t colon = entry.find(':');
+            if (colon == std::string_view::npos) {
+                return false;
+            }
+            std::string_view name = utils::trimView(entry.substr(0, colon));
+            double weight = 0.0;
+            if (!utils::parseDouble(entry.substr(colon + 1), weight) || weight < 0.0) {
+                return false;
+            }
+            size_t op = 0;
+            while (op < OP_COUNT && name != OP_NAMES[op]) {
+                ++op;
+            }
+            if (op < static_cast<size_t>(first) || op > static_cast<size_t>(last)) {
+                return false;
+            }
+            weights[op] += weight;
+        }
+        double total = 0.0;
+        for (size_t op = 0; op < OP_COUNT; ++op) {
+            total += weights[op];
+            cumulative[op] = total;
+        }
+        if (total <= 0.0) {
+            return false;
+        }
+        for (double& c : cumulative) {
+            c /= total;
+        }
+        return true;
+    }
+
+    OpType pick(double u) const {
+        size_t op = 0;
+        while (op + 1 < OP_COUNT && u >= cumulative[op]) {
+            ++op;
+        }
+        return static_cast<OpType>(op);
+    }
+};
+
+// Same flow shape as the single-threaded suite: geometric distance from the
+// touch, lognormal sizes
+double flowPrice(Xoshiro256pp& rng, OrderSide side) {
+    int64_t ticks_away = 1;
+    while (rng.nextDouble() > 0.15 && ticks_away < 500) {
+        ++ticks_away;
+    }
+    double offset = ticks_away * TICK;
+    return std::round((side == OrderSide::BUY ? MID_PRICE - offset : MID_PRICE + offset) / TICK) * TICK;
+}
+
+double flowQuantity(Xoshiro256pp& rng) {
+    return std::max(1.0, std::round(std::exp(rng.normal(std::log(100.0), 0.8))));
+}
+
+struct OwnedOrder {
+    uint64_t id;
+    OrderSide side;
+};
+
+struct ThreadResult {
+    std::vector<double> latency_ns[OP_COUNT];
+};
+
+struct OpSummary {
+    size_t count = 0;
+    double ops_per_sec = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double p999 = 0.0;
+    double max = 0.0;
+};
+
+struct PointResult {
+    std::string curve;
+    size_t writers = 0;
+    size_t readers = 0;
+    double elapsed_s = 0.0;
+    double total_ops_per_sec = 0.0;
+    OpSummary ops[OP_COUNT];
+};
+
+class StressRun {
+private:
+    const StressOptions& options;
+    const OpMix& writer_mix;
+    const OpMix& reader_mix;
+    OrderBook book{"STRESS"};
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> ready{0};
+
+    void writerLoop(Xoshiro256pp rng, std::vector<OwnedOrder> owned, size_t target_owned, ThreadResult& out) {
+        ready.fetch_add(1);
+        while (!start.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        while (!stop.load(std::memory_order_relaxed)) {
+            OpType op = writer_mix.pick(rng.nextDouble());
+            // Keep this writer's share of the book near its starting depth
+            if (op == ADD && owned.size() > target_owned + target_owned / 4) {
+                op = CANCEL;
+            } else if ((op == CANCEL || op == AMEND) && owned.empty()) {
+                op = ADD;
+            }
+
+            size_t pick = owned.empty() ? 0
+                : static_cast<size_t>(rng.uniformInt(0, static_cast<int64_t>(owned.size()) - 1));
+            // Amends re-price on the order's own side so the book never crosses
+            OrderSide side = (op == AMEND) ? owned[pick].side : ((rng() & 1) ? OrderSide::BUY : OrderSide::SELL);
+            double price = flowPrice(rng, side);
+            double quantity = flowQuantity(rng);
+
+            auto begin = Clock::now();
+            switch (op) {
+                case ADD:
+                    owned.push_back({book.addOrder(side, OrderType::LIMIT, price, quantity), side});
+                    break;
+                case CANCEL:
+                    doNotOptimize(book.cancelOrder(owned[pick].id));
+                    break;
+                case AMEND:
+                    // Orders swept by another writer just fail to amend
+                    doNotOptimize(book.modifyOrder(owned[pick].id, price, quantity));
+                    break;
+                default:
+                    doNotOptimize(book.processMarketOrder(side, std::ceil(rng.exponential(1.0 / 300.0))));
+                    break;
+            }
+            auto end = Clock::now();
+            out.latency_ns[op].push_back(static_cast<double>((end - begin).count()));
+
+            if (op == CANCEL) {
+                owned[pick] = owned.back();
+                owned.pop_back();
+            }
+        }
+    }
+
+    void readerLoop(Xoshiro256pp rng, ThreadResult& out) {
+        ready.fetch_add(1);
+        while (!start.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        while (!stop.load(std::memory_order_relaxed)) {
+            OpType op = reader_mix.pick(rng.nextDouble());
+            auto begin = Clock::now();
+            switch (op) {
+                case DEPTH: {
+                    auto bids = book.getTopBids(10);
+                    auto asks = book.getTopAsks(10);
+                    doNotOptimize(bids.data());
+                    doNotOptimize(asks.data());
+                    break;
+                }
+                case DUMP: {
+                    std::string text = book.getOrderBookString(10);
+                    doNotOptimize(text.data());
+                    break;
+                }
+                case MID:
+                    doNotOptimize(book.getMidPrice());
+                    break;
+                default: {
+                    TopOfBook top = book.getTopOfBook();
+                    doNotOptimize(top);
+                    op = TOP;
+                    break;
+                }
+            }
+            auto end = Clock::now();
+            out.latency_ns[op].push_back(static_cast<double>((end - begin).count()));
+        }
+    }
+
+public:
+    StressRun(const StressOptions& opts, const OpMix& writers, const OpMix& readers)
+        : options(opts), writer_mix(writers), reader_mix(readers) {}
+
+    PointResult run(const std::string& curve, size_t writers, size_t readers) {
+        Xoshiro256pp master(WORKLOAD_SEED);
+
+        // Seed the book; resting orders are split between the writers to cancel and amend
+        std::vector<std::vector<OwnedOrder>> owned(std::max<size_t>(writers, 1));
+        for (size_t i = 0; i < options.depth; ++i) {
+            OrderSide side = (master() & 1) ? OrderSide::BUY : OrderSide::SELL;
+            uint64_t id = book.addOrder(side, OrderType::LIMIT, flowPrice(master, side), flowQuantity(master));
+            owned[i % owned.size()].push_back({id, side});
+        }
+
+        std::vector<ThreadResult> results(writers + readers);
+        std::vector<std::thread> threads;
+        for (size_t w = 0; w < writers; ++w) {
+            master.jump();
+            threads.emplace_back(&StressRun::writerLoop, this, master, std::move(owned[w]),
+                                 options.depth / writers, std::ref(results[w]));
+        }
+        for (size_t r = 0; r < readers; ++r) {
+            master.jump();
+            threads.emplace_back(&StressRun::readerLoop, this, master, std::ref(results[writers + r]));
+        }
+
+        while (ready.load() < threads.size()) {
+            std::this_thread::yield();
+        }
+        auto begin = Clock::now();
+        start.store(true, std::memory_order_release);
+        std::this_thread::sleep_for(std::chrono::milliseconds(options.duration_ms));
+        stop.store(true, std::memory_order_relaxed);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        double elapsed_s = std::chrono::duration<double>(Clock::now() - begin).count();
+
+        PointResult point;
+        point.curve = curve;
+        point.writers = writers;
+        point.readers = readers;
+        point.elapsed_s = elapsed_s;
+        size_t total = 0;
+        for (size_t op = 0; op < OP_COUNT; ++op) {
+            std::vector<double> samples;
+            for (const ThreadResult& result : results) {
+                samples.insert(samples.end(), result.latency_ns[op].begin(), result.latency_ns[op].end());
+            }
+            std::sort(samples.begin(), samples.end());
+            OpSummary& summary = point.ops[op];
+            summary.count = samples.size();
+            if (samples.empty()) {
+                continue;
+            }
+            summary.ops_per_sec = samples.size() / elapsed_s;
+            summary.p50 = percentile(samples, 50.0);
+            summary.p90 = percentile(samples, 90.0);
+            summary.p99 = percentile(samples, 99.0);
+            summary.p999 = percentile(samples, 99.9);
+            summary.max = samples.back();
+            total += samples.size();
+        }
+        point.total_ops_per_sec = total / elapsed_s;
+        return point;
+    }
+};
+
+void printPoint(const PointResult& point) {
+    std::printf("%-8s w=%-2zu r=%-2zu total %11.0f ops/s\n", point.curve.c_str(), point.writers, point.readers,
+                point.total_ops_per_sec);
+    for (size_t op = 0; op < OP_COUNT; ++op) {
+        const OpSummary& s = point.ops[op];
+        if (s.count == 0) {
+            continue;
+        }
+        std::printf("    %-7s %11.0f ops/s   p50 %9.0f  p90 %9.0f  p99 %9.0f  p99.9 %9.0f  max %10.0f ns\n",
+                    OP_NAMES[op], s.ops_per_sec, s.p50, s.p90, s.p99, s.p999, s.max);
+    }
+    std::fflush(stdout);
+}
+
+bool writeJson(const std::string& path, const StressOptions& options, const std::vector<PointResult>& points) {
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) {
+        std::cerr << "Could not write " << path << "\n";
+        return false;
+    }
+    std::fprintf(f, "{\n  \"schema\": 1,\n  \"unit\": \"ns\",\n  \"duration_ms\": %zu,\n  \"depth\": %zu,\n",
+                 options.duration_ms, options.depth);
+    std::fprintf(f, "  \"hardware_threads\": %u,\n", std::thread::hardware_concurrency());
+    std::fprintf(f, "  \"writer_mix\": \"%s\",\n  \"reader_mix\": \"%s\",\n  \"points\": [",
+                 options.writer_mix.c_str(), options.reader_mix.c_str());
+    for (size_t i = 0; i < points.size(); ++i) {
+        const PointResult& p = points[i];
+        std::fprintf(f, "%s\n    {\"curve\": \"%s\", \"writers\": %zu, \"readers\": %zu, \"elapsed_s\": %.4f, "
+                        "\"total_ops_per_sec\": %.1f, \"ops\": {",
+                     i > 0 ? "," : "", p.curve.c_str(), p.writers, p.readers, p.elapsed_s, p.total_ops_per_sec);
+        bool first = true;
+        for (size_t op = 0; op < OP_COUNT; ++op) {
+            const OpSummary& s = p.ops[op];
+            if (s.count == 0) {
+                continue;
+            }
+            std::fprintf(f, "%s\n      \"%s\": {\"count\": %zu, \"ops_per_sec\": %.1f, \"p50\": %.0f, \"p90\": %.0f, "
+                            "\"p99\": %.0f, \"p999\": %.0f, \"max\": %.0f}",
+                         first ? "" : ",", OP_NAMES[op], s.count, s.ops_per_sec, s.p50, s.p90, s.p99, s.p999, s.max);
+            first = false;
+        }
+        std::fprintf(f, "}}");
+    }
+    std::fprintf(f, "\n  ]\n}\n");
+    std::fclose(f);
+    return true;
+}
+
+bool parseArgs(int argc, char* argv[], StressOptions& out) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        uint64_t number = 0;
+        if (arg == "--writers" && has_value && utils::parseUInt64(argv[i + 1], number) && number > 0) {
+            out.max_writers = number;
+        } else if (arg == "--readers" && has_value && utils::parseUInt64(argv[i + 1], number)) {
+            out.max_readers = number;
+        } else if (arg == "--duration-ms" && has_value && utils::parseUInt64(argv[i + 1], number) && number > 0) {
+            out.duration_ms = number;
+        } else if (arg == "--depth" && has_value && utils::parseUInt64(argv[i + 1], number)) {
+            out.depth = number;
+        } else if (arg == "--curve" && has_value) {
+            out.curve = argv[i + 1];
+        } else if (arg == "--writer-mix" && has_value) {
+            out.writer_mix = argv[i + 1];
+        } else if (arg == "--reader-mix" && has_value) {
+            out.reader_mix = argv[i + 1];
+        } else if (arg == "--json" && has_value) {
+            out.json_path = argv[i + 1];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--writers N] [--readers N] [--duration-ms N] [--depth N]\n"
+                      << "       [--curve writers|readers|mixed|all] [--writer-mix add:45,cancel:35,amend:15,sweep:5]\n"
+                      << "       [--reader-mix top:70,depth:25,dump:5,mid:0] [--json FILE]\n";
+            return false;
+        }
+        ++i;
+    }
+    if (out.curve != "writers" && out.curve != "readers" && out.curve != "mixed" && out.curve != "all") {
+        std::cerr << "Unknown curve: " << out.curve << "\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    StressOptions options;
+    OpMix writer_mix;
+    OpMix reader_mix;
+    if (!parseArgs(argc, argv, options)) {
+        return 2;
+    }
+    if (!writer_mix.parse(options.writer_mix, ADD, SWEEP) || !reader_mix.parse(options.reader_mix, TOP, MID)) {
+        std::cerr << "Invalid operation mix\n";
+        return 2;
+    }
+
+    // Each point runs on a fresh book: (curve, writers, readers)
+    std::vector<std::pair<std::string, std::pair<size_t, size_t>>> plan;
+    bool all = options.curve == "all";
+    if (all || options.curve == "writers") {
+        for (size_t w = 1; w <= options.max_writers; ++w) plan.push_back({"writers", {w, 0}});
+    }
+    if (all || options.curve == "readers") {
+        // One writer (the engine) plus a growing number of pollers
+        for (size_t r = 1; r <= options.max_readers; ++r) plan.push_back({"readers", {1, r}});
+    }
+    if (all || options.curve == "mixed") {
+        for (size_t t = 1; t <= std::min(options.max_writers, options.max_readers); ++t) {
+            plan.push_back({"mixed", {t, t}});
+        }
+    }
+
+    std::printf("OrderBook stress: depth %zu, %zu ms per point, %u hardware threads\n", options.depth,
+                options.duration_ms, std::thread::hardware_concurrency());
+    std::vector<PointResult> points;
+    for (const auto& [curve, threads] : plan) {
+        StressRun run(options, writer_mix, reader_mix);
+        points.push_back(run.run(curve, threads.first, threads.second));
+        printPoint(points.back());
+    }
+
+    if (!options.json_path.empty()) {
+        if (!writeJson(options.json_path, options, points)) {
+            return 1;
+        }
+        std::cout << "Results written to " << options.json_path << "\n";
+    }
+    return 0;
+}
@@ -2,28 +2,94 @@
 
 echo "Building High-Frequency Market Making Simulator..."
 
-# Create bin directory if it doesn't exist
-mkdir -p bin
+# Create output directories if they don't exist
+mkdir -p bin build/obj
 
-# Compile flags
+# Compile flags (HFT_LTO=1 ./build.sh for a link-time optimized build,
+# HFT_LOCK_PROFILING=1 ./build.sh for lock contention statistics,
+# HFT_LOCK_CHECKS=1 ./build.sh to abort on re-entrant locking)
 CXXFLAGS="-std=c++17 -O3 -Wall -Wextra -pthread"
 INCLUDES="-Iinclude -Isrc"
+AR="ar"
+if [ "$HFT_LTO" = "1" ]; then
+    CXXFLAGS="$CXXFLAGS -flto=auto"
+    AR="gcc-ar"
+    echo "Link-time optimization enabled"
+fi
+if [ "$HFT_LOCK_PROFILING" = "1" ]; then
+    CXXFLAGS="$CXXFLAGS -DHFT_LOCK_PROFILING"
+    echo "Lock profiling enabled"
+fi
+if [ "$HFT_LOCK_CHECKS" = "1" ]; then
+    CXXFLAGS="$CXXFLAGS -DHFT_LOCK_CHECKS"
+    echo "Lock checks enabled"
+fi
 
-# Source files
-SOURCES=(
+# Engine components, built once into build/libhft_core.a
+CORE_SOURCES=(
     "src/Order.cpp"
     "src/OrderBook.cpp"
     "src/PriceGenerator.cpp"
     "src/PnLCalculator.cpp"
+    "src/LotEngine.cpp"
+    "src/PnLHistory.cpp"
+    "src/HistorySpill.cpp"
+    "src/CsvWriter.cpp"
+    "src/TimestampFormatter.cpp"
+    "src/ColumnarFile.cpp"
+    "src/EventLog.cpp"
+    "src/WorkerPool.cpp"
+    "src/PortfolioPnL.cpp"
+    "src/SlidingStats.cpp"
+    "src/NumericKernels.cpp"
+    "src/Random.cpp"
+    "src/Tokenizer.cpp"
     "src/MarketMaker.cpp"
     "src/SimulationEngine.cpp"
+    "src/AllocTracker.cpp"
+    "src/LatencyHistogram.cpp"
+    "src/ProfiledMutex.cpp"
+    "src/Trace.cpp"
+    "src/Clock.cpp"
     "src/utils.cpp"
-    "src/main.cpp"
 )
+CORE_LIB="build/libhft_core.a"
+
+# Build core library (sources compile in parallel)
+echo "Building hft_core library..."
+OBJECTS=()
+PIDS=()
+for source in "${CORE_SOURCES[@]}"; do
+    object="build/obj/$(basename "${source%.cpp}").o"
+    OBJECTS+=("$object")
+    FLAGS="$CXXFLAGS"
+    # Dispatch-table kernels gain nothing from LTO (see CMakeLists.txt)
+    if [ "$source" = "src/NumericKernels.cpp" ]; then
+        FLAGS="$FLAGS -fno-lto"
+    fi
+    g++ $FLAGS $INCLUDES -c "$source" -o "$object" &
+    PIDS+=($!)
+done
+
+CORE_OK=1
+for pid in "${PIDS[@]}"; do
+    wait "$pid" || CORE_OK=0
+done
+
+if [ $CORE_OK -eq 1 ] && rm -f "$CORE_LIB" && $AR rcs "$CORE_LIB" "${OBJECTS[@]}"; then
+    echo "✅ hft_core built successfully!"
+else
+    echo "❌ hft_core build failed!"
+    exit 1
+fi
+
+# Allocation-counting operator new/delete, for tests and benchmarks only
+g++ $CXXFLAGS $INCLUDES -c src/AllocInterposer.cpp -o build/obj/AllocInterposer.o || exit 1
+ALLOC_INTERPOSER="build/obj/AllocInterposer.o"
 
 # Build main executable
 echo "Building main executable..."
-g++ $CXXFLAGS $INCLUDES -o bin/HighFrequencyMarketMaker "${SOURCES[@]}"
+g++ $CXXFLAGS $INCLUDES -o bin/HighFrequencyMarketMaker src/main.cpp "$CORE_LIB"
 
 if [ $? -eq 0 ]; then
     echo "✅ Main executable built successfully!"
@@ -33,9 +99,9 @@ else
     exit 1
 fi
 
-# Build test executable
+# Build test executable (asserts stay enabled)
 echo "Building test executable..."
-g++ $CXXFLAGS $INCLUDES -o bin/test_basic src/test_basic.cpp src/Order.cpp src/OrderBook.cpp src/PriceGenerator.cpp src/PnLCalculator.cpp src/MarketMaker.cpp src/SimulationEngine.cpp src/utils.cpp
+g++ $CXXFLAGS -UNDEBUG $INCLUDES -o bin/test_basic src/test_basic.cpp "$ALLOC_INTERPOSER" "$CORE_LIB"
 
 if [ $? -eq 0 ]; then
     echo "✅ Test executable built successfully!"
@@ -44,7 +110,35 @@ else
     echo "❌ Test build failed!"
 fi
 
+# Build live event log follower
+echo "Building event_tail tool..."
+g++ $CXXFLAGS $INCLUDES -o bin/event_tail tools/event_tail.cpp "$CORE_LIB"
+
+if [ $? -eq 0 ]; then
+    echo "✅ event_tail built successfully!"
+    echo "Location: bin/event_tail"
+else
+    echo "❌ event_tail build failed!"
+fi
+
+# Build microbenchmark suite and order book stress run
+echo "Building hft_bench and orderbook_stress..."
+g++ $CXXFLAGS $INCLUDES -Ibench -c bench/BenchHarness.cpp -o build/obj/BenchHarness.o &&
+g++ $CXXFLAGS $INCLUDES -Ibench -c bench/PerfCounters.cpp -o build/obj/PerfCounters.o &&
+g++ $CXXFLAGS $INCLUDES -Ibench -o bin/hft_bench bench/bench_main.cpp build/obj/BenchHarness.o build/obj/PerfCounters.o "$ALLOC_INTERPOSER" "$CORE_LIB" &&
+g++ $CXXFLAGS $INCLUDES -Ibench -o bin/orderbook_stress bench/orderbook_stress.cpp build/obj/BenchHarness.o build/obj/PerfCounters.o "$ALLOC_INTERPOSER" "$CORE_LIB"
+
+if [ $? -eq 0 ]; then
+    echo "✅ hft_bench and orderbook_stress built successfully!"
+    echo "Location: bin/hft_bench, bin/orderbook_stress"
+else
+    echo "❌ Benchmark build failed!"
+fi
+
 echo ""
 echo "🎉 Build complete! You can now run:"
 echo "  ./bin/HighFrequencyMarketMaker    # Main simulation"
 echo "  ./bin/test_basic                  # Run tests"
+echo "  ./bin/event_tail data/events.hftlog  # Follow a running simulation"
+echo "  ./bin/hft_bench --json bench.json  # Microbenchmarks"
+echo "  ./bin/orderbook_stress --writers 4 --readers 4  # Concurrent book scaling"
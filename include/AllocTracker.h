@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace hft {
+
+// Heap allocations made by the calling thread since it started
+struct AllocStats {
+    uint64_t allocations;
+    uint64_t deallocations;
+    uint64_t bytes_allocated;
+};
+
+// Per-thread allocation accounting.
+//
+// The counters are fed by the global operator new/delete replacements in
+// src/AllocInterposer.cpp, which only test_basic and the benchmarks link
+// (the hft_alloc_interposer object library). Without the interposer every
+// count stays zero and isInstalled() is false, so production binaries pay
+// nothing. Counting is thread-local and lock-free.
+class AllocTracker {
+public:
+    static bool isInstalled();
+    static AllocStats threadStats();
+
+    // NoAllocRegion failures, process-wide
+    static uint64_t getViolationCount();
+    static const char* getLastViolation();  // Region name, nullptr if none
+
+    // Hooks for the interposer
+    static void noteAllocation(size_t bytes);
+    static void noteDeallocation();
+    static void markInstalled();
+    static void noteViolation(const char* region);
+};
+
+// Counts what the calling thread allocates while the scope is alive
+class AllocScope {
+private:
+    AllocStats start;
+
+public:
+    AllocScope() : start(AllocTracker::threadStats()) {}
+
+    uint64_t allocations() const { return AllocTracker::threadStats().allocations - start.allocations; }
+    uint64_t deallocations() const { return AllocTracker::threadStats().deallocations - start.deallocations; }
+    uint64_t bytes() const { return AllocTracker::threadStats().bytes_allocated - start.bytes_allocated; }
+    void reset() { start = AllocTracker::threadStats(); }
+};
+
+// A region declared allocation-free: any allocation by the calling thread
+// before the region ends is recorded as a violation under its name
+class NoAllocRegion {
+private:
+    const char* name;
+    AllocScope scope;
+
+public:
+    explicit NoAllocRegion(const char* region_name) : name(region_name) {}
+    ~NoAllocRegion() {
+        if (scope.allocations() > 0) {
+            AllocTracker::noteViolation(name);
+        }
+    }
+
+    NoAllocRegion(const NoAllocRegion&) = delete;
+    NoAllocRegion& operator=(const NoAllocRegion&) = delete;
+
+    bool ok() const { return scope.allocations() == 0; }
+    uint64_t allocations() const { return scope.allocations(); }
+};
+
+} // namespace hft
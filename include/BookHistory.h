@@ -0,0 +1,66 @@
+#pragma once
+
+#include "ColumnarRing.h"
+#include "OrderBook.h"
+#include <chrono>
+#include <vector>
+#include <cstdint>
+
+namespace hft {
+
+// Columnar top-of-book history, one row per sampled tick
+class BookHistory : public ColumnarRing<BookHistory> {
+    friend class ColumnarRing<BookHistory>;
+
+private:
+    std::vector<int64_t> timestamp_ns;  // Nanoseconds since the system_clock epoch
+    std::vector<double> best_bid;
+    std::vector<double> best_ask;
+    std::vector<double> bid_size;
+    std::vector<double> ask_size;
+    std::vector<uint64_t> bid_levels;
+    std::vector<uint64_t> ask_levels;
+    std::vector<double> mark_price;
+
+    template<typename Func>
+    void forEachColumn(Func&& func) {
+        func(timestamp_ns);
+        func(best_bid);
+        func(best_ask);
+        func(bid_size);
+        func(ask_size);
+        func(bid_levels);
+        func(ask_levels);
+        func(mark_price);
+    }
+
+public:
+    explicit BookHistory(size_t capacity) : ColumnarRing<BookHistory>(capacity) {
+        initColumns();
+    }
+
+    void push(std::chrono::system_clock::time_point timestamp, const TopOfBook& top, double mark) {
+        size_t s = appendSlot();
+        timestamp_ns[s] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            timestamp.time_since_epoch()).count();
+        best_bid[s] = top.best_bid;
+        best_ask[s] = top.best_ask;
+        bid_size[s] = top.bid_size;
+        ask_size[s] = top.ask_size;
+        bid_levels[s] = top.bid_levels;
+        ask_levels[s] = top.ask_levels;
+        mark_price[s] = mark;
+    }
+
+    // Column views, oldest first
+    RingView<int64_t> timestamps() const { return columnView(timestamp_ns); }
+    RingView<double> bestBids() const { return columnView(best_bid); }
+    RingView<double> bestAsks() const { return columnView(best_ask); }
+    RingView<double> bidSizes() const { return columnView(bid_size); }
+    RingView<double> askSizes() const { return columnView(ask_size); }
+    RingView<uint64_t> bidLevels() const { return columnView(bid_levels); }
+    RingView<uint64_t> askLevels() const { return columnView(ask_levels); }
+    RingView<double> markPrices() const { return columnView(mark_price); }
+};
+
+} // namespace hft
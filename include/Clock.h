@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <x86intrin.h>
+#define HFT_CLOCK_HAS_TSC 1
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define HFT_CLOCK_HAS_TSC 1
+#else
+#define HFT_CLOCK_HAS_TSC 0
+#endif
+
+#ifdef __linux__
+#include <time.h>
+#endif
+
+namespace hft {
+
+// Hot-path clock.
+//
+// Timestamps are opaque ticks: invariant TSC cycles when the CPU has an
+// invariant TSC (calibrated against CLOCK_MONOTONIC once, ~20ms, on first
+// use; call calibration() on a cold path to pay that up front), otherwise
+// CLOCK_MONOTONIC nanoseconds. Store ticks and convert with
+// toNanos() for durations or toWallNs()/toWallTime() for display and export.
+//
+// now() is the cheap read for event timestamps: rdtsc, or the coarse
+// monotonic clock (jiffy resolution, no syscall) in the fallback.
+// nowPrecise() is for short intervals (latency histograms, traces) and uses
+// the full-resolution monotonic clock in the fallback; both share one tick
+// domain. HFT_CLOCK=monotonic in the environment forces the fallback.
+class Clock {
+public:
+    struct Calibration {
+        bool tsc;
+        double ns_per_tick;        // 1.0 without TSC
+        uint64_t anchor_ticks;     // Paired reading used for wall conversion
+        int64_t anchor_wall_ns;    // system_clock ns at anchor_ticks
+    };
+
+    static uint64_t now() {
+#if HFT_CLOCK_HAS_TSC
+        if (calibration().tsc) {
+            return __rdtsc();
+        }
+#endif
+        return monotonicNs(true);
+    }
+
+    static uint64_t nowPrecise() {
+#if HFT_CLOCK_HAS_TSC
+        if (calibration().tsc) {
+            return __rdtsc();
+        }
+#endif
+        return monotonicNs(false);
+    }
+
+    // Duration conversions
+    static uint64_t toNanos(uint64_t ticks) {
+        const Calibration& c = calibration();
+        return c.tsc ? static_cast<uint64_t>(ticks * c.ns_per_tick) : ticks;
+    }
+    static uint64_t fromNanos(uint64_t ns) {
+        const Calibration& c = calibration();
+        return c.tsc ? static_cast<uint64_t>(ns / c.ns_per_tick) : ns;
+    }
+
+    // Wall-clock conversions (system_clock epoch)
+    static int64_t toWallNs(uint64_t ticks) {
+        const Calibration& c = calibration();
+        double delta = static_cast<double>(static_cast<int64_t>(ticks - c.anchor_ticks)) * c.ns_per_tick;
+        return c.anchor_wall_ns + static_cast<int64_t>(delta);
+    }
+    static std::chrono::system_clock::time_point toWallTime(uint64_t ticks) {
+        return std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(toWallNs(ticks))));
+    }
+    // Current wall time derived from now(), for records stored as wall time
+    static std::chrono::system_clock::time_point wallNow() { return toWallTime(now()); }
+
+    static bool isTsc() { return calibration().tsc; }
+    static const char* source() { return isTsc() ? "tsc" : "monotonic"; }
+    static double ticksPerSecond() { return 1e9 / calibration().ns_per_tick; }
+
+    static const Calibration& calibration() {
+        static const Calibration instance = calibrate();
+        return instance;
+    }
+
+private:
+    static Calibration calibrate();
+
+    static uint64_t monotonicNs(bool coarse) {
+#ifdef __linux__
+        timespec ts;
+        clock_gettime(coarse ? CLOCK_MONOTONIC_COARSE : CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+#else
+        (void)coarse;
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+};
+
+} // namespace hft
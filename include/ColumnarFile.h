@@ -0,0 +1,113 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace hft {
+
+// Typed columnar binary format (.hftc) for analytics exports.
+//
+// Layout (little endian):
+//   FileHeader (64 bytes)
+//   ColumnEntry[column_count] (64 bytes each)
+//   column data, each column starting on a 64-byte boundary
+//
+// Column codecs keep every stored element byte-aligned so a reader can
+// memory-map a column and decode it with one vectorized pass:
+//   RAW        values stored as-is
+//   FOR        value = base + offset, offsets stored as uint{8,16,32}
+//   DELTA_FOR  value[0] = base, value[i] = value[i-1] + delta_base + offset[i-1]
+// Integer columns get whichever codec stores the fewest bytes; floating
+// point columns are always RAW.
+enum class ColumnType : uint8_t {
+    INT64 = 0,
+    UINT64 = 1,
+    FLOAT64 = 2,
+    INT8 = 3
+};
+
+enum class ColumnCodec : uint8_t {
+    RAW = 0,
+    FOR = 1,
+    DELTA_FOR = 2
+};
+
+struct ColumnarFileHeader {
+    char magic[8];          // "HFTCOL01"
+    uint32_t version;
+    uint32_t column_count;
+    uint64_t row_count;
+    uint64_t reserved[5];
+};
+
+struct ColumnEntry {
+    char name[24];          // NUL-terminated
+    uint8_t type;           // ColumnType
+    uint8_t codec;          // ColumnCodec
+    uint8_t width;          // Bytes per stored element
+    uint8_t padding[5];
+    int64_t base;           // FOR base, or first value for DELTA_FOR
+    int64_t delta_base;     // Minimum delta for DELTA_FOR
+    uint64_t data_offset;   // From the start of the file
+    uint64_t data_size;     // Bytes
+};
+
+static_assert(sizeof(ColumnarFileHeader) == 64, "Unexpected .hftc header size");
+static_assert(sizeof(ColumnEntry) == 64, "Unexpected .hftc column entry size");
+
+// Collects whole columns and writes them as one .hftc file
+class ColumnarFileWriter {
+private:
+    struct Column {
+        std::string name;
+        ColumnType type;
+        std::vector<uint64_t> bits;  // Values as raw 64-bit patterns (INT8 widened)
+    };
+
+    size_t rows;
+    std::vector<Column> columns;
+
+public:
+    explicit ColumnarFileWriter(size_t row_count) : rows(row_count) {}
+
+    // Each column must hold exactly row_count values
+    void addInt64(const std::string& name, const std::vector<int64_t>& values);
+    void addUInt64(const std::string& name, const std::vector<uint64_t>& values);
+    void addFloat64(const std::string& name, const std::vector<double>& values);
+    void addInt8(const std::string& name, const std::vector<int8_t>& values);
+
+    size_t getRowCount() const { return rows; }
+    size_t getColumnCount() const { return columns.size(); }
+
+    bool write(const std::string& filename) const;
+};
+
+// Loads a .hftc file and decodes columns back to their logical values
+class ColumnarFileReader {
+private:
+    std::vector<char> data;
+    ColumnarFileHeader header;
+    std::vector<ColumnEntry> entries;
+    bool valid;
+
+public:
+    explicit ColumnarFileReader(const std::string& filename);
+
+    bool isValid() const { return valid; }
+    size_t getRowCount() const { return valid ? header.row_count : 0; }
+    std::vector<std::string> getColumnNames() const;
+    const ColumnEntry* findColumn(const std::string& name) const;
+
+    // Empty when the column is missing or of a different type
+    std::vector<int64_t> getInt64(const std::string& name) const;
+    std::vector<uint64_t> getUInt64(const std::string& name) const;
+    std::vector<double> getFloat64(const std::string& name) const;
+    std::vector<int8_t> getInt8(const std::string& name) const;
+
+private:
+    std::vector<uint64_t> decode(const ColumnEntry& entry) const;
+};
+
+} // namespace hft
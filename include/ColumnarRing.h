@@ -0,0 +1,153 @@
+#pragma once
+
+#include "RingBuffer.h"
+#include <vector>
+#include <mutex>
+#include <utility>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+
+namespace hft {
+
+// Bounded ring of rows stored column by column (structure of arrays).
+// Derived classes own one std::vector per field and expose them through
+// forEachColumn(); this base tracks the shared head/count cursor so every
+// column wraps at the same physical index. Once `limit` rows are held the
+// oldest row is overwritten (after the derived evictRow() hook sees it);
+// below that, columns double as needed.
+template<typename Derived>
+class ColumnarRing {
+protected:
+    size_t head;             // Physical index of the oldest row
+    size_t count;            // Number of live rows
+    size_t limit;            // Logical capacity
+    size_t physical;         // Allocated rows per column (power of two)
+    size_t mask;             // physical - 1
+    uint64_t total_appended; // Rows appended since construction or clear()
+
+    explicit ColumnarRing(size_t capacity)
+        : head(0), count(0), limit(capacity > 0 ? capacity : 1),
+          physical(0), mask(0), total_appended(0) {
+    }
+
+    // Allocate the initial column storage (called from the derived constructor)
+    void initColumns() {
+        // Start small and let columns double towards the limit
+        physical = 1;
+        while (physical < limit && physical < 1024) {
+            physical <<= 1;
+        }
+        mask = physical - 1;
+        derived().forEachColumn([this](auto& column) { column.resize(physical); });
+    }
+
+    // Physical slot for a new row, evicting the oldest row once full
+    size_t appendSlot() {
+        ++total_appended;
+        if (count == limit) {
+            // The physical size may exceed limit, so the new row goes after
+            // the newest one rather than into the evicted slot
+            derived().evictRow(head);
+            head = (head + 1) & mask;
+            return (head + count - 1) & mask;
+        }
+        if (count == physical) {
+            relayout(physical * 2);
+        }
+        size_t slot = (head + count) & mask;
+        ++count;
+        return slot;
+    }
+
+    // Called with the physical slot of a row about to be dropped; derived
+    // classes hide this to archive evicted rows
+    void evictRow(size_t) {}
+
+    // Physical slot of the newest row
+    size_t backSlot() const { return (head + count - 1) & mask; }
+
+    // Physical slot of logical row i (0 is the oldest)
+    size_t slot(size_t i) const { return (head + i) & mask; }
+
+    template<typename T>
+    RingView<T> columnView(const std::vector<T>& column) const {
+        size_t first_len = count < physical - head ? count : physical - head;
+        return RingView<T>(Span<const T>(column.data() + head, first_len),
+                           Span<const T>(column.data(), count - first_len));
+    }
+
+public:
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t capacity() const { return limit; }
+    uint64_t totalAppended() const { return total_appended; }
+
+    // Call func(begin, end) for each contiguous physical range of live rows,
+    // oldest first. Loops over raw column pointers inside func vectorize.
+    template<typename Func>
+    void forEachSegment(Func&& func) const {
+        size_t first_len = count < physical - head ? count : physical - head;
+        if (first_len > 0) func(head, head + first_len);
+        if (count > first_len) func(size_t{0}, count - first_len);
+    }
+
+    void clear() {
+        head = 0;
+        count = 0;
+        total_appended = 0;
+    }
+
+    // Change the logical capacity, keeping the newest rows
+    void setCapacity(size_t capacity) {
+        limit = capacity > 0 ? capacity : 1;
+        while (count > limit) {
+            derived().evictRow(head);
+            head = (head + 1) & mask;
+            --count;
+        }
+        size_t target = 1;
+        while (target < count) {
+            target <<= 1;
+        }
+        if (target < 64) {
+            target = 64;
+        }
+        relayout(target);
+    }
+
+private:
+    Derived& derived() { return static_cast<Derived&>(*this); }
+
+    void relayout(size_t new_physical) {
+        derived().forEachColumn([this, new_physical](auto& column) {
+            using Column = std::decay_t<decltype(column)>;
+            Column resized(new_physical);
+            for (size_t i = 0; i < count; ++i) {
+                resized[i] = column[(head + i) & mask];
+            }
+            column.swap(resized);
+        });
+        head = 0;
+        physical = new_physical;
+        mask = new_physical - 1;
+    }
+};
+
+// Const reference to a shared object that keeps the owner's mutex locked
+// for as long as it lives
+template<typename T, typename Mutex = std::mutex>
+class LockedRef {
+private:
+    std::unique_lock<Mutex> lock;
+    const T* object;
+
+public:
+    LockedRef(std::unique_lock<Mutex>&& held_lock, const T& ref)
+        : lock(std::move(held_lock)), object(&ref) {}
+
+    const T& operator*() const { return *object; }
+    const T* operator->() const { return object; }
+};
+
+} // namespace hft
@@ -26,6 +26,7 @@ struct SystemConfig {
     bool enable_csv_export = true;
     std::string log_directory = "logs";
     std::string data_directory = "data";
+    uint64_t seed = 0;  // Master RNG seed applied by start(); 0 keeps the random one
 };
 
 } // namespace hft
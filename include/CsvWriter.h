@@ -0,0 +1,98 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+namespace hft {
+
+// Buffered CSV writer for bulk exports.
+// Numbers are formatted with std::to_chars (or an equivalent integer fast
+// path) straight into one large reusable buffer that is flushed with a
+// single fwrite when full. Timestamps are
+// written as local "YYYY-MM-DD HH:MM:SS.ffffff" by TimestampFormatter.
+class CsvWriter {
+private:
+    std::FILE* file;
+    std::vector<char> buffer;
+    size_t used;
+    bool row_started;
+
+    // Longest single field written without a bounds check
+    static constexpr size_t MAX_FIELD_CHARS = 64;
+
+public:
+    explicit CsvWriter(const std::string& filename, size_t buffer_size = 1 << 20);
+    ~CsvWriter();
+
+    CsvWriter(const CsvWriter&) = delete;
+    CsvWriter& operator=(const CsvWriter&) = delete;
+
+    bool isOpen() const { return file != nullptr; }
+
+    // Header line (written verbatim, newline appended)
+    void writeHeader(std::string_view header);
+
+    // Fields of the current row
+    void field(double value) {
+        char* out = beginField(MAX_FIELD_CHARS);
+        used = formatDouble(out, value) - buffer.data();
+    }
+
+    void field(uint64_t value) {
+        char* out = beginField(MAX_FIELD_CHARS);
+        used = std::to_chars(out, out + MAX_FIELD_CHARS, value).ptr - buffer.data();
+    }
+
+    void field(int64_t value) {
+        char* out = beginField(MAX_FIELD_CHARS);
+        used = std::to_chars(out, out + MAX_FIELD_CHARS, value).ptr - buffer.data();
+    }
+
+    void field(std::string_view text) {
+        char* out = beginField(text.size());
+        std::memcpy(out, text.data(), text.size());
+        used += text.size();
+    }
+
+    // Local date/time with microseconds from nanoseconds since the system_clock epoch
+    void timestampField(int64_t nanos_since_epoch);
+
+    void endRow() {
+        if (buffer.size() - used < 1) {
+            flush();
+        }
+        buffer[used++] = '\n';
+        row_started = false;
+    }
+
+    void flush();
+    void close();
+
+private:
+    // Reserve room for one field (plus separator) and return where it starts
+    char* beginField(size_t max_chars) {
+        if (buffer.size() - used < max_chars + 1) {
+            flush();
+            if (buffer.size() < max_chars + 1) {
+                buffer.resize(max_chars + 1);
+            }
+        }
+        if (row_started) {
+            buffer[used++] = ',';
+        }
+        row_started = true;
+        return buffer.data() + used;
+    }
+
+
+    // Shortest round-trip text for value; values with at most six decimals
+    // take an integer fast path that yields the same digits as std::to_chars
+    static char* formatDouble(char* out, double value);
+};
+
+} // namespace hft
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace hft {
+
+// Live event log: a memory-mapped ring file written by the engine and
+// followed by other processes (C++ or python_analytics/live_monitor.py)
+// without locks, sockets or per-event syscalls.
+//
+// Layout (little endian):
+//   bytes   0..63   EventLogHeader
+//   bytes  64..127  write cursor (uint64, records published so far)
+//   bytes 128..     EventRecord[capacity]
+//
+// The single writer copies a record into slot (cursor % capacity) and then
+// publishes cursor + 1 with a release store. Readers load the cursor with
+// acquire, copy the records they have not seen, and re-read the cursor to
+// discard any slot the writer may have lapped during the copy.
+//
+// A writer builds its file under a temporary name and renames it over the
+// path, so a restarted engine never truncates a file a reader has mapped.
+// Readers notice the restart (the cursor moving backwards, or, once caught
+// up, the path naming a different file or creation time) and re-attach.
+enum class EventType : uint32_t {
+    SIMULATION_START = 1,  // values[0] = initial price
+    TICK = 2,              // values: mark, best bid, best ask, position, realized PnL, total PnL
+    SIMULATION_STOP = 3
+};
+
+struct EventRecord {
+    int64_t timestamp_ns;  // Nanoseconds since the system_clock epoch
+    uint32_t type;         // EventType
+    uint32_t reserved;
+    double values[6];
+};
+
+struct EventLogHeader {
+    char magic[8];          // "HFTEVLG1"
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t capacity;      // Records (power of two)
+    int64_t created_ns;
+    uint8_t padding[32];
+};
+
+static_assert(sizeof(EventRecord) == 64, "Unexpected event record size");
+static_assert(sizeof(EventLogHeader) == 64, "Unexpected event log header size");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared cursor must be lock-free");
+
+class EventLogWriter {
+private:
+    std::string path;
+    char* base;
+    size_t mapped_bytes;
+    std::atomic<uint64_t>* cursor;
+    EventRecord* records;
+    uint64_t capacity;
+    uint64_t mask;
+    uint64_t next;          // Next sequence number (writer-private copy of the cursor)
+
+public:
+    explicit EventLogWriter(const std::string& file_path, size_t capacity_records = 1 << 16);
+    ~EventLogWriter();
+
+    EventLogWriter(const EventLogWriter&) = delete;
+    EventLogWriter& operator=(const EventLogWriter&) = delete;
+
+    bool isOpen() const { return base != nullptr; }
+    const std::string& getPath() const { return path; }
+    uint64_t getCapacity() const { return capacity; }
+    uint64_t getWriteCursor() const { return next; }
+
+    // Publish one record (single writer)
+    void append(EventType type, int64_t timestamp_ns, const double* values, size_t count);
+};
+
+class EventLogReader {
+private:
+    std::string path;
+    const char* base;
+    size_t mapped_bytes;
+    const std::atomic<uint64_t>* cursor;
+    const EventRecord* records;
+    uint64_t capacity;
+    uint64_t mask;
+    uint64_t position;      // Next sequence number to read
+    uint64_t dropped;       // Records overwritten before they were read
+    uint64_t restarts;      // Times the reader re-attached to a new writer
+    uint64_t file_id[2];    // Device and inode of the mapped file
+    int64_t created_ns;     // Header creation time of the mapped file
+
+public:
+    // Opens an existing log; starts at the oldest record the writer cannot be overwriting
+    explicit EventLogReader(const std::string& file_path);
+    ~EventLogReader();
+
+    EventLogReader(const EventLogReader&) = delete;
+    EventLogReader& operator=(const EventLogReader&) = delete;
+
+    bool isOpen() const { return base != nullptr; }
+    uint64_t getCapacity() const { return capacity; }
+    uint64_t getPosition() const { return position; }
+    uint64_t getDropped() const { return dropped; }
+    uint64_t getRestarts() const { return restarts; }
+    uint64_t getWriteCursor() const;
+
+    // Append up to max_records unread records to out; returns the number appended.
+    // Follows a restarted writer from its first record; a reader whose file
+    // could not be opened retries here
+    size_t poll(std::vector<EventRecord>& out, size_t max_records = SIZE_MAX);
+
+private:
+    bool attach();
+    void detach();
+    bool writerRestarted() const;
+};
+
+} // namespace hft
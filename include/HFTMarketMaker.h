@@ -10,6 +10,20 @@
 #include "PriceGenerator.h"
 #include "MarketMaker.h"
 #include "PnLCalculator.h"
+#include "WorkerPool.h"
+#include "PortfolioPnL.h"
+#include "SlidingStats.h"
+#include "NumericKernels.h"
+#include "Random.h"
+#include "Tokenizer.h"
+#include "TimestampFormatter.h"
+#include "ColumnarFile.h"
+#include "EventLog.h"
+#include "AllocTracker.h"
+#include "LatencyHistogram.h"
+#include "ProfiledMutex.h"
+#include "Trace.h"
+#include "Clock.h"
 
 // Additional includes for the complete system
 #include <iostream>
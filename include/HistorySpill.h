@@ -0,0 +1,115 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace hft {
+
+// Append-only log of fixed-size records in memory-mapped segment files.
+// Every record starts with an int64 timestamp (nanoseconds); each segment
+// keeps its time range so range queries only touch the segments (and pages)
+// they overlap. Only the active segment holds a file descriptor and a
+// writable mapping; a full segment is sealed (trimmed to its records and
+// closed) and mapped read-only only while a range query reads it.
+// Unavailable on platforms without POSIX mmap (isOpen() is false).
+class SpillLog {
+private:
+    struct Segment {
+        std::string path;
+        int fd;              // -1 once sealed
+        char* base;          // Writable mapping of the active segment; null once sealed
+        size_t count;        // Records written
+        int64_t min_ts;
+        int64_t max_ts;
+        bool sorted;         // Timestamps non-decreasing within the segment
+    };
+
+    std::string directory;
+    std::string name;
+    size_t record_size;
+    size_t segment_records;
+    size_t segment_bytes;
+    std::vector<Segment> segments;
+    uint64_t total_records;
+    bool open;
+
+public:
+    static constexpr size_t HEADER_SIZE = 64;
+
+    SpillLog(const std::string& dir, const std::string& log_name, size_t record_bytes,
+             size_t records_per_segment = 65536);
+    ~SpillLog();
+
+    SpillLog(const SpillLog&) = delete;
+    SpillLog& operator=(const SpillLog&) = delete;
+
+    bool isOpen() const { return open; }
+    const std::string& getDirectory() const { return directory; }
+
+    // Append one record (first 8 bytes are the int64 timestamp)
+    bool append(const void* record);
+
+    uint64_t size() const { return total_records; }
+    size_t getSegmentCount() const { return segments.size(); }
+
+    // Call func(record) for every record with from_ns <= timestamp <= to_ns, oldest first
+    template<typename Func>
+    void forEachInRange(int64_t from_ns, int64_t to_ns, Func&& func) const {
+        for (const auto& segment : segments) {
+            if (segment.count == 0 || segment.max_ts < from_ns || segment.min_ts > to_ns) {
+                continue;
+            }
+            SegmentReader reader(*this, segment);
+            const char* base = reader.data();
+            if (base == nullptr) {
+                continue;
+            }
+            size_t begin = segment.sorted ? lowerBound(base, segment.count, from_ns) : 0;
+            for (size_t i = begin; i < segment.count; ++i) {
+                const char* rec = recordAt(base, i);
+                int64_t ts = timestampOf(rec);
+                if (ts > to_ns) {
+                    if (segment.sorted) break;
+                    continue;
+                }
+                if (ts >= from_ns) {
+                    func(rec);
+                }
+            }
+        }
+    }
+
+    // Remove all segment files
+    void clear();
+
+private:
+    // Segment contents for one query: the active segment's live mapping, or
+    // a read-only mapping of a sealed segment released on destruction
+    class SegmentReader {
+    private:
+        const char* base;
+        size_t mapped_bytes;  // Non-zero when this reader owns the mapping
+
+    public:
+        SegmentReader(const SpillLog& log, const Segment& segment);
+        ~SegmentReader();
+
+        SegmentReader(const SegmentReader&) = delete;
+        SegmentReader& operator=(const SegmentReader&) = delete;
+
+        const char* data() const { return base; }
+    };
+
+    bool openSegment();
+    void sealSegment(Segment& segment);
+    void closeSegment(Segment& segment, bool remove_file);
+    const char* recordAt(const char* base, size_t i) const {
+        return base + HEADER_SIZE + i * record_size;
+    }
+    static int64_t timestampOf(const char* record);
+    size_t lowerBound(const char* base, size_t count, int64_t ts) const;
+};
+
+} // namespace hft
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace hft {
+
+// Lock-free log-linear histogram of durations in nanoseconds.
+//
+// Each power of two is split into SUB_BUCKETS linear buckets, so a recorded
+// value lands in a bucket at most 25% wider than itself and percentiles are
+// reported as that bucket's upper bound (clamped to the exact maximum).
+// record() is a handful of relaxed atomic increments and never allocates, so
+// it is safe on hot paths and from any number of threads.
+class LatencyHistogram {
+public:
+    static constexpr size_t SUB_BUCKET_BITS = 2;
+    static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKETS = 64 * SUB_BUCKETS;
+
+private:
+    std::atomic<uint64_t> buckets[BUCKETS];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> max_value;
+
+public:
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(uint64_t ns) {
+        buckets[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t seen = max_value.load(std::memory_order_relaxed);
+        while (ns > seen && !max_value.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    void reset();
+
+    uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+    uint64_t getTotal() const { return sum.load(std::memory_order_relaxed); }
+    uint64_t getMax() const { return max_value.load(std::memory_order_relaxed); }
+    double getMean() const;
+    uint64_t getPercentile(double p) const;  // p in 0-100; 0 when empty
+
+    // "n=... mean=... p50=... p90=... p99=... max=..." with adaptive units
+    std::string summary() const;
+
+    static size_t bucketIndex(uint64_t ns) {
+        if (ns < SUB_BUCKETS) {
+            return static_cast<size_t>(ns);
+        }
+        size_t msb = 63 - static_cast<size_t>(__builtin_clzll(ns));
+        size_t sub = static_cast<size_t>(ns >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+        return (msb - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+    }
+    static uint64_t bucketUpperBound(size_t index);
+};
+
+// "850ns", "12.4us", "3.10ms"
+std::string formatNanos(double ns);
+
+} // namespace hft
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "RingBuffer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace hft {
+
+enum class CostBasisMethod {
+    FIFO,          // Close the oldest open lot first
+    LIFO,          // Close the most recent open lot first
+    AVERAGE_COST   // Single pooled lot at the weighted average price
+};
+
+struct Lot {
+    double quantity;  // Signed: positive for long, negative for short
+    double price;
+};
+
+// Matches fills against open lots and accumulates realized PnL.
+// Every fill opens at most one lot and every lot is closed at most once,
+// so matching is O(1) amortized per fill.
+class LotEngine {
+private:
+    RingBuffer<Lot> lots;
+    CostBasisMethod method;
+
+    double position;      // Net signed position
+    double open_cost;     // Sum of quantity * price over open lots
+    double realized_pnl;  // Running realized PnL
+
+public:
+    // Residual quantity below which a lot or position is considered closed
+    static constexpr double QUANTITY_EPSILON = 1e-9;
+
+    explicit LotEngine(CostBasisMethod cost_method = CostBasisMethod::FIFO,
+                       size_t initial_lots = 64);
+
+    // Apply a signed fill (positive = buy, negative = sell).
+    // Returns the realized PnL produced by this fill.
+    double applyFill(double quantity, double price);
+
+    // State queries
+    double getPosition() const { return position; }
+    double getOpenCost() const { return open_cost; }
+    double getRealizedPnL() const { return realized_pnl; }
+    double getAverageCost() const { return position != 0.0 ? open_cost / position : 0.0; }
+    double getUnrealizedPnL(double mark_price) const { return position * mark_price - open_cost; }
+    size_t getOpenLotCount() const;
+    CostBasisMethod getMethod() const { return method; }
+
+    // Utility functions
+    void reset();
+
+    // Matching step shared by every holder of open lots.
+    // Applies a signed fill to position and open_cost, closing lots from
+    // the caller's ring, which must provide empty(), front(), back(),
+    // pop_front() and pop_back() over its open lots (oldest first).
+    // Returns the realized PnL; open_quantity receives the size of the lot
+    // the caller must push at price (0 when none opens or under AVERAGE_COST).
+    template <typename Ring>
+    static double matchFill(CostBasisMethod method, Ring& lots, double& position, double& open_cost,
+                            double quantity, double price, double& open_quantity);
+
+private:
+    template <typename Ring>
+    static double closeAgainstLots(bool fifo, Ring& lots, double& position, double& open_cost,
+                                   double& quantity, double price);
+    static double closeAgainstAverage(double& position, double& open_cost,
+                                      double& quantity, double price);
+};
+
+template <typename Ring>
+double LotEngine::matchFill(CostBasisMethod method, Ring& lots, double& position, double& open_cost,
+                            double quantity, double price, double& open_quantity) {
+    double realized = 0.0;
+    open_quantity = 0.0;
+
+    // A fill against the current position closes lots first
+    if (position != 0.0 && (position > 0.0) != (quantity > 0.0)) {
+        if (method == CostBasisMethod::AVERAGE_COST) {
+            realized = closeAgainstAverage(position, open_cost, quantity, price);
+        } else {
+            realized = closeAgainstLots(method == CostBasisMethod::FIFO, lots, position, open_cost,
+                                        quantity, price);
+        }
+    }
+
+    // Whatever is left opens (or extends) a position in the fill's direction
+    if (std::abs(quantity) > QUANTITY_EPSILON) {
+        position += quantity;
+        open_cost += quantity * price;
+        if (method != CostBasisMethod::AVERAGE_COST) {
+            open_quantity = quantity;
+        }
+    }
+
+    if (std::abs(position) <= QUANTITY_EPSILON) {
+        position = 0.0;
+        open_cost = 0.0;
+    }
+
+    return realized;
+}
+
+template <typename Ring>
+double LotEngine::closeAgainstLots(bool fifo, Ring& lots, double& position, double& open_cost,
+                                   double& quantity, double price) {
+    double realized = 0.0;
+
+    while (std::abs(quantity) > QUANTITY_EPSILON && !lots.empty()) {
+        Lot& lot = fifo ? lots.front() : lots.back();
+
+        // Signed quantity taken out of the lot (same sign as the lot)
+        double matched = std::min(std::abs(quantity), std::abs(lot.quantity));
+        double closed = lot.quantity > 0.0 ? matched : -matched;
+
+        realized += closed * (price - lot.price);
+        position -= closed;
+        open_cost -= closed * lot.price;
+        quantity += closed;
+        lot.quantity -= closed;
+
+        if (std::abs(lot.quantity) <= QUANTITY_EPSILON) {
+            if (fifo) {
+                lots.pop_front();
+            } else {
+                lots.pop_back();
+            }
+        }
+    }
+
+    return realized;
+}
+
+} // namespace hft
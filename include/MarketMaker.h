@@ -2,6 +2,7 @@
 
 #include "OrderBook.h"
 #include "PriceGenerator.h"
+#include "LatencyHistogram.h"
 #include <memory>
 #include <vector>
 #include <deque>
@@ -11,18 +12,18 @@
 namespace hft {
 
 struct MarketMakerConfig {
-    double base_spread_bps;        // Base spread in basis points
-    double min_spread_bps;         // Minimum spread in basis points
-    double max_spread_bps;         // Maximum spread in basis points
-    double volatility_multiplier;  // Multiplier for volatility-based spread adjustment
-    double max_position_size;      // Maximum position size (long/short)
-    double position_limit;         // Position limit before reducing exposure
-    uint64_t order_refresh_ms;     // Order refresh interval in milliseconds
-    double order_size;             // Size of each order placed
-    bool dynamic_spread;           // Whether to use dynamic spread adjustment
-    bool risk_management;          // Whether to enable risk management
-    double max_loss_limit;         // Maximum loss limit before emergency stop
-    double stop_loss_threshold;    // Stop loss threshold
+    double base_spread_bps = 15.0;          // Base spread in basis points
+    double min_spread_bps = 5.0;            // Minimum spread in basis points
+    double max_spread_bps = 50.0;           // Maximum spread in basis points
+    double volatility_multiplier = 2.0;     // Multiplier for volatility-based spread adjustment
+    double max_position_size = 1000.0;      // Maximum position size (long/short)
+    double position_limit = 500.0;          // Position limit before reducing exposure
+    uint64_t order_refresh_ms = 100;        // Order refresh interval in milliseconds
+    double order_size = 100.0;              // Size of each order placed
+    bool dynamic_spread = true;             // Whether to use dynamic spread adjustment
+    bool risk_management = true;            // Whether to enable risk management
+    double max_loss_limit = -10000.0;       // Maximum loss limit before emergency stop
+    double stop_loss_threshold = -5000.0;   // Stop loss threshold
 };
 
 class MarketMaker {
@@ -50,12 +51,18 @@ private:
     double max_loss_limit;
     double stop_loss_threshold;
     bool emergency_stop;
+    std::atomic<bool> running{false};
     
     // Performance tracking
     std::chrono::system_clock::time_point start_time;
     uint64_t total_orders_placed;
     uint64_t total_trades_executed;
     
+    // Tick-to-quote: from the price tick's creation to the end of the book
+    // operations quoting it; each tick is counted once
+    LatencyHistogram tick_to_quote_ns;
+    uint64_t last_quoted_tick = 0;  // Clock ticks
+    
     // Thread safety
     mutable std::mutex market_maker_mutex;
 
@@ -98,6 +105,8 @@ public:
     std::string getStatusString() const;
     double getSharpeRatio() const;
     double getMaxDrawdown() const;
+    const LatencyHistogram& getTickToQuoteLatency() const { return tick_to_quote_ns; }
+    void resetTickToQuoteLatency();
     
     // Configuration
     void updateConfig(const MarketMakerConfig& new_config);
@@ -105,6 +114,7 @@ public:
     
     // Utility functions
     bool isRunning() const;
+    void start();
     void stop();
     void reset();
 
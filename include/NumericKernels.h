@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+
+namespace hft {
+namespace kernels {
+
+// Reductions over contiguous double arrays used by the analytics code
+// (volatility, Sharpe, correlation, drawdown) and by the sliding-window
+// statistics (running sums, EMA).
+//
+// Each kernel has a scalar, SSE4, AVX2 and AVX-512 implementation; the best
+// one the CPU supports is selected on first use. Sums are computed pairwise
+// over fixed-size blocks, so the rounding error grows with log(n) rather
+// than n, and results differ between ISA levels only in the last bits.
+enum class Isa {
+    SCALAR,
+    SSE4,
+    AVX2,
+    AVX512
+};
+
+struct CrossMoments {
+    double sxx;  // Sum of (x - mean_x)^2
+    double syy;  // Sum of (y - mean_y)^2
+    double sxy;  // Sum of (x - mean_x) * (y - mean_y)
+};
+
+double sum(const double* data, size_t n);
+double sumSquaredDeviations(const double* data, size_t n, double center);  // Sum of (x - center)^2
+double dot(const double* x, const double* y, size_t n);
+CrossMoments crossMoments(const double* x, const double* y, size_t n, double mean_x, double mean_y);
+
+// Largest peak-to-trough decline: max over i of (max(values[0..i]) - values[i])
+double maxDrawdown(const double* values, size_t n);
+
+// First-order linear recurrence out[i] = decay * out[i - 1] + in[i], with
+// out[-1] = init; decay = 1 gives a running sum. `in` and `out` may be the
+// same array. The vector versions scan each register in log2(lanes)
+// shift-and-add steps, so only one add per register is loop-carried.
+void linearScan(const double* in, size_t n, double decay, double init, double* out);
+
+// Sliding-window statistics for outputs j in [0, count), each over
+// x[j, j + window), given the shifted sums s1 = sum(x - k) and
+// s2 = sum((x - k)^2) of window 0. The entering-minus-leaving deltas are
+// prefix-summed in registers (as in linearScan) and each statistic is
+// finished in the same pass, so every output is written once. Reads
+// x[0, count + window - 1).
+enum class WindowStat {
+    MEAN,
+    VARIANCE,  // Sum of squared deviations times inv_denom
+    STDDEV,    // Square root of VARIANCE
+    ZSCORE     // Of each window's last sample, against the population stddev
+};
+void windowStat(WindowStat stat, const double* x, size_t count, size_t window, double k,
+                double s1, double s2, double inv_denom, double* out);
+
+// Pearson correlation over the same windows of x and y, given window 0's
+// sums of (x - kx), (y - ky), their squares and their product
+struct WindowSums {
+    double sx;
+    double sy;
+    double sxx;
+    double syy;
+    double sxy;
+};
+void windowCorrelation(const double* x, const double* y, size_t count, size_t window,
+                       double kx, double ky, const WindowSums& first, double* out);
+
+// Two-pass mean and variance built on the kernels above
+double mean(const double* data, size_t n);
+double variance(const double* data, size_t n, bool sample);
+
+// Dispatch control
+Isa activeIsa();
+Isa bestSupportedIsa();
+bool isSupported(Isa isa);
+bool setIsa(Isa isa);  // Force a level (benchmarks, tests); false if the CPU lacks it
+const char* isaName(Isa isa);
+
+} // namespace kernels
+} // namespace hft
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <string>
-#include <chrono>
 #include <cstdint>
 
 namespace hft {
@@ -34,8 +33,8 @@ struct Order {
     double quantity;
     double filled_quantity;
     OrderStatus status;
-    std::chrono::system_clock::time_point timestamp;
-    std::chrono::system_clock::time_point created_time;
+    uint64_t timestamp;     // Last update, Clock ticks
+    uint64_t created_time;  // Clock ticks
     
     // Constructor
     Order(uint64_t id, const std::string& sym, OrderSide s, OrderType t, 
@@ -1,16 +1,26 @@
 #pragma once
 
 #include "Order.h"
+#include "ProfiledMutex.h"
 #include <map>
 #include <unordered_map>
 #include <vector>
 #include <memory>
-#include <mutex>
 #include <chrono>
 #include <atomic>
 
 namespace hft {
 
+// Best prices, resting size at the best levels and depth, read under one lock
+struct TopOfBook {
+    double best_bid;
+    double best_ask;
+    double bid_size;
+    double ask_size;
+    size_t bid_levels;
+    size_t ask_levels;
+};
+
 class OrderBook {
 private:
     // Price level -> vector of orders (bids and asks)
@@ -24,7 +34,7 @@ private:
     std::string symbol;
     
     // Thread safety
-    mutable std::mutex order_book_mutex;
+    mutable ProfiledMutex order_book_mutex{"order_book_mutex"};
     
     // Order ID counter
     std::atomic<uint64_t> next_order_id{1};
@@ -41,7 +51,7 @@ public:
     // Order management
     uint64_t addOrder(OrderSide side, OrderType type, double price, double quantity);
     bool cancelOrder(uint64_t order_id);
-    bool modifyOrder(uint64_t order_id, double new_price, double new_quantity);
+    bool modifyOrder(uint64_t order_id, double new_price, double new_quantity);  // Keeps the id, loses queue priority
     
     // Order book queries
     double getBestBid() const;
@@ -50,6 +60,7 @@ public:
     double getSpread() const;
     double getBidVolume() const;
     double getAskVolume() const;
+    TopOfBook getTopOfBook() const;
     
     // Price level queries
     std::vector<std::pair<double, double>> getTopBids(int levels = 5) const;
@@ -79,6 +90,13 @@ private:
     template<typename Compare>
     void removeOrderFromPriceLevel(std::map<double, std::vector<std::shared_ptr<Order>>, Compare>& price_levels, 
                                   double price, uint64_t order_id);
+    template<typename Compare>
+    std::vector<std::pair<double, double>> getTopLevelsUnsafe(
+        const std::map<double, std::vector<std::shared_ptr<Order>>, Compare>& price_levels, int levels) const;
+    // Fills against the best levels, removing filled orders; returns the unfilled quantity
+    template<typename Compare>
+    double fillAgainstUnsafe(std::map<double, std::vector<std::shared_ptr<Order>>, Compare>& price_levels,
+                             double quantity);
     void cleanupEmptyPriceLevels();
     void updateOrderStatus(std::shared_ptr<Order> order, OrderStatus status);
     uint64_t generateOrderId();
@@ -1,49 +1,80 @@
 #pragma once
 
+#include "LotEngine.h"
+#include "RingBuffer.h"
+#include "PnLHistory.h"
+#include "SlidingStats.h"
+#include "SeqLock.h"
+#include "ProfiledMutex.h"
 #include <vector>
-#include <deque>
 #include <chrono>
-#include <atomic>
-#include <mutex>
 #include <string>
 
 namespace hft {
 
-struct Trade {
-    std::chrono::system_clock::time_point timestamp;
-    double price;
-    double quantity;
-    double side;  // 1.0 for buy, -1.0 for sell
-    double trade_value;
-    uint64_t trade_id;
+// Open/high/low/close of total PnL over one time bucket
+struct PnLBar {
+    std::chrono::system_clock::time_point bucket_start;
+    double open;
+    double high;
+    double low;
+    double close;
+    double position;    // Position at the last update in the bucket
+    double mark_price;  // Mark price at the last update in the bucket
+    uint64_t updates;   // Number of mark/trade updates folded into the bar
 };
 
-struct PnLSnapshot {
-    std::chrono::system_clock::time_point timestamp;
+// Immutable PnL state block published by the writer after every update
+struct PnLState {
     double realized_pnl;
     double unrealized_pnl;
     double total_pnl;
     double position;
+    double average_cost;
     double mark_price;
+    double max_drawdown;
     double daily_pnl;
-    double cumulative_pnl;
+    uint64_t trade_count;
+    uint64_t update_count;
+};
+
+enum class SnapshotPolicy {
+    EVERY_TICK,        // One snapshot per PnL update
+    EVERY_N_TICKS,     // One snapshot every N PnL updates
+    ON_CHANGE,         // Only when total PnL or position moves beyond epsilon
+    TIME_BUCKET_OHLC   // One snapshot and one OHLC bar per time bucket
+};
+
+struct SnapshotConfig {
+    SnapshotPolicy policy = SnapshotPolicy::EVERY_TICK;
+    size_t every_n_ticks = 10;
+    double change_epsilon = 0.01;
+    std::chrono::milliseconds bucket_interval{1000};
 };
 
 class PnLCalculator {
 private:
-    // Trade history
-    std::deque<Trade> trade_history;
-    std::deque<PnLSnapshot> pnl_history;
+    // Trade and snapshot history (columnar, bounded by max_history_size)
+    TradeHistory trade_history;
+    PnLHistory pnl_history;
+    RingBuffer<PnLBar> pnl_bars;
+    
+    // Snapshot conflation
+    SnapshotConfig snapshot_config;
+    size_t updates_since_snapshot;
     
     // Current state
-    double current_position;
-    double average_cost;
+    LotEngine lot_engine;
     double mark_price;
     
     // PnL tracking
-    std::atomic<double> realized_pnl{0.0};
-    std::atomic<double> unrealized_pnl{0.0};
-    std::atomic<double> total_pnl{0.0};
+    double realized_pnl;
+    double unrealized_pnl;
+    double total_pnl;
+    
+    // Latest state for lock-free readers (written under pnl_mutex)
+    SeqLock<PnLState> published_state;
+    uint64_t update_count;
     
     // Daily tracking
     std::chrono::system_clock::time_point last_reset;
@@ -54,17 +85,25 @@ private:
     // Performance metrics
     double max_drawdown;
     double peak_value;
-    std::vector<double> returns;
+    RingBuffer<double> returns;
+    RollingMoments return_stats;  // Sliding window over the last metrics_window returns
+    
+    // Trade outcomes, counted on fills that realize PnL
+    uint64_t winning_trades;
+    uint64_t losing_trades;
+    double gross_profit;
+    double gross_loss;
     
     // Configuration
     size_t max_history_size;
     bool track_daily_metrics;
     
     // Thread safety
-    mutable std::mutex pnl_mutex;
+    mutable ProfiledMutex pnl_mutex{"pnl_mutex"};
 
 public:
-    explicit PnLCalculator(size_t history_size = 10000, bool daily_tracking = true);
+    explicit PnLCalculator(size_t history_size = 10000, bool daily_tracking = true,
+                           CostBasisMethod cost_method = CostBasisMethod::FIFO);
     ~PnLCalculator() = default;
     
     // Trade recording
@@ -77,23 +116,28 @@ public:
     void calculateRealizedPnL();
     void calculateUnrealizedPnL();
     
-    // Position management
+    // Position management (quantity is signed: positive buys, negative sells)
     void updatePosition(double quantity, double price);
     double getCurrentPosition() const;
     double getAverageCost() const;
-    
-    // PnL queries
-    double getRealizedPnL() const { return realized_pnl.load(); }
-    double getUnrealizedPnL() const { return unrealized_pnl.load(); }
-    double getTotalPnL() const { return total_pnl.load(); }
+    size_t getOpenLotCount() const;
+    CostBasisMethod getCostBasisMethod() const { return lot_engine.getMethod(); }
+    
+    // PnL queries (lock-free reads of the published state)
+    PnLState getState() const { return published_state.load(); }
+    double getRealizedPnL() const { return published_state.load().realized_pnl; }
+    double getUnrealizedPnL() const { return published_state.load().unrealized_pnl; }
+    double getTotalPnL() const { return published_state.load().total_pnl; }
     double getMarkToMarketPnL() const;
     
-    // Performance metrics
+    // Performance metrics (O(1) when lookback matches the metrics window)
     double getSharpeRatio(size_t lookback = 252) const;
     double getMaxDrawdown() const;
     double getVolatility(size_t lookback = 252) const;
     double getWinRate() const;
     double getProfitFactor() const;
+    void setMetricsWindow(size_t window);
+    size_t getMetricsWindow() const;
     
     // Daily metrics
     double getDailyPnL() const;
@@ -101,13 +145,38 @@ public:
     double getDailyLow() const;
     void resetDailyMetrics();
     
-    // History and analysis
-    std::vector<PnLSnapshot> getPnLHistory() const;
+    // Snapshot policy
+    void setSnapshotConfig(const SnapshotConfig& config);
+    SnapshotConfig getSnapshotConfig() const;
+    
+    // History and analysis. The returned views keep pnl_mutex locked for as
+    // long as they live, and pnl_mutex is not recursive: hold at most one at
+    // a time and do not call any other PnLCalculator method while holding
+    // one (HFT_LOCK_CHECKS builds abort on the re-entrant lock instead of hanging).
+    // getTradeHistory()/getReturns() return copies and have no such rule.
+    LockedRef<PnLHistory, ProfiledMutex> getPnLHistory() const;
+    LockedRef<TradeHistory, ProfiledMutex> getTradeColumns() const;
+    LockedRingView<PnLBar, ProfiledMutex> getPnLBars() const;
     std::vector<Trade> getTradeHistory() const;
     std::vector<double> getReturns() const;
     
+    // History spill: rows evicted beyond max_history_size are appended to
+    // memory-mapped segment files in directory (one directory per calculator)
+    bool enableHistorySpill(const std::string& directory, size_t segment_rows = 65536);
+    void disableHistorySpill();
+    bool isHistorySpillEnabled() const;
+    uint64_t getSpilledTradeCount() const;
+    uint64_t getSpilledSnapshotCount() const;
+    
+    // Range queries over spilled and in-memory history
+    std::vector<Trade> getTradesBetween(std::chrono::system_clock::time_point from,
+                                        std::chrono::system_clock::time_point to) const;
+    std::vector<PnLSnapshot> getSnapshotsBetween(std::chrono::system_clock::time_point from,
+                                                 std::chrono::system_clock::time_point to) const;
+    
     // Export and reporting
     void exportToCSV(const std::string& filename) const;
+    bool exportToColumnar(const std::string& filename) const;  // .hftc, see ColumnarFile.h
     std::string generateReport() const;
     
     // Utility functions
@@ -120,11 +189,22 @@ private:
     // Helper functions
     void addToHistory(const Trade& trade);
     void addToPnLHistory(const PnLSnapshot& snapshot);
+    void recordSnapshot();
+    void updateBar(std::chrono::system_clock::time_point now);
+    PnLSnapshot makeSnapshot(std::chrono::system_clock::time_point now) const;
     void updateDailyMetrics();
     void updateDrawdownMetrics();
+    void publishState();
     double calculateReturn(double current_value, double previous_value) const;
     void trimHistory();
     
+    // Unlocked metric reads (caller holds pnl_mutex)
+    double getSharpeRatioUnsafe(size_t lookback) const;
+    double getVolatilityUnsafe(size_t lookback) const;
+    double getWinRateUnsafe() const;
+    double getProfitFactorUnsafe() const;
+    void returnMomentsUnsafe(size_t lookback, double& mean, double& variance) const;
+    
     // Performance calculations
     double calculateVolatility(const std::vector<double>& returns) const;
     double calculateSharpeRatio(const std::vector<double>& returns) const;
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "ColumnarRing.h"
+#include "HistorySpill.h"
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+
+namespace hft {
+
+struct Trade {
+    std::chrono::system_clock::time_point timestamp;
+    double price;
+    double quantity;
+    double side;  // 1.0 for buy, -1.0 for sell
+    double trade_value;
+    uint64_t trade_id;
+};
+
+struct PnLSnapshot {
+    std::chrono::system_clock::time_point timestamp;
+    double realized_pnl;
+    double unrealized_pnl;
+    double total_pnl;
+    double position;
+    double mark_price;
+    double daily_pnl;
+    double cumulative_pnl;
+};
+
+// Columnar trade history: one contiguous array per Trade field
+class TradeHistory : public ColumnarRing<TradeHistory> {
+    friend class ColumnarRing<TradeHistory>;
+
+private:
+    std::vector<int64_t> timestamp_ns;  // Nanoseconds since the system_clock epoch
+    std::vector<double> price;
+    std::vector<double> quantity;
+    std::vector<double> side;
+    std::vector<double> trade_value;
+    std::vector<uint64_t> trade_id;
+
+    // Evicted rows, when spilling is enabled
+    std::unique_ptr<SpillLog> spill;
+
+    template<typename Func>
+    void forEachColumn(Func&& func) {
+        func(timestamp_ns);
+        func(price);
+        func(quantity);
+        func(side);
+        func(trade_value);
+        func(trade_id);
+    }
+
+    void evictRow(size_t slot);
+
+public:
+    explicit TradeHistory(size_t capacity);
+
+    void push(const Trade& trade);
+    void clear();
+
+    // Archive evicted rows to memory-mapped segment files under directory
+    bool enableSpill(const std::string& directory, size_t segment_rows = 65536);
+    void disableSpill() { spill.reset(); }
+    bool isSpilling() const { return spill != nullptr; }
+    uint64_t spilledCount() const { return spill ? spill->size() : 0; }
+
+    // Spilled and in-memory rows with from <= timestamp <= to, oldest first
+    std::vector<Trade> range(std::chrono::system_clock::time_point from,
+                             std::chrono::system_clock::time_point to) const;
+
+    // Materialize logical row i (0 is the oldest)
+    Trade operator[](size_t i) const;
+    Trade back() const { return (*this)[count - 1]; }
+
+    // Column views, oldest first
+    RingView<int64_t> timestamps() const { return columnView(timestamp_ns); }
+    RingView<double> prices() const { return columnView(price); }
+    RingView<double> quantities() const { return columnView(quantity); }
+    RingView<double> sides() const { return columnView(side); }
+    RingView<double> tradeValues() const { return columnView(trade_value); }
+    RingView<uint64_t> tradeIds() const { return columnView(trade_id); }
+
+    // Raw column storage, indexed by the physical ranges from forEachSegment()
+    const int64_t* timestampColumn() const { return timestamp_ns.data(); }
+    const double* priceColumn() const { return price.data(); }
+    const double* quantityColumn() const { return quantity.data(); }
+    const double* sideColumn() const { return side.data(); }
+    const double* tradeValueColumn() const { return trade_value.data(); }
+    const uint64_t* tradeIdColumn() const { return trade_id.data(); }
+};
+
+// Columnar PnL snapshot history: one contiguous array per PnLSnapshot field
+class PnLHistory : public ColumnarRing<PnLHistory> {
+    friend class ColumnarRing<PnLHistory>;
+
+private:
+    std::vector<int64_t> timestamp_ns;  // Nanoseconds since the system_clock epoch
+    std::vector<double> realized_pnl;
+    std::vector<double> unrealized_pnl;
+    std::vector<double> total_pnl;
+    std::vector<double> position;
+    std::vector<double> mark_price;
+    std::vector<double> daily_pnl;
+    std::vector<double> cumulative_pnl;
+
+    // Evicted rows, when spilling is enabled
+    std::unique_ptr<SpillLog> spill;
+
+    template<typename Func>
+    void forEachColumn(Func&& func) {
+        func(timestamp_ns);
+        func(realized_pnl);
+        func(unrealized_pnl);
+        func(total_pnl);
+        func(position);
+        func(mark_price);
+        func(daily_pnl);
+        func(cumulative_pnl);
+    }
+
+    void write(size_t slot, const PnLSnapshot& snapshot);
+    void evictRow(size_t slot);
+
+public:
+    explicit PnLHistory(size_t capacity);
+
+    void push(const PnLSnapshot& snapshot);
+    void replaceBack(const PnLSnapshot& snapshot);
+    void clear();
+
+    // Archive evicted rows to memory-mapped segment files under directory
+    bool enableSpill(const std::string& directory, size_t segment_rows = 65536);
+    void disableSpill() { spill.reset(); }
+    bool isSpilling() const { return spill != nullptr; }
+    uint64_t spilledCount() const { return spill ? spill->size() : 0; }
+
+    // Spilled and in-memory rows with from <= timestamp <= to, oldest first
+    std::vector<PnLSnapshot> range(std::chrono::system_clock::time_point from,
+                                   std::chrono::system_clock::time_point to) const;
+
+    // Materialize logical row i (0 is the oldest)
+    PnLSnapshot operator[](size_t i) const;
+    PnLSnapshot back() const { return (*this)[count - 1]; }
+    double backTotalPnL() const { return total_pnl[backSlot()]; }
+    double backPosition() const { return position[backSlot()]; }
+
+    // Column views, oldest first
+    RingView<int64_t> timestamps() const { return columnView(timestamp_ns); }
+    RingView<double> realizedPnL() const { return columnView(realized_pnl); }
+    RingView<double> unrealizedPnL() const { return columnView(unrealized_pnl); }
+    RingView<double> totalPnL() const { return columnView(total_pnl); }
+    RingView<double> positions() const { return columnView(position); }
+    RingView<double> markPrices() const { return columnView(mark_price); }
+    RingView<double> dailyPnL() const { return columnView(daily_pnl); }
+    RingView<double> cumulativePnL() const { return columnView(cumulative_pnl); }
+
+    // Raw column storage, indexed by the physical ranges from forEachSegment()
+    const int64_t* timestampColumn() const { return timestamp_ns.data(); }
+    const double* realizedPnLColumn() const { return realized_pnl.data(); }
+    const double* unrealizedPnLColumn() const { return unrealized_pnl.data(); }
+    const double* totalPnLColumn() const { return total_pnl.data(); }
+    const double* positionColumn() const { return position.data(); }
+    const double* markPriceColumn() const { return mark_price.data(); }
+    const double* dailyPnLColumn() const { return daily_pnl.data(); }
+    const double* cumulativePnLColumn() const { return cumulative_pnl.data(); }
+};
+
+} // namespace hft
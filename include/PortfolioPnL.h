@@ -0,0 +1,120 @@
+#pragma once
+
+#include "LotEngine.h"
+#include "WorkerPool.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+
+namespace hft {
+
+using SymbolId = uint32_t;
+using StrategyId = uint32_t;
+
+struct PnLTotals {
+    double realized_pnl = 0.0;
+    double unrealized_pnl = 0.0;
+    double total_pnl = 0.0;
+    double net_exposure = 0.0;    // Sum of position * mark
+    double gross_exposure = 0.0;  // Sum of |position * mark|
+
+    PnLTotals& operator+=(const PnLTotals& other) {
+        realized_pnl += other.realized_pnl;
+        unrealized_pnl += other.unrealized_pnl;
+        total_pnl += other.total_pnl;
+        net_exposure += other.net_exposure;
+        gross_exposure += other.gross_exposure;
+        return *this;
+    }
+};
+
+// Book-level PnL across many symbols and strategies.
+// Each (strategy, symbol) pair owns a position slot; slot state is kept
+// in parallel arrays indexed by slot id so mark-to-market is one
+// contiguous pass over all slots. Open lots live in one shared pool: every
+// slot owns a power-of-two ring carved out of it, and a ring that fills up
+// moves to a region twice its size at the end of the pool. Large books are
+// reduced in chunks on a persistent worker pool and combined pairwise.
+class PortfolioPnL {
+private:
+    // Registries
+    std::unordered_map<std::string, SymbolId> symbol_ids;
+    std::vector<std::string> symbol_names;
+    std::unordered_map<std::string, StrategyId> strategy_ids;
+    std::vector<std::string> strategy_names;
+    std::unordered_map<uint64_t, uint32_t> slot_lookup;  // (strategy << 32 | symbol) -> slot
+
+    // Per-symbol state
+    std::vector<double> symbol_marks;
+
+    // Per-slot state (structure of arrays)
+    std::vector<SymbolId> slot_symbol;
+    std::vector<StrategyId> slot_strategy;
+    std::vector<double> position;
+    std::vector<double> open_cost;
+    std::vector<double> realized;
+    std::vector<double> unrealized;
+
+    // Per-slot lot rings inside lot_pool (unused under AVERAGE_COST)
+    std::vector<Lot> lot_pool;
+    std::vector<uint32_t> lot_offset;
+    std::vector<uint32_t> lot_capacity;
+    std::vector<uint32_t> lot_head;
+    std::vector<uint32_t> lot_count;
+    size_t lot_pool_dead;  // Entries left behind by rings that moved
+
+    // Configuration
+    CostBasisMethod cost_method;
+    mutable WorkerPool workers;
+
+    // Thread safety
+    mutable std::mutex portfolio_mutex;
+
+public:
+    explicit PortfolioPnL(CostBasisMethod method = CostBasisMethod::FIFO, size_t threads = 0);
+    ~PortfolioPnL() = default;
+
+    // Registration
+    SymbolId registerSymbol(const std::string& symbol);
+    StrategyId registerStrategy(const std::string& strategy);
+    SymbolId getSymbolId(const std::string& symbol) const;
+    std::string getSymbolName(SymbolId id) const;
+    size_t getSymbolCount() const;
+    size_t getSlotCount() const;
+    size_t getOpenLotCount(StrategyId strategy, SymbolId symbol) const;
+
+    // Fills (quantity is signed: positive buys, negative sells); returns realized PnL
+    double applyFill(StrategyId strategy, SymbolId symbol, double quantity, double price);
+
+    // Mark-to-market
+    void updateMark(SymbolId symbol, double price);
+    void markToMarket(const double* marks, size_t count);  // marks[i] is the mark for symbol i
+
+    // Aggregation
+    PnLTotals getBookTotals() const;
+    std::vector<PnLTotals> getTotalsBySymbol() const;
+    std::vector<PnLTotals> getTotalsByStrategy() const;
+    double getPosition(StrategyId strategy, SymbolId symbol) const;
+
+    // Utility functions
+    void setWorkerThreads(size_t threads);
+    void clear();
+
+private:
+    struct SlotLots;  // A slot's ring in the shape LotEngine::matchFill expects
+
+    uint32_t getOrCreateSlot(StrategyId strategy, SymbolId symbol);
+    void revalueAll();
+    Lot& lotAt(uint32_t slot, uint32_t index) {
+        return lot_pool[lot_offset[slot] + ((lot_head[slot] + index) & (lot_capacity[slot] - 1))];
+    }
+    void pushLot(uint32_t slot, const Lot& lot);
+    void moveLots(uint32_t slot, uint32_t capacity, std::vector<Lot>& pool);
+    void compactLots();
+    PnLTotals reduceRange(size_t begin, size_t end) const;
+    PnLTotals slotTotals(size_t slot) const;
+};
+
+} // namespace hft
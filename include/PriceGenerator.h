@@ -1,19 +1,19 @@
 #pragma once
 
-#include <random>
+#include "Random.h"
+#include "ProfiledMutex.h"
 #include <chrono>
 #include <vector>
 #include <deque>
 #include <atomic>
-#include <mutex>
+#include <limits>
 
 namespace hft {
 
 class PriceGenerator {
 private:
-    // Random number generation
-    std::mt19937 rng;
-    std::normal_distribution<double> normal_dist;
+    // Random number generation (seeded from the constructing thread's stream)
+    Xoshiro256pp rng;
     
     // Price simulation parameters
     double initial_price;
@@ -31,8 +31,11 @@ private:
     std::atomic<double> min_price{std::numeric_limits<double>::max()};
     std::atomic<double> max_price{std::numeric_limits<double>::lowest()};
     
+    // Creation time of the latest tick (Clock::nowPrecise ticks), 0 before the first
+    std::atomic<uint64_t> last_tick_ticks{0};
+    
     // Thread safety
-    mutable std::mutex price_mutex;
+    mutable ProfiledMutex price_mutex{"price_mutex"};
 
 public:
     PriceGenerator(double initial_p, double drift_rate, double vol, 
@@ -54,6 +57,7 @@ public:
     double getMinPrice() const { return min_price.load(); }
     double getMaxPrice() const { return max_price.load(); }
     uint64_t getTicksGenerated() const { return ticks_generated.load(); }
+    uint64_t getLastTickTimestamp() const { return last_tick_ticks.load(std::memory_order_acquire); }
     
     // Parameter updates
     void updateDrift(double new_drift);
@@ -62,7 +66,7 @@ public:
     
     // Reset and utility
     void reset(double new_initial_price);
-    void setSeed(uint32_t seed);
+    void setSeed(uint64_t seed);
     
     // Geometric Brownian Motion formula
     static double calculateGBMPrice(double current_price, double drift, 
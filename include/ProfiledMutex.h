@@ -0,0 +1,175 @@
+#pragma once
+
+#include "LatencyHistogram.h"
+#include "Clock.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace hft {
+
+// Contention counters for every lock sharing a name (e.g. all OrderBook
+// instances feed "order_book_mutex"). Entries live until exit.
+struct LockStats {
+    std::string name;
+    std::atomic<uint64_t> acquisitions{0};
+    std::atomic<uint64_t> contended{0};  // lock() found the mutex held
+    LatencyHistogram wait_ns;            // Contended acquisitions only
+    LatencyHistogram hold_ns;
+
+    explicit LockStats(const std::string& lock_name) : name(lock_name) {}
+};
+
+// Registry of named lock statistics, filled by ProfiledMutex when the build
+// defines HFT_LOCK_PROFILING (CMake -DHFT_LOCK_PROFILING=ON, or
+// HFT_LOCK_PROFILING=1 ./build.sh). Without it nothing is ever registered.
+class LockProfiler {
+public:
+    static constexpr bool isEnabled() {
+#ifdef HFT_LOCK_PROFILING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static LockStats& stats(const char* name);     // Creates the entry on first use
+    static std::vector<const LockStats*> all();    // Sorted by name
+    static void reset();
+
+    // One line per lock: acquisitions, contention rate, wait and hold times
+    static std::string report();
+};
+
+// Builds defining HFT_LOCK_CHECKS (CMake Debug builds or
+// -DHFT_LOCK_CHECKS=ON, HFT_LOCK_CHECKS=1 ./build.sh) remember which
+// ProfiledMutexes the current thread holds and abort when a thread locks one
+// of them again: the mutex is not recursive, so that would deadlock. Kept in
+// a fixed thread-local list so ProfiledMutex stays the size of a std::mutex.
+namespace lock_debug {
+#ifdef HFT_LOCK_CHECKS
+constexpr size_t MAX_HELD = 16;  // Deeper nesting is not tracked
+inline thread_local const void* held[MAX_HELD];
+inline thread_local size_t held_count = 0;
+
+inline void checkNotHeld(const void* mutex) {
+    for (size_t i = 0; i < held_count; ++i) {
+        if (held[i] == mutex) {
+            std::fprintf(stderr, "ProfiledMutex %p locked again by the thread that holds it\n", mutex);
+            std::abort();
+        }
+    }
+}
+
+inline void acquired(const void* mutex) {
+    if (held_count < MAX_HELD) {
+        held[held_count++] = mutex;
+    }
+}
+
+inline void released(const void* mutex) {
+    for (size_t i = held_count; i-- > 0;) {
+        if (held[i] == mutex) {
+            held[i] = held[--held_count];
+            return;
+        }
+    }
+}
+#else
+inline void checkNotHeld(const void*) {}
+inline void acquired(const void*) {}
+inline void released(const void*) {}
+#endif
+} // namespace lock_debug
+
+#ifdef HFT_LOCK_PROFILING
+
+// std::mutex that records acquisitions, contended acquisitions and wait and
+// hold time histograms under its name. Usable with lock_guard/unique_lock.
+class ProfiledMutex {
+private:
+    std::mutex mutex;
+    LockStats& stats;
+    uint64_t acquired_at = 0;  // Clock ticks; written by the current holder only
+
+    static uint64_t nanosSince(uint64_t start) {
+        return Clock::toNanos(Clock::nowPrecise() - start);
+    }
+
+public:
+    explicit ProfiledMutex(const char* name) : stats(LockProfiler::stats(name)) {}
+
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    void lock() {
+        lock_debug::checkNotHeld(this);
+        if (!mutex.try_lock()) {
+            uint64_t start = Clock::nowPrecise();
+            mutex.lock();
+            stats.wait_ns.record(nanosSince(start));
+            stats.contended.fetch_add(1, std::memory_order_relaxed);
+        }
+        lock_debug::acquired(this);
+        stats.acquisitions.fetch_add(1, std::memory_order_relaxed);
+        acquired_at = Clock::nowPrecise();
+    }
+
+    bool try_lock() {
+        if (!mutex.try_lock()) {
+            return false;
+        }
+        lock_debug::acquired(this);
+        stats.acquisitions.fetch_add(1, std::memory_order_relaxed);
+        acquired_at = Clock::nowPrecise();
+        return true;
+    }
+
+    void unlock() {
+        uint64_t held = nanosSince(acquired_at);
+        lock_debug::released(this);
+        mutex.unlock();
+        stats.hold_ns.record(held);
+    }
+};
+
+#else
+
+// Profiling disabled: a plain std::mutex; the name is discarded
+class ProfiledMutex {
+private:
+    std::mutex mutex;
+
+public:
+    explicit ProfiledMutex(const char*) {}
+
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    void lock() {
+        lock_debug::checkNotHeld(this);
+        mutex.lock();
+        lock_debug::acquired(this);
+    }
+
+    bool try_lock() {
+        if (!mutex.try_lock()) {
+            return false;
+        }
+        lock_debug::acquired(this);
+        return true;
+    }
+
+    void unlock() {
+        lock_debug::released(this);
+        mutex.unlock();
+    }
+};
+
+#endif
+
+} // namespace hft
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+
+namespace hft {
+
+// xoshiro256++ (Blackman & Vigna): 256 bits of state, period 2^256 - 1,
+// a handful of adds/shifts per output. Satisfies UniformRandomBitGenerator,
+// so it also works with the <random> distributions.
+class Xoshiro256pp {
+private:
+    uint64_t state[4];
+    double spare_normal;   // Second Box-Muller output
+    bool has_spare;
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256pp(uint64_t seed_value = 0) { seed(seed_value); }
+    Xoshiro256pp(uint64_t s0, uint64_t s1, uint64_t s2, uint64_t s3)
+        : state{s0, s1, s2, s3}, spare_normal(0.0), has_spare(false) {}
+
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return std::numeric_limits<uint64_t>::max(); }
+
+    // Expands one 64-bit seed into the full state with SplitMix64
+    void seed(uint64_t seed_value);
+    static uint64_t splitMix64(uint64_t& x);
+
+    uint64_t operator()() {
+        uint64_t result = rotl(state[0] + state[3], 23) + state[0];
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Advance 2^128 steps; successive jumps give non-overlapping streams
+    void jump();
+
+    // Single draws
+    double nextDouble() { return static_cast<double>((*this)() >> 11) * 0x1.0p-53; }  // [0, 1)
+    double uniform(double min_value, double max_value) {
+        return min_value + (max_value - min_value) * nextDouble();
+    }
+    int64_t uniformInt(int64_t min_value, int64_t max_value);  // Inclusive, unbiased
+    double normal();
+    double normal(double mean, double stddev) { return mean + stddev * normal(); }
+    double exponential(double rate);
+
+    // Batch fills
+    void fillUniform(double* out, size_t n, double min_value = 0.0, double max_value = 1.0);
+    void fillNormal(double* out, size_t n, double mean = 0.0, double stddev = 1.0);
+    void fillExponential(double* out, size_t n, double rate = 1.0);
+};
+
+// Per-thread generators derived from one master seed.
+//
+// Each thread's generator is the master-seeded generator jumped once per
+// stream index, so streams never overlap. Threads get stream indices in
+// order of first use, starting at RESERVED_STREAMS; code that needs the same
+// stream regardless of thread start-up order binds one of the reserved
+// indices explicitly with bindThreadStream().
+namespace rng {
+
+constexpr uint64_t RESERVED_STREAMS = 8;
+
+// Reseeds every thread's generator (lazily, on its next use). Until this is
+// called the master seed comes from std::random_device.
+void setMasterSeed(uint64_t seed);
+uint64_t getMasterSeed();
+
+// Use stream `stream_index` on the calling thread from now on
+void bindThreadStream(uint64_t stream_index);
+uint64_t getThreadStream();
+
+// The calling thread's generator; not to be shared with other threads
+Xoshiro256pp& threadGenerator();
+
+} // namespace rng
+
+} // namespace hft
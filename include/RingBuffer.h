@@ -0,0 +1,167 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <utility>
+#include <cstddef>
+
+namespace hft {
+
+// Non-owning view over a contiguous range
+template<typename T>
+class Span {
+private:
+    T* ptr;
+    size_t length;
+
+public:
+    Span() : ptr(nullptr), length(0) {}
+    Span(T* data, size_t size) : ptr(data), length(size) {}
+
+    T* data() const { return ptr; }
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+    T* begin() const { return ptr; }
+    T* end() const { return ptr + length; }
+    T& operator[](size_t i) const { return ptr[i]; }
+};
+
+// View over the live elements of a ring: at most two contiguous segments,
+// the second one present only when the contents wrap around the array end.
+template<typename T>
+class RingView {
+private:
+    Span<const T> first;
+    Span<const T> second;
+
+public:
+    RingView() = default;
+    RingView(Span<const T> head_segment, Span<const T> tail_segment)
+        : first(head_segment), second(tail_segment) {}
+
+    size_t size() const { return first.size() + second.size(); }
+    bool empty() const { return size() == 0; }
+    const T& operator[](size_t i) const {
+        return i < first.size() ? first[i] : second[i - first.size()];
+    }
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[size() - 1]; }
+
+    Span<const T> getFirst() const { return first; }
+    Span<const T> getSecond() const { return second; }
+
+    template<typename Func>
+    void forEach(Func&& func) const {
+        for (const T& value : first) func(value);
+        for (const T& value : second) func(value);
+    }
+
+    // Contiguous copy, oldest first
+    std::vector<T> toVector() const {
+        std::vector<T> result;
+        result.reserve(size());
+        result.insert(result.end(), first.begin(), first.end());
+        result.insert(result.end(), second.begin(), second.end());
+        return result;
+    }
+};
+
+// RingView that keeps the owner's mutex locked for as long as it lives,
+// giving readers a consistent snapshot without copying the elements.
+template<typename T, typename Mutex = std::mutex>
+class LockedRingView : public RingView<T> {
+private:
+    std::unique_lock<Mutex> lock;
+
+public:
+    LockedRingView(std::unique_lock<Mutex>&& held_lock, const RingView<T>& view)
+        : RingView<T>(view), lock(std::move(held_lock)) {}
+};
+
+// Double-ended ring buffer backed by a power-of-two array.
+// Push/pop at either end is O(1); the buffer doubles when full, so the
+// amortized cost of push_back stays O(1) without per-element allocation.
+template<typename T>
+class RingBuffer {
+private:
+    std::vector<T> storage;
+    size_t head;   // Index of the front element
+    size_t count;  // Number of live elements
+    size_t mask;   // storage.size() - 1
+
+public:
+    explicit RingBuffer(size_t initial_capacity = 64)
+        : head(0), count(0), mask(0) {
+        size_t capacity = 1;
+        while (capacity < initial_capacity) {
+            capacity <<= 1;
+        }
+        storage.resize(capacity);
+        mask = capacity - 1;
+    }
+
+    // Capacity queries
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    size_t capacity() const { return storage.size(); }
+
+    // Element access (index 0 is the front)
+    T& operator[](size_t i) { return storage[(head + i) & mask]; }
+    const T& operator[](size_t i) const { return storage[(head + i) & mask]; }
+    T& front() { return storage[head]; }
+    const T& front() const { return storage[head]; }
+    T& back() { return storage[(head + count - 1) & mask]; }
+    const T& back() const { return storage[(head + count - 1) & mask]; }
+
+    // Contiguous segments of the live elements, oldest first
+    RingView<T> view() const {
+        size_t first_len = count < storage.size() - head ? count : storage.size() - head;
+        return RingView<T>(Span<const T>(storage.data() + head, first_len),
+                           Span<const T>(storage.data(), count - first_len));
+    }
+
+    // Modifiers
+    void push_back(const T& value) {
+        if (count == storage.size()) {
+            grow(storage.size() * 2);
+        }
+        storage[(head + count) & mask] = value;
+        ++count;
+    }
+
+    void pop_front() {
+        head = (head + 1) & mask;
+        --count;
+    }
+
+    void pop_back() {
+        --count;
+    }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    void reserve(size_t n) {
+        if (n <= storage.size()) return;
+        size_t capacity = storage.size();
+        while (capacity < n) {
+            capacity <<= 1;
+        }
+        grow(capacity);
+    }
+
+private:
+    void grow(size_t new_capacity) {
+        std::vector<T> resized(new_capacity);
+        for (size_t i = 0; i < count; ++i) {
+            resized[i] = storage[(head + i) & mask];
+        }
+        storage.swap(resized);
+        head = 0;
+        mask = new_capacity - 1;
+    }
+};
+
+} // namespace hft
@@ -7,7 +7,10 @@
 #include "PriceGenerator.h"
 #include "MarketMaker.h"
 #include "PnLCalculator.h"
+#include "BookHistory.h"
+#include "EventLog.h"
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <atomic>
 #include <chrono>
@@ -16,6 +19,10 @@
 namespace hft {
 
 class SimulationEngine {
+public:
+    // Reserved RNG stream bound by the simulation thread (see Random.h)
+    static constexpr uint64_t SIMULATION_STREAM = 1;
+
 private:
     SystemConfig system_config;
     MarketMakerConfig mm_config;
@@ -25,6 +32,16 @@ private:
     std::shared_ptr<MarketMaker> market_maker;
     std::shared_ptr<PnLCalculator> pnl_calculator;
     
+    // Top of book sampled every tick
+    BookHistory book_history{10000};
+    mutable std::mutex book_mutex;
+    
+    // Live event log followed by external readers (written by the simulation thread)
+    std::unique_ptr<EventLogWriter> event_log;
+    
+    // Chrome trace output written by writeTrace(); empty until enableTrace()
+    std::string trace_path;
+    
     std::atomic<bool> running{false};
     std::thread simulation_thread;
     
@@ -60,11 +77,27 @@ public:
     void exportTradeData(const std::string& filename) const;
     void exportPnLData(const std::string& filename) const;
     
+    // Binary columnar export (.hftc): trade_data, pnl_data and orderbook_data
+    // files in directory, preferred by python_analytics over the CSVs
+    bool exportBinaryData(const std::string& directory) const;
+    
+    // Live event log (call before start()); see EventLog.h
+    bool enableEventLog(const std::string& path, size_t capacity_records = 1 << 16);
+    
+    // Timeline tracing (see Trace.h). Recording can be switched on and off at
+    // any time; writeTrace() dumps what the per-thread rings hold, so call it
+    // between runs
+    void enableTrace(const std::string& path, size_t ring_capacity = 1 << 16);
+    void disableTrace();
+    bool writeTrace() const;
+    
 private:
     // Main simulation loop
     void runSimulation();
     void processTick();
     void updateMarketData();
+    TopOfBook sampleOrderBook(double mark_price);
+    void publishTickEvent(double mark_price, const TopOfBook& top);
     
     // Performance monitoring
     void updatePerformanceMetrics();
@@ -0,0 +1,229 @@
+#pragma once
+
+#include "RingBuffer.h"
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace hft {
+
+// Sliding-window statistics.
+// The classes below update in O(1) (amortized for min/max) per sample and
+// are meant for streaming use; the free functions at the end compute the
+// same statistics over whole arrays in O(n) through the dispatched SIMD
+// kernels (kernels::windowStat, windowCorrelation, linearScan), which
+// prefix-sum the running-sum updates in vector registers.
+
+// Mean and variance over the last `window` samples, updated in O(1).
+// Uses Welford's recurrence; once the window is full each new sample
+// replaces the oldest one in a single combined add/remove step.
+class RollingMoments {
+private:
+    std::vector<double> samples;
+    size_t window;
+    size_t next;   // Slot the next sample is written to
+    size_t count;
+    double mean_value;
+    double m2;     // Sum of squared deviations from the mean
+
+public:
+    explicit RollingMoments(size_t window_size = 252)
+        : samples(window_size > 0 ? window_size : 1), window(window_size > 0 ? window_size : 1),
+          next(0), count(0), mean_value(0.0), m2(0.0) {}
+
+    void add(double x) {
+        if (count < window) {
+            ++count;
+            double delta = x - mean_value;
+            mean_value += delta / count;
+            m2 += delta * (x - mean_value);
+        } else {
+            double old = samples[next];
+            double old_mean = mean_value;
+            mean_value += (x - old) / window;
+            m2 += (x - old) * (x - mean_value + old - old_mean);
+            if (m2 < 0.0) m2 = 0.0;
+        }
+        samples[next] = x;
+        next = next + 1 == window ? 0 : next + 1;
+    }
+
+    void clear() {
+        next = 0;
+        count = 0;
+        mean_value = 0.0;
+        m2 = 0.0;
+    }
+
+    size_t size() const { return count; }
+    size_t getWindow() const { return window; }
+    bool full() const { return count == window; }
+    double mean() const { return mean_value; }
+    double variance() const { return count > 0 ? m2 / count : 0.0; }          // Population
+    double sampleVariance() const { return count > 1 ? m2 / (count - 1) : 0.0; }
+    double stddev() const { return std::sqrt(variance()); }
+    double sampleStddev() const { return std::sqrt(sampleVariance()); }
+
+    // Standard score of x against the current window (0 when degenerate)
+    double zscore(double x) const {
+        double sd = stddev();
+        return sd > 0.0 ? (x - mean_value) / sd : 0.0;
+    }
+};
+
+// Minimum and maximum over the last `window` samples using monotonic deques
+class RollingMinMax {
+private:
+    RingBuffer<std::pair<uint64_t, double>> min_deque;  // Increasing values
+    RingBuffer<std::pair<uint64_t, double>> max_deque;  // Decreasing values
+    size_t window;
+    uint64_t index;  // Sequence number of the next sample
+
+public:
+    explicit RollingMinMax(size_t window_size = 252)
+        : min_deque(64), max_deque(64), window(window_size > 0 ? window_size : 1), index(0) {}
+
+    void add(double x) {
+        while (!min_deque.empty() && min_deque.back().second >= x) min_deque.pop_back();
+        while (!max_deque.empty() && max_deque.back().second <= x) max_deque.pop_back();
+        min_deque.push_back({index, x});
+        max_deque.push_back({index, x});
+
+        // Expire the sample that just left the window
+        ++index;
+        if (index > window) {
+            uint64_t oldest = index - window;
+            if (min_deque.front().first < oldest) min_deque.pop_front();
+            if (max_deque.front().first < oldest) max_deque.pop_front();
+        }
+    }
+
+    void clear() {
+        min_deque.clear();
+        max_deque.clear();
+        index = 0;
+    }
+
+    size_t size() const { return index < window ? static_cast<size_t>(index) : window; }
+    size_t getWindow() const { return window; }
+    double min() const { return min_deque.empty() ? 0.0 : min_deque.front().second; }
+    double max() const { return max_deque.empty() ? 0.0 : max_deque.front().second; }
+};
+
+// Exponential moving average; the first sample seeds the average
+class Ema {
+private:
+    double alpha;
+    double value;
+    bool seeded;
+
+public:
+    explicit Ema(double smoothing) : alpha(smoothing), value(0.0), seeded(false) {}
+
+    // Conventional span parameterization: alpha = 2 / (span + 1)
+    static Ema fromSpan(size_t span) { return Ema(2.0 / (static_cast<double>(span) + 1.0)); }
+
+    double add(double x) {
+        value = seeded ? value + alpha * (x - value) : x;
+        seeded = true;
+        return value;
+    }
+
+    void clear() {
+        value = 0.0;
+        seeded = false;
+    }
+
+    double get() const { return value; }
+    double getAlpha() const { return alpha; }
+    bool isSeeded() const { return seeded; }
+};
+
+// Pearson correlation over the last `window` (x, y) pairs.
+// Keeps means and co-moments with Welford updates; once the window is full
+// the oldest pair is removed with the inverse update before the new one is added.
+class RollingCorrelation {
+private:
+    std::vector<std::pair<double, double>> samples;
+    size_t window;
+    size_t next;
+    size_t count;
+    double mean_x;
+    double mean_y;
+    double m2_x;
+    double m2_y;
+    double c_xy;  // Sum of (x - mean_x) * (y - mean_y)
+
+public:
+    explicit RollingCorrelation(size_t window_size = 252)
+        : samples(window_size > 0 ? window_size : 1), window(window_size > 0 ? window_size : 1),
+          next(0), count(0), mean_x(0.0), mean_y(0.0), m2_x(0.0), m2_y(0.0), c_xy(0.0) {}
+
+    void add(double x, double y) {
+        if (count == window && count == 1) {
+            clear();
+        } else if (count == window) {
+            // Inverse Welford step for the pair leaving the window
+            auto [ox, oy] = samples[next];
+            double n = static_cast<double>(count);
+            double old_mean_x = (n * mean_x - ox) / (n - 1.0);
+            double old_mean_y = (n * mean_y - oy) / (n - 1.0);
+            m2_x -= (ox - mean_x) * (ox - old_mean_x);
+            m2_y -= (oy - mean_y) * (oy - old_mean_y);
+            c_xy -= (ox - old_mean_x) * (oy - mean_y);
+            mean_x = old_mean_x;
+            mean_y = old_mean_y;
+            --count;
+            if (m2_x < 0.0) m2_x = 0.0;
+            if (m2_y < 0.0) m2_y = 0.0;
+        }
+
+        ++count;
+        double dx = x - mean_x;
+        double dy = y - mean_y;
+        mean_x += dx / count;
+        mean_y += dy / count;
+        m2_x += dx * (x - mean_x);
+        m2_y += dy * (y - mean_y);
+        c_xy += dx * (y - mean_y);
+
+        samples[next] = {x, y};
+        next = next + 1 == window ? 0 : next + 1;
+    }
+
+    void clear() {
+        next = 0;
+        count = 0;
+        mean_x = mean_y = m2_x = m2_y = c_xy = 0.0;
+    }
+
+    size_t size() const { return count; }
+    size_t getWindow() const { return window; }
+    double covariance() const { return count > 1 ? c_xy / (count - 1) : 0.0; }  // Sample
+    double correlation() const {
+        double denom = std::sqrt(m2_x * m2_y);
+        return denom > 0.0 ? c_xy / denom : 0.0;
+    }
+};
+
+// Whole-array versions. Each output i describes the window
+// data[i, i + window); `out` must hold n - window + 1 values and nothing is
+// written when n < window.
+namespace sliding {
+
+void rollingMean(const double* data, size_t n, size_t window, double* out);
+void rollingVariance(const double* data, size_t n, size_t window, double* out, bool sample = true);
+void rollingStddev(const double* data, size_t n, size_t window, double* out, bool sample = true);
+void rollingMin(const double* data, size_t n, size_t window, double* out);
+void rollingMax(const double* data, size_t n, size_t window, double* out);
+void rollingZScore(const double* data, size_t n, size_t window, double* out);  // Of each window's last sample
+void rollingCorrelation(const double* x, const double* y, size_t n, size_t window, double* out);
+
+// out[i] is the EMA after data[0..i] (n outputs)
+void ema(const double* data, size_t n, double alpha, double* out);
+
+} // namespace sliding
+
+} // namespace hft
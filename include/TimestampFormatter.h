@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace hft {
+
+enum class TimestampPrecision {
+    SECONDS,  // "YYYY-MM-DD HH:MM:SS"
+    MILLIS,   // "YYYY-MM-DD HH:MM:SS.fff"
+    MICROS    // "YYYY-MM-DD HH:MM:SS.ffffff"
+};
+
+// Local-time timestamp formatting for logs, reports and exports.
+//
+// Each thread caches the formatted "YYYY-MM-DD HH:MM" of the local minute it
+// last formatted, so within a minute a call is a memcpy plus a few digit-pair
+// table lookups; localtime_r only runs when the minute changes. Time zone
+// offsets and DST transitions fall on minute boundaries, so the cache cannot
+// straddle one. Call resetTimezone() after changing TZ at runtime.
+class TimestampFormatter {
+public:
+    static constexpr size_t MAX_LENGTH = 26;
+
+    // Writes the timestamp to out (at least MAX_LENGTH bytes, not
+    // NUL-terminated); returns one past the last character written
+    static char* format(char* out, int64_t nanos_since_epoch,
+                        TimestampPrecision precision = TimestampPrecision::MICROS);
+
+    static std::string toString(int64_t nanos_since_epoch,
+                                TimestampPrecision precision = TimestampPrecision::MICROS);
+
+    static constexpr size_t length(TimestampPrecision precision) {
+        return precision == TimestampPrecision::SECONDS ? 19 :
+               precision == TimestampPrecision::MILLIS ? 23 : 26;
+    }
+
+    // Re-reads the TZ setting and invalidates every thread's cache
+    static void resetTimezone();
+};
+
+} // namespace hft
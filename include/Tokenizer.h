@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace hft {
+namespace utils {
+
+// Zero-copy text parsing. Tokens are string_views into the caller's buffer,
+// so they stay valid only as long as that buffer does; nothing here allocates
+// except splitInto growing its output vector.
+
+// First occurrence of `delimiter` in [begin, end), or end. Scans 16 bytes
+// per step with SSE2 where available.
+const char* findDelimiter(const char* begin, const char* end, char delimiter);
+
+// Splits on a single-character delimiter with std::getline semantics:
+// empty fields between delimiters are kept, a trailing delimiter does not
+// produce a final empty field, and empty input yields no fields.
+class Tokenizer {
+private:
+    const char* cursor;
+    const char* end;
+    char delimiter;
+
+public:
+    Tokenizer(std::string_view text, char delim)
+        : cursor(text.data()), end(text.data() + text.size()), delimiter(delim) {}
+
+    bool next(std::string_view& token) {
+        if (cursor == end) {
+            return false;
+        }
+        const char* stop = findDelimiter(cursor, end, delimiter);
+        token = std::string_view(cursor, static_cast<size_t>(stop - cursor));
+        cursor = stop == end ? end : stop + 1;
+        return true;
+    }
+
+    // Unconsumed input
+    std::string_view rest() const { return std::string_view(cursor, static_cast<size_t>(end - cursor)); }
+};
+
+// Clears `out` and fills it with the fields of `text`; returns the count
+size_t splitInto(std::string_view text, char delimiter, std::vector<std::string_view>& out);
+
+// Strips spaces, tabs, CR and LF from both ends
+std::string_view trimView(std::string_view text);
+
+// Whole-token number parsing with std::from_chars. Surrounding whitespace and
+// a leading '+' are accepted; anything else left over makes the parse fail
+// and leaves `out` untouched.
+bool parseDouble(std::string_view text, double& out);
+bool parseInt64(std::string_view text, int64_t& out);
+bool parseUInt64(std::string_view text, uint64_t& out);
+
+} // namespace utils
+} // namespace hft
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Clock.h"
+#include <atomic>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace hft {
+
+// Timeline tracing of engine activity, exported as Chrome Trace Event JSON
+// (load in chrome://tracing or ui.perfetto.dev).
+//
+// Each thread appends fixed-size records to its own ring: a relaxed load of
+// the ring head, one record store and a release store of the new head, with
+// no locks and no allocation after the thread's first event. When full the
+// ring overwrites its oldest records, so a dump shows the most recent
+// window. Scopes are recorded once, as complete events, when they end, so
+// an overwritten ring never leaves unmatched begin/end pairs behind.
+//
+// Event names and categories must be string literals (only the pointer is
+// stored). Tracing is off by default; while off a TraceScope costs one
+// relaxed atomic load.
+
+struct TraceEvent {
+    const char* category;
+    const char* name;
+    uint64_t start;        // Clock::nowPrecise ticks, converted at export
+    uint64_t duration;     // Ticks; 0 for instant events
+    char phase;            // 'X' complete scope, 'i' instant
+};
+
+class Tracer {
+private:
+    static std::atomic<bool> enabled;
+
+    static void record(const TraceEvent& event);
+
+public:
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+
+    // Per-thread ring size for threads that have not traced yet (default 65536)
+    static void setRingCapacity(size_t records);
+    // Label for the calling thread in the exported timeline
+    static void setThreadName(const std::string& name);
+
+    static void complete(const char* category, const char* name, uint64_t start, uint64_t end) {
+        record(TraceEvent{category, name, start, end - start, 'X'});
+    }
+    static void instant(const char* category, const char* name) {
+        if (isEnabled()) {
+            record(TraceEvent{category, name, Clock::nowPrecise(), 0, 'i'});
+        }
+    }
+
+    // Records held across all threads (at most one ring capacity each)
+    static size_t getEventCount();
+    // Drops recorded events; call while traced threads are idle
+    static void clear();
+
+    // Writes every thread's events in start order; meant to be called
+    // between runs, while the traced threads are idle
+    static bool writeChromeTrace(const std::string& path);
+};
+
+// Records the enclosing scope as one complete event if tracing was on when
+// it began
+class TraceScope {
+private:
+    const char* category;
+    const char* name;
+    uint64_t start;
+    bool active;
+
+public:
+    TraceScope(const char* trace_category, const char* trace_name)
+        : category(trace_category), name(trace_name), start(0), active(Tracer::isEnabled()) {
+        if (active) {
+            start = Clock::nowPrecise();
+        }
+    }
+
+    ~TraceScope() {
+        if (active) {
+            Tracer::complete(category, name, start, Clock::nowPrecise());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+} // namespace hft
@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include <cstdint>
+#include <cstddef>
 
 namespace hft {
 namespace utils {
@@ -13,17 +15,32 @@ std::string formatPrice(double price, int decimals = 2);
 
 // Time formatting
 std::string formatTimestamp(const std::chrono::system_clock::time_point& time);
+std::string formatDuration(uint64_t milliseconds);
+std::string formatBytes(uint64_t bytes);
+int64_t getCurrentTimestampNs();  // Nanoseconds since the system_clock epoch
 
 // Mathematical utilities
 double roundToTick(double price, double tick_size = TICK_SIZE);
 double calculateBasisPoints(double price1, double price2);
 double calculatePercentage(double value, double base);
 
-// Random number generation
+// Statistics
+double calculateVolatility(const std::vector<double>& returns);  // Sample standard deviation
+double calculateSharpeRatio(const std::vector<double>& returns, double risk_free_rate = 0.0);
+double calculateMaxDrawdown(const std::vector<double>& values);
+double calculateVaR(const std::vector<double>& returns, double confidence_level = 0.95);
+double calculateExpectedShortfall(const std::vector<double>& returns, double confidence_level = 0.95);
+double calculateCorrelation(const std::vector<double>& x, const std::vector<double>& y);
+
+// Rolling statistics, one value per full window (O(n), see SlidingStats.h)
+std::vector<double> calculateRollingAverage(const std::vector<double>& data, size_t window);
+std::vector<double> calculateRollingVolatility(const std::vector<double>& returns, size_t window);
+
+// Random number generation (per-thread generators, see Random.h)
 double generateRandomDouble(double min, double max);
 int generateRandomInt(int min, int max);
 
-// String utilities
+// String utilities (copying wrappers over Tokenizer.h)
 std::vector<std::string> splitString(const std::string& str, char delimiter);
 std::string trimString(const std::string& str);
 
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace hft {
+
+// Fixed set of long-lived helper threads for fork-join loops.
+//
+// run(tasks, fn) calls fn(i) once for every i in [0, tasks) and returns when
+// all calls have finished. The calling thread takes tasks too, so a pool of
+// size N has N - 1 helpers. Helpers sleep on a condition variable between
+// batches, so a batch costs one wake-up instead of a thread create and join.
+// Only one thread may call run() at a time.
+class WorkerPool {
+private:
+    using TaskFn = void (*)(void* context, size_t index);
+
+    std::vector<std::thread> helpers;
+    std::mutex pool_mutex;
+    std::condition_variable work_ready;
+    std::condition_variable work_done;
+
+    // Current batch (written under pool_mutex before helpers are woken)
+    TaskFn task_fn;
+    void* task_context;
+    size_t task_count;
+    std::atomic<size_t> next_task;
+    size_t busy_helpers;
+    uint64_t generation;
+    bool stopping;
+
+public:
+    explicit WorkerPool(size_t threads = 1);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Threads taking part in a batch, including the caller
+    size_t size() const { return helpers.size() + 1; }
+    void resize(size_t threads);
+
+    template <typename Fn>
+    void run(size_t tasks, Fn& fn) {
+        dispatch(tasks, [](void* context, size_t index) { (*static_cast<Fn*>(context))(index); }, &fn);
+    }
+
+private:
+    void dispatch(size_t tasks, TaskFn fn, void* context);
+    void drain(TaskFn fn, void* context, size_t tasks);
+    void helperLoop(uint64_t seen_generation);
+    void stopHelpers();
+};
+
+} // namespace hft
@@ -16,6 +16,8 @@ import sys
 from datetime import datetime
 import warnings
 
+from hftc import find_data_file, load_table
+
 # Suppress warnings for cleaner output
 warnings.filterwarnings('ignore')
 
@@ -42,27 +44,27 @@ class HFTAnalyzer:
         """Load all available data files."""
         print("Loading simulation data...")
         
-        # Load PnL data
-        pnl_files = list(self.data_dir.glob("*pnl*.csv"))
-        if pnl_files:
-            self.pnl_data = pd.read_csv(pnl_files[0])
-            print(f"Loaded PnL data: {len(self.pnl_data)} records")
+        # Binary columnar exports (.hftc) are preferred over CSV when present
+        pnl_file = find_data_file(self.data_dir, "pnl")
+        if pnl_file:
+            self.pnl_data = load_table(pnl_file)
+            print(f"Loaded PnL data: {len(self.pnl_data)} records ({pnl_file.name})")
         else:
             print("No PnL data found")
             
         # Load trade data
-        trade_files = list(self.data_dir.glob("*trade*.csv"))
-        if trade_files:
-            self.trade_data = pd.read_csv(trade_files[0])
-            print(f"Loaded trade data: {len(self.trade_data)} records")
+        trade_file = find_data_file(self.data_dir, "trade")
+        if trade_file:
+            self.trade_data = load_table(trade_file)
+            print(f"Loaded trade data: {len(self.trade_data)} records ({trade_file.name})")
         else:
             print("No trade data found")
             
         # Load order book data
-        orderbook_files = list(self.data_dir.glob("*orderbook*.csv"))
-        if orderbook_files:
-            self.orderbook_data = pd.read_csv(orderbook_files[0])
-            print(f"Loaded order book data: {len(self.orderbook_data)} records")
+        orderbook_file = find_data_file(self.data_dir, "orderbook")
+        if orderbook_file:
+            self.orderbook_data = load_table(orderbook_file)
+            print(f"Loaded order book data: {len(self.orderbook_data)} records ({orderbook_file.name})")
         else:
             print("No order book data found")
             
@@ -94,7 +96,8 @@ class HFTAnalyzer:
             
             # Calculate trade metrics
             self.trade_data['TradeValue'] = self.trade_data['Price'] * self.trade_data['Quantity']
-            self.trade_data['Side'] = self.trade_data['Side'].map({'BUY': 1, 'SELL': -1})
+            if self.trade_data['Side'].dtype == object:  # CSV exports spell out the side
+                self.trade_data['Side'] = self.trade_data['Side'].map({'BUY': 1, 'SELL': -1})
             
         print("Data preprocessing completed.")
     
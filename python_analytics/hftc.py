@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""
+Reader for the engine's binary columnar export format (.hftc).
+
+The layout is documented in include/ColumnarFile.h. RAW columns are returned
+as zero-copy views of a read-only memory map; FOR and DELTA_FOR columns are
+decoded with one vectorized numpy pass.
+"""
+
+import struct
+from pathlib import Path
+
+import numpy as np
+import pandas as pd
+
+MAGIC = b"HFTCOL01"
+HEADER = struct.Struct("<8sIIQ40x")        # magic, version, column_count, row_count
+ENTRY = struct.Struct("<24sBBB5xqqQQ")     # name, type, codec, width, base, delta_base, offset, size
+
+COLUMN_TYPES = {0: np.int64, 1: np.uint64, 2: np.float64, 3: np.int8}
+OFFSET_TYPES = {1: np.uint8, 2: np.uint16, 4: np.uint32, 8: np.uint64}
+RAW, FOR, DELTA_FOR = 0, 1, 2
+
+
+def is_hftc(path):
+    """True if the file starts with the .hftc magic."""
+    with open(path, "rb") as f:
+        return f.read(len(MAGIC)) == MAGIC
+
+
+def read_columns(path):
+    """Return {column name: numpy array} for a .hftc file."""
+    mapped = np.memmap(path, dtype=np.uint8, mode="r")
+    magic, version, column_count, row_count = HEADER.unpack_from(mapped, 0)
+    if magic != MAGIC or version != 1:
+        raise ValueError(f"{path} is not a version 1 .hftc file")
+
+    columns = {}
+    for i in range(column_count):
+        raw_name, col_type, codec, width, base, delta_base, offset, size = \
+            ENTRY.unpack_from(mapped, HEADER.size + i * ENTRY.size)
+        name = raw_name.split(b"\0", 1)[0].decode()
+        dtype = COLUMN_TYPES[col_type]
+        stored = mapped[offset:offset + size]
+
+        if codec == RAW:
+            values = stored.view(dtype)
+        elif codec == FOR:
+            # Modular int64 arithmetic reproduces the writer's unsigned offsets
+            values = (stored.view(OFFSET_TYPES[width]).astype(np.int64) + np.int64(base)).astype(dtype)
+        elif codec == DELTA_FOR:
+            deltas = stored.view(OFFSET_TYPES[width]).astype(np.int64) + np.int64(delta_base)
+            decoded = np.empty(row_count, dtype=np.int64)
+            if row_count > 0:
+                decoded[0] = base
+                np.cumsum(deltas, out=decoded[1:])
+                decoded[1:] += np.int64(base)
+            values = decoded.view(np.uint64) if dtype is np.uint64 else decoded.astype(dtype, copy=False)
+        else:
+            raise ValueError(f"Unknown codec {codec} for column {name}")
+
+        columns[name] = values
+    return columns
+
+
+def read_frame(path):
+    """Load a .hftc file as a DataFrame; Timestamp becomes datetime64[ns]."""
+    columns = read_columns(path)
+    if "Timestamp" in columns:
+        columns["Timestamp"] = columns["Timestamp"].view("datetime64[ns]")
+    return pd.DataFrame(columns, copy=False)
+
+
+def find_data_file(data_dir, pattern):
+    """Prefer <pattern>.hftc over <pattern>.csv in data_dir; None if neither exists."""
+    data_dir = Path(data_dir)
+    for path in sorted(data_dir.glob(f"*{pattern}*.hftc")):
+        if is_hftc(path):
+            return path
+    csv_files = sorted(data_dir.glob(f"*{pattern}*.csv"))
+    return csv_files[0] if csv_files else None
+
+
+def load_table(path):
+    """Load a .hftc or CSV export as a DataFrame."""
+    path = Path(path)
+    if path.suffix == ".hftc":
+        return read_frame(path)
+    return pd.read_csv(path)
@@ -0,0 +1,238 @@
+#!/usr/bin/env python3
+"""
+Live HFT Market Maker Monitor
+
+Follows the engine's memory-mapped event log (data/events.hftlog, see
+include/EventLog.h) while a simulation runs and updates metrics, and
+optionally a plot, incrementally. No locks, sockets or exported files are
+involved: the reader polls the published write cursor and copies new records
+out of the ring.
+"""
+
+import argparse
+import os
+import time
+from pathlib import Path
+
+import numpy as np
+
+MAGIC = b"HFTEVLG1"
+CURSOR_OFFSET = 64
+RECORDS_OFFSET = 128
+
+EVENT_START, EVENT_TICK, EVENT_STOP = 1, 2, 3
+
+RECORD = np.dtype([
+    ("timestamp_ns", "<i8"),
+    ("type", "<u4"),
+    ("reserved", "<u4"),
+    ("values", "<f8", (6,)),   # TICK: mark, best bid, best ask, position, realized PnL, total PnL
+])
+
+
+class EventLogFollower:
+    """Lock-free reader for the engine's event ring.
+
+    Attaches once the file exists with a complete header, and re-attaches
+    when the engine restarts: the cursor moving backwards, or, once caught
+    up, a different file (the writer renames a fresh log into place) or
+    creation time at the path.
+    """
+
+    def __init__(self, path):
+        self.path = Path(path)
+        self.mapped = None
+        self.dropped = 0
+        self.restarts = 0
+        self._attach()
+
+    @property
+    def attached(self):
+        return self.mapped is not None
+
+    def _attach(self):
+        try:
+            info = os.stat(self.path)
+            if info.st_size < RECORDS_OFFSET:
+                return False
+            mapped = np.memmap(self.path, dtype=np.uint8, mode="r")
+        except (OSError, ValueError):
+            return False
+        # The header may not be written yet; try again on the next poll
+        capacity = int(mapped[16:24].view("<u8")[0])
+        if (bytes(mapped[:8]) != MAGIC or capacity <= 0 or capacity & (capacity - 1)
+                or RECORDS_OFFSET + capacity * RECORD.itemsize > len(mapped)):
+            return False
+
+        self.mapped = mapped
+        self.file_id = (info.st_dev, info.st_ino)
+        self.created_ns = int(mapped[24:32].view("<i8")[0])
+        self.capacity = capacity
+        self.mask = capacity - 1
+        self.cursor = mapped[CURSOR_OFFSET:CURSOR_OFFSET + 8].view("<u8")
+        self.records = mapped[RECORDS_OFFSET:RECORDS_OFFSET + capacity * RECORD.itemsize].view(RECORD)
+
+        published = int(self.cursor[0])
+        self.position = max(0, published - capacity + 1)
+        return True
+
+    def _writer_restarted(self):
+        try:
+            info = os.stat(self.path)
+        except OSError:
+            return False
+        if (info.st_dev, info.st_ino) != self.file_id:
+            return True
+        return int(self.mapped[24:32].view("<i8")[0]) != self.created_ns
+
+    def poll(self, max_records=None):
+        """Return a structured array of records published since the last poll."""
+        if self.mapped is None:
+            resuming = hasattr(self, "file_id")
+            if not self._attach():
+                return np.empty(0, dtype=RECORD)
+            if resuming:
+                # Everything in a new writer's log is unread
+                self.restarts += 1
+                self.position = 0
+
+        published = int(self.cursor[0])
+        if published < self.position or (published == self.position and self._writer_restarted()):
+            self.mapped = None
+            return self.poll(max_records)
+
+        # Skip records the writer has lapped, including the slot it fills next
+        if published - self.position >= self.capacity:
+            self.dropped += published - self.capacity + 1 - self.position
+            self.position = published - self.capacity + 1
+
+        count = published - self.position
+        if max_records is not None:
+            count = min(count, max_records)
+        if count <= 0:
+            return np.empty(0, dtype=RECORD)
+
+        batch = self.records[(np.arange(self.position, self.position + count) & self.mask)]
+
+        # Discard slots the writer lapped while we were copying
+        after = int(self.cursor[0])
+        first_valid = after - self.capacity + 1
+        stale = min(max(0, first_valid - self.position), count)
+        self.dropped += stale
+        self.position += count
+        return batch[stale:]
+
+
+class LiveMetrics:
+    """Running metrics updated one batch at a time."""
+
+    def __init__(self):
+        self.reset()
+
+    def reset(self):
+        self.ticks = 0
+        self.peak_pnl = 0.0
+        self.max_drawdown = 0.0
+        self.last = None
+        self.times = []
+        self.pnl = []
+        # Welford accumulators over tick-to-tick PnL changes
+        self.count = 0
+        self.mean = 0.0
+        self.m2 = 0.0
+
+    def update(self, records):
+        starts = np.flatnonzero(records["type"] == EVENT_START)
+        if len(starts):
+            # A new run began: keep only what follows the latest marker
+            self.reset()
+            records = records[starts[-1] + 1:]
+
+        ticks = records[records["type"] == EVENT_TICK]
+        if len(ticks) == 0:
+            return
+
+        pnl = ticks["values"][:, 5]
+        if self.last is not None:
+            changes = np.diff(np.concatenate(([self.last["values"][5]], pnl)))
+        else:
+            changes = np.diff(pnl)
+        if len(changes):
+            # Merge the batch moments into the running ones (Chan et al.)
+            batch_mean = changes.mean()
+            batch_m2 = float(((changes - batch_mean) ** 2).sum())
+            total = self.count + len(changes)
+            delta = batch_mean - self.mean
+            self.mean += delta * len(changes) / total
+            self.m2 += batch_m2 + delta * delta * self.count * len(changes) / total
+            self.count = total
+
+        running_peak = np.maximum.accumulate(np.concatenate(([self.peak_pnl], pnl)))[1:]
+        self.peak_pnl = float(running_peak[-1])
+        self.max_drawdown = max(self.max_drawdown, float(np.max(running_peak - pnl)))
+
+        self.ticks += len(ticks)
+        self.last = ticks[-1]
+        self.times.extend(ticks["timestamp_ns"].tolist())
+        self.pnl.extend(pnl.tolist())
+
+    @property
+    def pnl_volatility(self):
+        return np.sqrt(self.m2 / self.count) if self.count > 1 else 0.0
+
+    def summary(self):
+        if self.last is None:
+            return "waiting for ticks..."
+        mark, bid, ask, position, realized, total = self.last["values"]
+        return (f"ticks={self.ticks} price={mark:.2f} bid={bid:.2f} ask={ask:.2f} "
+                f"position={position:.0f} realized={realized:.2f} pnl={total:.2f} "
+                f"max_dd={self.max_drawdown:.2f} vol={self.pnl_volatility:.4f}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Follow a running HFT simulation")
+    parser.add_argument("log", nargs="?", default="data/events.hftlog", help="Event log written by the engine")
+    parser.add_argument("--interval", type=float, default=1.0, help="Polling interval in seconds")
+    parser.add_argument("--plot", action="store_true", help="Show a live PnL chart")
+    args = parser.parse_args()
+
+    # Polling attaches once the engine has written the log header
+    follower = EventLogFollower(args.log)
+    if not follower.attached:
+        print(f"Waiting for {args.log}...")
+    metrics = LiveMetrics()
+
+    line = None
+    if args.plot:
+        import matplotlib.pyplot as plt
+        plt.ion()
+        fig, ax = plt.subplots(figsize=(12, 5))
+        line, = ax.plot([], [], color="blue", linewidth=1.5)
+        ax.set_title("Live Total PnL")
+        ax.set_xlabel("Seconds since first tick")
+        ax.set_ylabel("PnL ($)")
+        ax.grid(True, alpha=0.3)
+
+    try:
+        while True:
+            batch = follower.poll()
+            if len(batch):
+                metrics.update(batch)
+                print(metrics.summary() + (f" dropped={follower.dropped}" if follower.dropped else ""))
+
+                if line is not None and metrics.times:
+                    times = (np.asarray(metrics.times) - metrics.times[0]) / 1e9
+                    line.set_data(times, metrics.pnl)
+                    ax.relim()
+                    ax.autoscale_view()
+                    fig.canvas.draw_idle()
+            if line is not None:
+                plt.pause(args.interval)
+            else:
+                time.sleep(args.interval)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
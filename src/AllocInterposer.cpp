@@ -0,0 +1,126 @@
+// Global operator new/delete replacements feeding AllocTracker.
+//
+// Deliberately not part of hft_core: linking this file replaces allocation
+// for the whole program, so only test_basic and the benchmarks pull it in
+// (CMake object library hft_alloc_interposer).
+
+#include "AllocTracker.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+void* allocate(size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+    void* p;
+    while ((p = std::malloc(size)) == nullptr) {
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+    hft::AllocTracker::noteAllocation(size);
+    return p;
+}
+
+void* allocateAligned(size_t size, std::align_val_t alignment) {
+    size_t align = static_cast<size_t>(alignment);
+    if (size == 0) {
+        size = 1;
+    }
+    void* p = nullptr;
+    for (;;) {
+#ifdef _WIN32
+        p = _aligned_malloc(size, align);
+#else
+        if (posix_memalign(&p, align < sizeof(void*) ? sizeof(void*) : align, size) != 0) {
+            p = nullptr;
+        }
+#endif
+        if (p) {
+            break;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+    hft::AllocTracker::noteAllocation(size);
+    return p;
+}
+
+void release(void* p) {
+    if (p) {
+        hft::AllocTracker::noteDeallocation();
+        std::free(p);
+    }
+}
+
+void releaseAligned(void* p) {
+    if (p) {
+        hft::AllocTracker::noteDeallocation();
+#ifdef _WIN32
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+}
+
+const bool registered = (hft::AllocTracker::markInstalled(), true);
+
+} // namespace
+
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void* operator new(size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    try {
+        return allocateAligned(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    try {
+        return allocateAligned(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, size_t) noexcept { release(p); }
+void operator delete[](void* p, size_t) noexcept { release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(p); }
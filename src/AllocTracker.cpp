@@ -0,0 +1,53 @@
+#include "AllocTracker.h"
+#include <atomic>
+
+namespace hft {
+
+namespace {
+
+// Constant-initialized, so reading it from inside operator new never runs a
+// TLS constructor (which could itself allocate)
+thread_local AllocStats thread_stats = {0, 0, 0};
+
+std::atomic<bool> installed{false};
+std::atomic<uint64_t> violation_count{0};
+std::atomic<const char*> last_violation{nullptr};
+
+} // namespace
+
+bool AllocTracker::isInstalled() {
+    return installed.load(std::memory_order_relaxed);
+}
+
+AllocStats AllocTracker::threadStats() {
+    return thread_stats;
+}
+
+uint64_t AllocTracker::getViolationCount() {
+    return violation_count.load(std::memory_order_relaxed);
+}
+
+const char* AllocTracker::getLastViolation() {
+    return last_violation.load(std::memory_order_relaxed);
+}
+
+void AllocTracker::noteAllocation(size_t bytes) {
+    AllocStats& stats = thread_stats;
+    ++stats.allocations;
+    stats.bytes_allocated += bytes;
+}
+
+void AllocTracker::noteDeallocation() {
+    ++thread_stats.deallocations;
+}
+
+void AllocTracker::markInstalled() {
+    installed.store(true, std::memory_order_relaxed);
+}
+
+void AllocTracker::noteViolation(const char* region) {
+    last_violation.store(region, std::memory_order_relaxed);
+    violation_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace hft
@@ -0,0 +1,84 @@
+#include "Clock.h"
+#include <cstdlib>
+#include <cstring>
+
+#if HFT_CLOCK_HAS_TSC && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+namespace hft {
+
+namespace {
+
+// Spin long enough for the monotonic clock's read error to stay well
+// below 0.01% of the interval
+constexpr uint64_t CALIBRATION_NS = 20000000;
+
+int64_t wallNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+#if HFT_CLOCK_HAS_TSC
+// CPUID 0x80000007 EDX bit 8: the TSC ticks at a constant rate across
+// P-/C-states and is synchronized across cores
+bool hasInvariantTsc() {
+#ifdef _MSC_VER
+    int regs[4];
+    __cpuid(regs, 0x80000000);
+    if (static_cast<unsigned>(regs[0]) < 0x80000007u) {
+        return false;
+    }
+    __cpuid(regs, 0x80000007);
+    return (regs[3] & (1 << 8)) != 0;
+#else
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid_max(0x80000000u, nullptr) < 0x80000007u) {
+        return false;
+    }
+    __get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+#endif
+}
+#endif
+
+} // namespace
+
+Clock::Calibration Clock::calibrate() {
+    Calibration c{false, 1.0, 0, 0};
+
+    const char* forced = std::getenv("HFT_CLOCK");
+    bool allow_tsc = !(forced && std::strcmp(forced, "monotonic") == 0);
+
+#if HFT_CLOCK_HAS_TSC
+    if (allow_tsc && hasInvariantTsc()) {
+        uint64_t start_ns = monotonicNs(false);
+        uint64_t start_ticks = __rdtsc();
+        uint64_t end_ns;
+        do {
+            end_ns = monotonicNs(false);
+        } while (end_ns - start_ns < CALIBRATION_NS);
+        uint64_t end_ticks = __rdtsc();
+
+        double ns_per_tick = static_cast<double>(end_ns - start_ns) / static_cast<double>(end_ticks - start_ticks);
+        // Reject implausible rates (100 MHz - 10 GHz), e.g. a broken virtual TSC
+        if (end_ticks > start_ticks && ns_per_tick > 0.1 && ns_per_tick < 10.0) {
+            uint64_t before = __rdtsc();
+            c.anchor_wall_ns = wallNs();
+            uint64_t after = __rdtsc();
+            c.tsc = true;
+            c.ns_per_tick = ns_per_tick;
+            c.anchor_ticks = before + (after - before) / 2;
+            return c;
+        }
+    }
+#else
+    (void)allow_tsc;
+#endif
+
+    c.anchor_ticks = monotonicNs(false);
+    c.anchor_wall_ns = wallNs();
+    return c;
+}
+
+} // namespace hft
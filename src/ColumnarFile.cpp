@@ -0,0 +1,329 @@
+#include "ColumnarFile.h"
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+
+namespace hft {
+
+namespace {
+
+constexpr char COLUMNAR_MAGIC[8] = {'H', 'F', 'T', 'C', 'O', 'L', '0', '1'};
+constexpr uint64_t COLUMN_ALIGNMENT = 64;
+
+uint64_t alignUp(uint64_t value) {
+    return (value + COLUMN_ALIGNMENT - 1) & ~(COLUMN_ALIGNMENT - 1);
+}
+
+// Bytes per offset needed to hold values in [0, range]
+uint8_t widthFor(uint64_t range) {
+    if (range <= 0xFFull) return 1;
+    if (range <= 0xFFFFull) return 2;
+    if (range <= 0xFFFFFFFFull) return 4;
+    return 8;
+}
+
+// Minimum of values under the column's ordering
+uint64_t minimum(const std::vector<uint64_t>& values, bool is_signed) {
+    uint64_t result = values[0];
+    for (uint64_t v : values) {
+        bool less = is_signed ? static_cast<int64_t>(v) < static_cast<int64_t>(result) : v < result;
+        if (less) result = v;
+    }
+    return result;
+}
+
+uint64_t range(const std::vector<uint64_t>& values, uint64_t min_value) {
+    uint64_t result = 0;
+    for (uint64_t v : values) {
+        result = std::max(result, v - min_value);
+    }
+    return result;
+}
+
+void appendPacked(std::vector<char>& out, const std::vector<uint64_t>& offsets, uint8_t width) {
+    size_t start = out.size();
+    out.resize(start + offsets.size() * width);
+    char* dest = out.data() + start;
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        // Little-endian: the low `width` bytes of each offset
+        std::memcpy(dest + i * width, &offsets[i], width);
+    }
+}
+
+uint64_t readPacked(const char* src, size_t i, uint8_t width) {
+    uint64_t value = 0;
+    std::memcpy(&value, src + i * width, width);
+    return value;
+}
+
+// Whether a column entry describes data the decoders can read in full:
+// known type and codec, a supported width, and a data range inside the
+// file holding exactly the elements its codec stores for rows rows
+bool entryFits(const ColumnEntry& entry, uint64_t rows, uint64_t file_size) {
+    if (entry.type > static_cast<uint8_t>(ColumnType::INT8) ||
+        entry.codec > static_cast<uint8_t>(ColumnCodec::DELTA_FOR)) {
+        return false;
+    }
+    if (entry.width != 1 && entry.width != 2 && entry.width != 4 && entry.width != 8) {
+        return false;
+    }
+    if (entry.type == static_cast<uint8_t>(ColumnType::FLOAT64) &&
+        (entry.codec != static_cast<uint8_t>(ColumnCodec::RAW) || entry.width != sizeof(double))) {
+        return false;
+    }
+
+    // Written as subtractions so corrupt offsets and sizes cannot wrap
+    if (entry.data_offset > file_size || entry.data_size > file_size - entry.data_offset) {
+        return false;
+    }
+    uint64_t elements = rows;
+    if (entry.codec == static_cast<uint8_t>(ColumnCodec::DELTA_FOR)) {
+        elements = rows > 0 ? rows - 1 : 0;
+    }
+    return entry.data_size % entry.width == 0 && entry.data_size / entry.width == elements;
+}
+
+} // namespace
+
+void ColumnarFileWriter::addInt64(const std::string& name, const std::vector<int64_t>& values) {
+    Column column{name, ColumnType::INT64, {}};
+    column.bits.reserve(values.size());
+    for (int64_t v : values) column.bits.push_back(static_cast<uint64_t>(v));
+    columns.push_back(std::move(column));
+}
+
+void ColumnarFileWriter::addUInt64(const std::string& name, const std::vector<uint64_t>& values) {
+    columns.push_back(Column{name, ColumnType::UINT64, values});
+}
+
+void ColumnarFileWriter::addFloat64(const std::string& name, const std::vector<double>& values) {
+    Column column{name, ColumnType::FLOAT64, std::vector<uint64_t>(values.size())};
+    if (!values.empty()) {
+        std::memcpy(column.bits.data(), values.data(), values.size() * sizeof(double));
+    }
+    columns.push_back(std::move(column));
+}
+
+void ColumnarFileWriter::addInt8(const std::string& name, const std::vector<int8_t>& values) {
+    Column column{name, ColumnType::INT8, {}};
+    column.bits.reserve(values.size());
+    for (int8_t v : values) column.bits.push_back(static_cast<uint64_t>(static_cast<int64_t>(v)));
+    columns.push_back(std::move(column));
+}
+
+bool ColumnarFileWriter::write(const std::string& filename) const {
+    ColumnarFileHeader header{};
+    std::memcpy(header.magic, COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC));
+    header.version = 1;
+    header.column_count = static_cast<uint32_t>(columns.size());
+    header.row_count = rows;
+
+    std::vector<ColumnEntry> entries(columns.size());
+    std::vector<char> body;
+    uint64_t data_start = alignUp(sizeof(ColumnarFileHeader) + entries.size() * sizeof(ColumnEntry));
+
+    for (size_t c = 0; c < columns.size(); ++c) {
+        const Column& column = columns[c];
+        if (column.bits.size() != rows) {
+            return false;
+        }
+
+        ColumnEntry& entry = entries[c];
+        std::strncpy(entry.name, column.name.c_str(), sizeof(entry.name) - 1);
+        entry.type = static_cast<uint8_t>(column.type);
+        entry.codec = static_cast<uint8_t>(ColumnCodec::RAW);
+        entry.width = column.type == ColumnType::INT8 ? 1 : 8;
+
+        body.resize(alignUp(body.size()));
+        entry.data_offset = data_start + body.size();
+
+        // Pick the smallest integer encoding; ties keep the cheaper decode
+        std::vector<uint64_t> offsets;
+        if (column.type != ColumnType::FLOAT64 && rows > 0) {
+            bool is_signed = column.type != ColumnType::UINT64;
+            size_t best_bytes = rows * entry.width;
+
+            uint64_t min_value = minimum(column.bits, is_signed);
+            uint8_t for_width = widthFor(range(column.bits, min_value));
+            if (rows * for_width < best_bytes) {
+                best_bytes = rows * for_width;
+                entry.codec = static_cast<uint8_t>(ColumnCodec::FOR);
+                entry.width = for_width;
+                entry.base = static_cast<int64_t>(min_value);
+            }
+
+            if (rows > 1) {
+                std::vector<uint64_t> deltas(rows - 1);
+                for (size_t i = 1; i < rows; ++i) {
+                    deltas[i - 1] = column.bits[i] - column.bits[i - 1];
+                }
+                uint64_t min_delta = minimum(deltas, true);
+                uint8_t delta_width = widthFor(range(deltas, min_delta));
+                if ((rows - 1) * delta_width < best_bytes) {
+                    entry.codec = static_cast<uint8_t>(ColumnCodec::DELTA_FOR);
+                    entry.width = delta_width;
+                    entry.base = static_cast<int64_t>(column.bits[0]);
+                    entry.delta_base = static_cast<int64_t>(min_delta);
+                    for (auto& delta : deltas) delta -= min_delta;
+                    offsets.swap(deltas);
+                }
+            }
+
+            if (entry.codec == static_cast<uint8_t>(ColumnCodec::FOR)) {
+                offsets.resize(rows);
+                for (size_t i = 0; i < rows; ++i) {
+                    offsets[i] = column.bits[i] - min_value;
+                }
+            }
+        }
+
+        if (entry.codec == static_cast<uint8_t>(ColumnCodec::RAW)) {
+            appendPacked(body, column.bits, entry.width);
+        } else {
+            appendPacked(body, offsets, entry.width);
+        }
+        entry.data_size = body.size() - (entry.data_offset - data_start);
+    }
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::vector<char> prefix(data_start, 0);
+    std::memcpy(prefix.data(), &header, sizeof(header));
+    if (!entries.empty()) {
+        std::memcpy(prefix.data() + sizeof(header), entries.data(), entries.size() * sizeof(ColumnEntry));
+    }
+    file.write(prefix.data(), static_cast<std::streamsize>(prefix.size()));
+    file.write(body.data(), static_cast<std::streamsize>(body.size()));
+    return file.good();
+}
+
+ColumnarFileReader::ColumnarFileReader(const std::string& filename) : header{}, valid(false) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    if (data.size() < sizeof(header)) {
+        return;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC)) != 0 || header.version != 1) {
+        return;
+    }
+
+    if (header.column_count > (data.size() - sizeof(header)) / sizeof(ColumnEntry)) {
+        return;
+    }
+    entries.resize(header.column_count);
+    std::memcpy(entries.data(), data.data() + sizeof(header), entries.size() * sizeof(ColumnEntry));
+
+    // Decoders trust the entries, so a truncated or corrupt file is rejected here
+    for (const auto& entry : entries) {
+        if (!entryFits(entry, header.row_count, data.size())) {
+            return;
+        }
+    }
+    valid = true;
+}
+
+std::vector<std::string> ColumnarFileReader::getColumnNames() const {
+    std::vector<std::string> names;
+    for (const auto& entry : entries) {
+        names.emplace_back(entry.name, strnlen(entry.name, sizeof(entry.name)));
+    }
+    return names;
+}
+
+const ColumnEntry* ColumnarFileReader::findColumn(const std::string& name) const {
+    for (const auto& entry : entries) {
+        if (name == std::string(entry.name, strnlen(entry.name, sizeof(entry.name)))) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<int64_t> ColumnarFileReader::getInt64(const std::string& name) const {
+    const ColumnEntry* entry = findColumn(name);
+    if (!valid || !entry || entry->type != static_cast<uint8_t>(ColumnType::INT64)) {
+        return {};
+    }
+    std::vector<uint64_t> bits = decode(*entry);
+    return std::vector<int64_t>(bits.begin(), bits.end());
+}
+
+std::vector<uint64_t> ColumnarFileReader::getUInt64(const std::string& name) const {
+    const ColumnEntry* entry = findColumn(name);
+    if (!valid || !entry || entry->type != static_cast<uint8_t>(ColumnType::UINT64)) {
+        return {};
+    }
+    return decode(*entry);
+}
+
+std::vector<double> ColumnarFileReader::getFloat64(const std::string& name) const {
+    const ColumnEntry* entry = findColumn(name);
+    if (!valid || !entry || entry->type != static_cast<uint8_t>(ColumnType::FLOAT64)) {
+        return {};
+    }
+    std::vector<double> values(header.row_count);
+    if (!values.empty()) {
+        std::memcpy(values.data(), data.data() + entry->data_offset, values.size() * sizeof(double));
+    }
+    return values;
+}
+
+std::vector<int8_t> ColumnarFileReader::getInt8(const std::string& name) const {
+    const ColumnEntry* entry = findColumn(name);
+    if (!valid || !entry || entry->type != static_cast<uint8_t>(ColumnType::INT8)) {
+        return {};
+    }
+    std::vector<uint64_t> bits = decode(*entry);
+    std::vector<int8_t> values(bits.size());
+    for (size_t i = 0; i < bits.size(); ++i) {
+        values[i] = static_cast<int8_t>(static_cast<int64_t>(bits[i]));
+    }
+    return values;
+}
+
+std::vector<uint64_t> ColumnarFileReader::decode(const ColumnEntry& entry) const {
+    size_t rows = header.row_count;
+    const char* src = data.data() + entry.data_offset;
+    std::vector<uint64_t> values(rows);
+
+    switch (static_cast<ColumnCodec>(entry.codec)) {
+        case ColumnCodec::RAW:
+            for (size_t i = 0; i < rows; ++i) {
+                uint64_t raw = readPacked(src, i, entry.width);
+                // Sign-extend narrow signed columns
+                if (entry.width == 1 && entry.type == static_cast<uint8_t>(ColumnType::INT8)) {
+                    raw = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int8_t>(raw)));
+                }
+                values[i] = raw;
+            }
+            break;
+
+        case ColumnCodec::FOR:
+            for (size_t i = 0; i < rows; ++i) {
+                values[i] = static_cast<uint64_t>(entry.base) + readPacked(src, i, entry.width);
+            }
+            break;
+
+        case ColumnCodec::DELTA_FOR: {
+            uint64_t value = static_cast<uint64_t>(entry.base);
+            if (rows > 0) values[0] = value;
+            for (size_t i = 1; i < rows; ++i) {
+                value += static_cast<uint64_t>(entry.delta_base) + readPacked(src, i - 1, entry.width);
+                values[i] = value;
+            }
+            break;
+        }
+    }
+    return values;
+}
+
+} // namespace hft
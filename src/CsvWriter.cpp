@@ -0,0 +1,90 @@
+#include "CsvWriter.h"
+#include "TimestampFormatter.h"
+#include <cmath>
+
+namespace hft {
+
+CsvWriter::CsvWriter(const std::string& filename, size_t buffer_size)
+    : file(std::fopen(filename.c_str(), "wb")), buffer(buffer_size > MAX_FIELD_CHARS ? buffer_size : 4096),
+      used(0), row_started(false) {
+    if (file) {
+        // All output is already batched in our own buffer
+        std::setvbuf(file, nullptr, _IONBF, 0);
+    }
+}
+
+CsvWriter::~CsvWriter() {
+    close();
+}
+
+void CsvWriter::writeHeader(std::string_view header) {
+    field(header);
+    endRow();
+}
+
+void CsvWriter::timestampField(int64_t nanos_since_epoch) {
+    char* out = beginField(TimestampFormatter::MAX_LENGTH);
+    used = TimestampFormatter::format(out, nanos_since_epoch, TimestampPrecision::MICROS) - buffer.data();
+}
+
+void CsvWriter::flush() {
+    if (file && used > 0) {
+        std::fwrite(buffer.data(), 1, used, file);
+    }
+    used = 0;
+}
+
+void CsvWriter::close() {
+    if (!file) {
+        return;
+    }
+    flush();
+    std::fclose(file);
+    file = nullptr;
+}
+
+char* CsvWriter::formatDouble(char* out, double value) {
+    // In [1e-3, 1e9) two decimals with at most six fractional digits never
+    // map to the same double, so the scaled integer is exactly the shortest
+    // form, and std::to_chars would pick fixed over scientific notation
+    // (except for integers with many trailing zeros, which fall through)
+    constexpr double SCALE = 1e6;
+    double magnitude = std::abs(value);
+    if (value == 0.0) {
+        if (std::signbit(value)) *out++ = '-';
+        *out++ = '0';
+        return out;
+    }
+    if (magnitude >= 1e-3 && magnitude < 1e9) {
+        double scaled = std::nearbyint(magnitude * SCALE);
+        if (scaled / SCALE == magnitude) {
+            uint64_t fixed = static_cast<uint64_t>(scaled);
+            uint64_t whole = fixed / 1000000;
+            uint32_t fraction = static_cast<uint32_t>(fixed % 1000000);
+            if (fraction != 0 || whole % 100000 != 0) {
+                if (value < 0.0) {
+                    *out++ = '-';
+                }
+                out = std::to_chars(out, out + 24, whole).ptr;
+                if (fraction != 0) {
+                    char digits[6];
+                    for (int i = 5; i >= 0; --i) {
+                        digits[i] = static_cast<char>('0' + fraction % 10);
+                        fraction /= 10;
+                    }
+                    int length = 6;
+                    while (digits[length - 1] == '0') {
+                        --length;
+                    }
+                    *out++ = '.';
+                    std::memcpy(out, digits, length);
+                    out += length;
+                }
+                return out;
+            }
+        }
+    }
+    return std::to_chars(out, out + MAX_FIELD_CHARS, value).ptr;
+}
+
+} // namespace hft
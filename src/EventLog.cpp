@@ -0,0 +1,259 @@
+#include "EventLog.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define HFT_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace hft {
+
+namespace {
+
+constexpr char EVENT_LOG_MAGIC[8] = {'H', 'F', 'T', 'E', 'V', 'L', 'G', '1'};
+constexpr size_t CURSOR_OFFSET = 64;
+constexpr size_t RECORDS_OFFSET = 128;
+
+uint64_t roundUpPow2(uint64_t value) {
+    uint64_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+EventLogWriter::EventLogWriter(const std::string& file_path, size_t capacity_records)
+    : path(file_path), base(nullptr), mapped_bytes(0), cursor(nullptr), records(nullptr),
+      capacity(roundUpPow2(capacity_records > 0 ? capacity_records : 1)), mask(capacity - 1), next(0) {
+#ifdef HFT_HAVE_MMAP
+    // Build the log beside the path and rename it into place once the header
+    // is written: readers still mapping a previous log keep their (unlinked)
+    // file instead of faulting on a truncated one
+    std::string temp_path = path + ".tmp";
+    int fd = ::open(temp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return;
+    }
+
+    size_t bytes = RECORDS_OFFSET + capacity * sizeof(EventRecord);
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        ::close(fd);
+        unlink(temp_path.c_str());
+        return;
+    }
+    void* mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);  // The mapping keeps the file alive
+    if (mapped == MAP_FAILED) {
+        unlink(temp_path.c_str());
+        return;
+    }
+
+    base = static_cast<char*>(mapped);
+    mapped_bytes = bytes;
+
+    EventLogHeader header{};
+    std::memcpy(header.magic, EVENT_LOG_MAGIC, sizeof(EVENT_LOG_MAGIC));
+    header.version = 1;
+    header.record_size = sizeof(EventRecord);
+    header.capacity = capacity;
+    header.created_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::memcpy(base, &header, sizeof(header));
+
+    cursor = new (base + CURSOR_OFFSET) std::atomic<uint64_t>(0);
+    records = reinterpret_cast<EventRecord*>(base + RECORDS_OFFSET);
+
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        munmap(base, mapped_bytes);
+        unlink(temp_path.c_str());
+        base = nullptr;
+        mapped_bytes = 0;
+        cursor = nullptr;
+        records = nullptr;
+    }
+#endif
+}
+
+EventLogWriter::~EventLogWriter() {
+#ifdef HFT_HAVE_MMAP
+    if (base != nullptr) {
+        munmap(base, mapped_bytes);
+    }
+#endif
+}
+
+void EventLogWriter::append(EventType type, int64_t timestamp_ns, const double* values, size_t count) {
+    if (base == nullptr) {
+        return;
+    }
+
+    EventRecord record{};
+    record.timestamp_ns = timestamp_ns;
+    record.type = static_cast<uint32_t>(type);
+    std::copy(values, values + std::min<size_t>(count, 6), record.values);
+
+    std::memcpy(&records[next & mask], &record, sizeof(record));
+    ++next;
+    cursor->store(next, std::memory_order_release);
+}
+
+EventLogReader::EventLogReader(const std::string& file_path)
+    : path(file_path), base(nullptr), mapped_bytes(0), cursor(nullptr), records(nullptr),
+      capacity(0), mask(0), position(0), dropped(0), restarts(0), file_id{0, 0}, created_ns(0) {
+    attach();
+}
+
+EventLogReader::~EventLogReader() {
+    detach();
+}
+
+bool EventLogReader::attach() {
+#ifdef HFT_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < RECORDS_OFFSET) {
+        ::close(fd);
+        return false;
+    }
+    size_t bytes = static_cast<size_t>(info.st_size);
+    void* mapped = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+
+    EventLogHeader header;
+    std::memcpy(&header, mapped, sizeof(header));
+    bool valid = std::memcmp(header.magic, EVENT_LOG_MAGIC, sizeof(EVENT_LOG_MAGIC)) == 0 &&
+                 header.version == 1 && header.record_size == sizeof(EventRecord) &&
+                 header.capacity > 0 && (header.capacity & (header.capacity - 1)) == 0 &&
+                 header.capacity <= (bytes - RECORDS_OFFSET) / sizeof(EventRecord);
+    if (!valid) {
+        munmap(mapped, bytes);
+        return false;
+    }
+
+    base = static_cast<const char*>(mapped);
+    mapped_bytes = bytes;
+    capacity = header.capacity;
+    mask = capacity - 1;
+    cursor = reinterpret_cast<const std::atomic<uint64_t>*>(base + CURSOR_OFFSET);
+    records = reinterpret_cast<const EventRecord*>(base + RECORDS_OFFSET);
+    file_id[0] = static_cast<uint64_t>(info.st_dev);
+    file_id[1] = static_cast<uint64_t>(info.st_ino);
+    created_ns = header.created_ns;
+
+    uint64_t published = getWriteCursor();
+    position = published >= capacity ? published - capacity + 1 : 0;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void EventLogReader::detach() {
+#ifdef HFT_HAVE_MMAP
+    if (base != nullptr) {
+        munmap(const_cast<char*>(base), mapped_bytes);
+    }
+#endif
+    base = nullptr;
+    mapped_bytes = 0;
+    cursor = nullptr;
+    records = nullptr;
+}
+
+bool EventLogReader::writerRestarted() const {
+#ifdef HFT_HAVE_MMAP
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return false;  // Nothing to switch to (yet)
+    }
+    if (static_cast<uint64_t>(info.st_dev) != file_id[0] || static_cast<uint64_t>(info.st_ino) != file_id[1]) {
+        return true;
+    }
+    // Same file rewritten in place by a writer that does not rename
+    EventLogHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    return header.created_ns != created_ns;
+#else
+    return false;
+#endif
+}
+
+uint64_t EventLogReader::getWriteCursor() const {
+    return cursor ? cursor->load(std::memory_order_acquire) : 0;
+}
+
+size_t EventLogReader::poll(std::vector<EventRecord>& out, size_t max_records) {
+    if (base == nullptr) {
+        bool resuming = created_ns != 0;  // Attached to an earlier log before
+        if (!attach()) {
+            return 0;
+        }
+        if (resuming) {
+            // Everything in a new writer's log is unread
+            ++restarts;
+            position = 0;
+        }
+    }
+
+    uint64_t published = cursor->load(std::memory_order_acquire);
+
+    // A restarted writer shows up as a cursor behind our position, or, once
+    // the old log has gone quiet, as a different file at the path. Only an
+    // idle poll pays for the stat.
+    if (published < position || (published == position && writerRestarted())) {
+        detach();
+        return poll(out, max_records);
+    }
+
+    // Skip records the writer has lapped, including the slot it fills next
+    if (published - position >= capacity) {
+        dropped += published - capacity + 1 - position;
+        position = published - capacity + 1;
+    }
+
+    uint64_t available = std::min<uint64_t>(published - position, max_records);
+    if (available == 0) {
+        return 0;
+    }
+
+    size_t start = out.size();
+    out.resize(start + available);
+    for (uint64_t i = 0; i < available; ++i) {
+        std::memcpy(&out[start + i], &records[(position + i) & mask], sizeof(EventRecord));
+    }
+
+    // The writer may have started overwriting slots while we copied them;
+    // the record being written now is sequence `after`, which reuses the slot
+    // of sequence after - capacity
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t after = cursor->load(std::memory_order_relaxed);
+    uint64_t first_valid = after >= capacity ? after - capacity + 1 : 0;
+    if (position < first_valid) {
+        uint64_t stale = std::min<uint64_t>(first_valid - position, available);
+        out.erase(out.begin() + start, out.begin() + start + stale);
+        dropped += stale;
+        position += stale;
+        available -= stale;
+    }
+
+    position += available;
+    return available;
+}
+
+} // namespace hft
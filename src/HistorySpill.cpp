@@ -0,0 +1,215 @@
+#include "HistorySpill.h"
+#include <cstring>
+#include <cstdio>
+#include <limits>
+#include <filesystem>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define HFT_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace hft {
+
+namespace {
+
+constexpr char SPILL_MAGIC[8] = {'H', 'F', 'T', 'S', 'P', 'I', 'L', '1'};
+
+// On-disk segment header; the record count is rewritten after every append
+// so a crashed or concurrently reading process sees only complete records
+struct SegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t count;
+    int64_t min_ts;
+    int64_t max_ts;
+};
+static_assert(sizeof(SegmentHeader) <= SpillLog::HEADER_SIZE, "Spill header too large");
+
+} // namespace
+
+SpillLog::SpillLog(const std::string& dir, const std::string& log_name, size_t record_bytes,
+                   size_t records_per_segment)
+    : directory(dir), name(log_name), record_size(record_bytes),
+      segment_records(records_per_segment > 0 ? records_per_segment : 1),
+      segment_bytes(HEADER_SIZE + segment_records * record_bytes),
+      total_records(0), open(false) {
+#ifdef HFT_HAVE_MMAP
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    open = record_size >= sizeof(int64_t) && openSegment();
+#endif
+}
+
+SpillLog::~SpillLog() {
+    for (auto& segment : segments) {
+        closeSegment(segment, false);
+    }
+}
+
+bool SpillLog::append(const void* record) {
+    if (!open) {
+        return false;
+    }
+    if (segments.back().count == segment_records) {
+        sealSegment(segments.back());
+        if (!openSegment()) {
+            return false;
+        }
+    }
+
+    Segment& segment = segments.back();
+    char* dest = segment.base + HEADER_SIZE + segment.count * record_size;
+    std::memcpy(dest, record, record_size);
+
+    int64_t ts = timestampOf(dest);
+    if (segment.count == 0) {
+        segment.min_ts = ts;
+        segment.max_ts = ts;
+    } else {
+        segment.sorted = segment.sorted && ts >= segment.max_ts;
+        if (ts < segment.min_ts) segment.min_ts = ts;
+        if (ts > segment.max_ts) segment.max_ts = ts;
+    }
+    ++segment.count;
+    ++total_records;
+
+    SegmentHeader* header = reinterpret_cast<SegmentHeader*>(segment.base);
+    header->min_ts = segment.min_ts;
+    header->max_ts = segment.max_ts;
+    header->count = segment.count;
+    return true;
+}
+
+void SpillLog::clear() {
+    for (auto& segment : segments) {
+        closeSegment(segment, true);
+    }
+    segments.clear();
+    total_records = 0;
+    if (open) {
+        open = openSegment();
+    }
+}
+
+bool SpillLog::openSegment() {
+#ifdef HFT_HAVE_MMAP
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%06zu.seg", segments.size());
+    std::string path = directory + "/" + name + suffix;
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(segment_bytes)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, segment_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+
+    // Writes are sequential; let the kernel read ahead and write back lazily
+    madvise(mapped, segment_bytes, MADV_SEQUENTIAL);
+
+    SegmentHeader* header = static_cast<SegmentHeader*>(mapped);
+    std::memcpy(header->magic, SPILL_MAGIC, sizeof(SPILL_MAGIC));
+    header->version = 1;
+    header->record_size = static_cast<uint32_t>(record_size);
+    header->count = 0;
+    header->min_ts = std::numeric_limits<int64_t>::max();
+    header->max_ts = std::numeric_limits<int64_t>::min();
+
+    segments.push_back(Segment{path, fd, static_cast<char*>(mapped), 0,
+                               header->min_ts, header->max_ts, true});
+    return true;
+#else
+    return false;
+#endif
+}
+
+void SpillLog::sealSegment(Segment& segment) {
+#ifdef HFT_HAVE_MMAP
+    if (segment.base != nullptr) {
+        munmap(segment.base, segment_bytes);
+        segment.base = nullptr;
+    }
+    if (segment.fd >= 0) {
+        // Trim the unused tail so sealed files hold only written records
+        ftruncate(segment.fd, static_cast<off_t>(HEADER_SIZE + segment.count * record_size));
+        ::close(segment.fd);
+        segment.fd = -1;
+    }
+#else
+    (void)segment;
+#endif
+}
+
+void SpillLog::closeSegment(Segment& segment, bool remove_file) {
+    sealSegment(segment);
+#ifdef HFT_HAVE_MMAP
+    if (remove_file) {
+        unlink(segment.path.c_str());
+    }
+#else
+    (void)remove_file;
+#endif
+}
+
+SpillLog::SegmentReader::SegmentReader(const SpillLog& log, const Segment& segment)
+    : base(segment.base), mapped_bytes(0) {
+#ifdef HFT_HAVE_MMAP
+    if (base != nullptr) {
+        return;
+    }
+    int fd = ::open(segment.path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    size_t bytes = HEADER_SIZE + segment.count * log.record_size;
+    void* mapped = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // The mapping keeps the file alive
+    if (mapped != MAP_FAILED) {
+        base = static_cast<const char*>(mapped);
+        mapped_bytes = bytes;
+    }
+#else
+    (void)log;
+#endif
+}
+
+SpillLog::SegmentReader::~SegmentReader() {
+#ifdef HFT_HAVE_MMAP
+    if (mapped_bytes > 0) {
+        munmap(const_cast<char*>(base), mapped_bytes);
+    }
+#endif
+}
+
+int64_t SpillLog::timestampOf(const char* record) {
+    int64_t ts;
+    std::memcpy(&ts, record, sizeof(ts));
+    return ts;
+}
+
+size_t SpillLog::lowerBound(const char* base, size_t count, int64_t ts) const {
+    size_t lo = 0;
+    size_t hi = count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (timestampOf(recordAt(base, mid)) < ts) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+} // namespace hft
@@ -0,0 +1,84 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace hft {
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    max_value.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    size_t msb = index / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+    uint64_t sub = index % SUB_BUCKETS;
+    uint64_t width = uint64_t(1) << (msb - SUB_BUCKET_BITS);
+    return ((SUB_BUCKETS + sub) << (msb - SUB_BUCKET_BITS)) + width - 1;
+}
+
+double LatencyHistogram::getMean() const {
+    uint64_t n = getCount();
+    return n > 0 ? static_cast<double>(getTotal()) / n : 0.0;
+}
+
+uint64_t LatencyHistogram::getPercentile(double p) const {
+    // Bucket totals can run slightly ahead of count while writers are active
+    uint64_t total = 0;
+    for (const auto& bucket : buckets) {
+        total += bucket.load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::min(100.0, std::max(0.0, p)) / 100.0 * total));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::min(bucketUpperBound(i), getMax());
+        }
+    }
+    return getMax();
+}
+
+std::string LatencyHistogram::summary() const {
+    std::string out = "n=" + std::to_string(getCount());
+    if (getCount() == 0) {
+        return out;
+    }
+    out += " mean=" + formatNanos(getMean());
+    out += " p50=" + formatNanos(static_cast<double>(getPercentile(50.0)));
+    out += " p90=" + formatNanos(static_cast<double>(getPercentile(90.0)));
+    out += " p99=" + formatNanos(static_cast<double>(getPercentile(99.0)));
+    out += " max=" + formatNanos(static_cast<double>(getMax()));
+    return out;
+}
+
+std::string formatNanos(double ns) {
+    char buffer[32];
+    if (ns < 1e3) {
+        std::snprintf(buffer, sizeof(buffer), "%.0fns", ns);
+    } else if (ns < 1e6) {
+        std::snprintf(buffer, sizeof(buffer), "%.1fus", ns / 1e3);
+    } else if (ns < 1e9) {
+        std::snprintf(buffer, sizeof(buffer), "%.2fms", ns / 1e6);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%.2fs", ns / 1e9);
+    }
+    return buffer;
+}
+
+} // namespace hft
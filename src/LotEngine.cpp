@@ -0,0 +1,53 @@
+#include "LotEngine.h"
+#include <algorithm>
+
+namespace hft {
+
+LotEngine::LotEngine(CostBasisMethod cost_method, size_t initial_lots)
+    : lots(initial_lots), method(cost_method),
+      position(0.0), open_cost(0.0), realized_pnl(0.0) {
+}
+
+double LotEngine::applyFill(double quantity, double price) {
+    if (quantity == 0.0) {
+        return 0.0;
+    }
+
+    double open_quantity;
+    double realized = matchFill(method, lots, position, open_cost, quantity, price, open_quantity);
+    if (open_quantity != 0.0) {
+        lots.push_back(Lot{open_quantity, price});
+    }
+
+    realized_pnl += realized;
+    return realized;
+}
+
+size_t LotEngine::getOpenLotCount() const {
+    if (method == CostBasisMethod::AVERAGE_COST) {
+        return position != 0.0 ? 1 : 0;
+    }
+    return lots.size();
+}
+
+void LotEngine::reset() {
+    lots.clear();
+    position = 0.0;
+    open_cost = 0.0;
+    realized_pnl = 0.0;
+}
+
+double LotEngine::closeAgainstAverage(double& position, double& open_cost,
+                                      double& quantity, double price) {
+    double average = open_cost / position;
+    double matched = std::min(std::abs(quantity), std::abs(position));
+    double closed = position > 0.0 ? matched : -matched;
+
+    position -= closed;
+    open_cost = average * position;
+    quantity += closed;
+
+    return closed * (price - average);
+}
+
+} // namespace hft
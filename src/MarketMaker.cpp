@@ -1,4 +1,6 @@
 #include "MarketMaker.h"
+#include "Trace.h"
+#include "Clock.h"
 #include <iostream>
 #include <algorithm>
 #include <cmath>
@@ -19,6 +21,7 @@ MarketMaker::MarketMaker(std::shared_ptr<OrderBook> ob, std::shared_ptr<PriceGen
 
 void MarketMaker::runMarketMakingLoop() {
     std::cout << "Starting market making loop...\n";
+    start();
     
     while (!emergency_stop && isRunning()) {
         step();
@@ -29,6 +32,8 @@ void MarketMaker::runMarketMakingLoop() {
 }
 
 void MarketMaker::step() {
+    TraceScope trace("maker", "MarketMaker::step");
+    uint64_t tick = price_generator->getLastTickTimestamp();
     try {
         // Check risk limits first
         checkRiskLimits();
@@ -38,6 +43,11 @@ void MarketMaker::step() {
         
         // Place orders based on current market conditions
         placeOrders();
+        if (tick != 0 && tick != last_quoted_tick &&
+            (!active_buy_orders.empty() || !active_sell_orders.empty())) {
+            tick_to_quote_ns.record(Clock::toNanos(Clock::nowPrecise() - tick));
+            last_quoted_tick = tick;
+        }
         
         // Manage inventory and position
         manageInventory();
@@ -55,6 +65,7 @@ void MarketMaker::step() {
 }
 
 void MarketMaker::placeOrders() {
+    TraceScope trace("maker", "MarketMaker::placeOrders");
     // Cancel existing orders first
     cancelAllOrders();
     
@@ -73,6 +84,7 @@ void MarketMaker::placeOrders() {
 }
 
 void MarketMaker::cancelAllOrders() {
+    TraceScope trace("maker", "MarketMaker::cancelAllOrders");
     // Cancel all active buy orders
     for (uint64_t order_id : active_buy_orders) {
         order_book->cancelOrder(order_id);
@@ -163,6 +175,7 @@ bool MarketMaker::shouldReduceExposure() const {
 }
 
 void MarketMaker::checkRiskLimits() {
+    TraceScope trace("maker", "MarketMaker::checkRiskLimits");
     // Check stop loss
     if (checkStopLoss()) {
         std::cout << "Stop loss triggered!\n";
@@ -232,6 +245,7 @@ std::string MarketMaker::getStatusString() const {
     oss << "Total Orders Placed: " << total_orders_placed << "\n";
     oss << "Total Trades Executed: " << total_trades_executed << "\n";
     oss << "Emergency Stop: " << (emergency_stop ? "YES" : "NO") << "\n";
+    oss << "Tick-to-Quote Latency: " << tick_to_quote_ns.summary() << "\n";
     oss << "Risk Limit Exceeded: " << (isRiskLimitExceeded() ? "YES" : "NO") << "\n";
     
     // Current market conditions
@@ -268,10 +282,15 @@ void MarketMaker::updateConfig(const MarketMakerConfig& new_config) {
 }
 
 bool MarketMaker::isRunning() const {
-    return !emergency_stop;
+    return running.load() && !emergency_stop;
+}
+
+void MarketMaker::start() {
+    running.store(true);
 }
 
 void MarketMaker::stop() {
+    running.store(false);
     emergency_stop = true;
     cancelAllOrders();
 }
@@ -290,9 +309,16 @@ void MarketMaker::reset() {
     active_sell_orders.clear();
     trade_history.clear();
     
+    resetTickToQuoteLatency();
+    
     start_time = std::chrono::system_clock::now();
 }
 
+void MarketMaker::resetTickToQuoteLatency() {
+    tick_to_quote_ns.reset();
+    last_quoted_tick = 0;
+}
+
 void MarketMaker::placeBuyOrder(double price) {
     uint64_t order_id = order_book->addOrder(OrderSide::BUY, OrderType::LIMIT, price, config.order_size);
     if (order_id > 0) {
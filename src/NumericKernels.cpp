@@ -0,0 +1,1038 @@
+#include "NumericKernels.h"
+#include <atomic>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define HFT_X86_KERNELS 1
+#include <immintrin.h>
+#define HFT_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace hft {
+namespace kernels {
+
+namespace {
+
+// Leaves of the pairwise summation tree. Large enough that the recursion
+// and the indirect leaf call are noise, small enough that each lane only
+// accumulates a few dozen terms sequentially.
+constexpr size_t PAIRWISE_BLOCK = 512;
+
+CrossMoments operator+(const CrossMoments& a, const CrossMoments& b) {
+    return {a.sxx + b.sxx, a.syy + b.syy, a.sxy + b.sxy};
+}
+
+// Split in two (keeping the left half a multiple of 8 so vector loops stay
+// on full registers) until the pieces fit a leaf
+template<typename Result, typename Leaf>
+Result pairwise(size_t begin, size_t n, const Leaf& leaf) {
+    if (n <= PAIRWISE_BLOCK) {
+        return leaf(begin, n);
+    }
+    size_t half = (n / 2 + 7) & ~static_cast<size_t>(7);
+    return pairwise<Result>(begin, half, leaf) + pairwise<Result>(begin + half, n - half, leaf);
+}
+
+struct KernelTable {
+    Isa isa;
+    double (*sum_leaf)(const double*, size_t);
+    double (*ssd_leaf)(const double*, size_t, double);
+    double (*dot_leaf)(const double*, const double*, size_t);
+    CrossMoments (*cross_leaf)(const double*, const double*, size_t, double, double);
+    double (*max_drawdown)(const double*, size_t);
+    void (*linear_scan)(const double*, size_t, double, double, double*);
+    void (*window_stat)(WindowStat, const double*, size_t, size_t, double, double, double, double, double*);
+    void (*window_correlation)(const double*, const double*, size_t, size_t, double, double,
+                               const WindowSums&, double*);
+};
+
+// Scalar
+
+double sumScalar(const double* d, size_t n) {
+    double s = 0.0;
+    for (size_t i = 0; i < n; ++i) s += d[i];
+    return s;
+}
+
+double ssdScalar(const double* d, size_t n, double c) {
+    double s = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double e = d[i] - c;
+        s += e * e;
+    }
+    return s;
+}
+
+double dotScalar(const double* x, const double* y, size_t n) {
+    double s = 0.0;
+    for (size_t i = 0; i < n; ++i) s += x[i] * y[i];
+    return s;
+}
+
+CrossMoments crossScalar(const double* x, const double* y, size_t n, double mx, double my) {
+    CrossMoments m{0.0, 0.0, 0.0};
+    for (size_t i = 0; i < n; ++i) {
+        double dx = x[i] - mx;
+        double dy = y[i] - my;
+        m.sxx += dx * dx;
+        m.syy += dy * dy;
+        m.sxy += dx * dy;
+    }
+    return m;
+}
+
+// Continues a drawdown scan from `peak`/`dd` over d[0, n)
+double drawdownTail(const double* d, size_t n, double peak, double dd) {
+    for (size_t i = 0; i < n; ++i) {
+        peak = d[i] > peak ? d[i] : peak;
+        double drop = peak - d[i];
+        dd = drop > dd ? drop : dd;
+    }
+    return dd;
+}
+
+double maxDrawdownScalar(const double* d, size_t n) {
+    return n > 0 ? drawdownTail(d, n, d[0], 0.0) : 0.0;
+}
+
+void linearScanScalar(const double* in, size_t n, double decay, double prev, double* out) {
+    for (size_t i = 0; i < n; ++i) {
+        prev = decay * prev + in[i];
+        out[i] = prev;
+    }
+}
+
+// Sliding-window statistic of one window from its shifted sums
+template<WindowStat STAT>
+double windowStatValue(double k, double s1, double s2, double last, double inv, double inv_denom) {
+    if constexpr (STAT == WindowStat::MEAN) {
+        return k + s1 * inv;
+    } else if constexpr (STAT == WindowStat::ZSCORE) {
+        double mean = s1 * inv;
+        double var = s2 * inv - mean * mean;
+        return var > 0.0 ? (last - k - mean) / std::sqrt(var) : 0.0;
+    } else {
+        double m2 = s2 - s1 * s1 * inv;
+        double var = m2 > 0.0 ? m2 * inv_denom : 0.0;
+        return STAT == WindowStat::STDDEV ? std::sqrt(var) : var;
+    }
+}
+
+// Continues windowStat from output `begin` (>= 1) given the sums of output begin - 1
+template<WindowStat STAT>
+void windowStatTail(const double* x, size_t begin, size_t count, size_t window, double k,
+                    double s1, double s2, double inv, double inv_denom, double* out) {
+    const double* x_in = x + window - 1;
+    for (size_t j = begin; j < count; ++j) {
+        double in = x_in[j] - k;
+        double old = x[j - 1] - k;
+        s1 += in - old;
+        s2 += in * in - old * old;
+        out[j] = windowStatValue<STAT>(k, s1, s2, x_in[j], inv, inv_denom);
+    }
+}
+
+template<WindowStat STAT>
+void windowStatScalarT(const double* x, size_t count, size_t window, double k,
+                       double s1, double s2, double inv_denom, double* out) {
+    double inv = 1.0 / static_cast<double>(window);
+    out[0] = windowStatValue<STAT>(k, s1, s2, x[window - 1], inv, inv_denom);
+    windowStatTail<STAT>(x, 1, count, window, k, s1, s2, inv, inv_denom, out);
+}
+
+void windowStatScalar(WindowStat stat, const double* x, size_t count, size_t window, double k,
+                      double s1, double s2, double inv_denom, double* out) {
+    switch (stat) {
+        case WindowStat::MEAN: return windowStatScalarT<WindowStat::MEAN>(x, count, window, k, s1, s2, inv_denom, out);
+        case WindowStat::VARIANCE: return windowStatScalarT<WindowStat::VARIANCE>(x, count, window, k, s1, s2, inv_denom, out);
+        case WindowStat::STDDEV: return windowStatScalarT<WindowStat::STDDEV>(x, count, window, k, s1, s2, inv_denom, out);
+        case WindowStat::ZSCORE: return windowStatScalarT<WindowStat::ZSCORE>(x, count, window, k, s1, s2, inv_denom, out);
+    }
+}
+
+double correlationValue(const WindowSums& s, double inv) {
+    double vx = s.sxx - s.sx * s.sx * inv;
+    double vy = s.syy - s.sy * s.sy * inv;
+    double denom = vx > 0.0 && vy > 0.0 ? std::sqrt(vx * vy) : 0.0;
+    return denom > 0.0 ? (s.sxy - s.sx * s.sy * inv) / denom : 0.0;
+}
+
+void windowCorrelationTail(const double* x, const double* y, size_t begin, size_t count, size_t window,
+                           double kx, double ky, WindowSums s, double inv, double* out) {
+    const double* x_in = x + window - 1;
+    const double* y_in = y + window - 1;
+    for (size_t j = begin; j < count; ++j) {
+        double in_x = x_in[j] - kx;
+        double in_y = y_in[j] - ky;
+        double old_x = x[j - 1] - kx;
+        double old_y = y[j - 1] - ky;
+        s.sx += in_x - old_x;
+        s.sy += in_y - old_y;
+        s.sxx += in_x * in_x - old_x * old_x;
+        s.syy += in_y * in_y - old_y * old_y;
+        s.sxy += in_x * in_y - old_x * old_y;
+        out[j] = correlationValue(s, inv);
+    }
+}
+
+void windowCorrelationScalar(const double* x, const double* y, size_t count, size_t window,
+                             double kx, double ky, const WindowSums& first, double* out) {
+    double inv = 1.0 / static_cast<double>(window);
+    out[0] = correlationValue(first, inv);
+    windowCorrelationTail(x, y, 1, count, window, kx, ky, first, inv, out);
+}
+
+#ifdef HFT_X86_KERNELS
+
+// SSE4: two lanes, two accumulators
+
+HFT_TARGET("sse4.2") double hsum128(__m128d v) {
+    return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+}
+
+HFT_TARGET("sse4.2") double sumSse4(const double* d, size_t n) {
+    __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        a0 = _mm_add_pd(a0, _mm_loadu_pd(d + i));
+        a1 = _mm_add_pd(a1, _mm_loadu_pd(d + i + 2));
+    }
+    double s = hsum128(_mm_add_pd(a0, a1));
+    for (; i < n; ++i) s += d[i];
+    return s;
+}
+
+HFT_TARGET("sse4.2") double ssdSse4(const double* d, size_t n, double c) {
+    __m128d vc = _mm_set1_pd(c);
+    __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128d e0 = _mm_sub_pd(_mm_loadu_pd(d + i), vc);
+        __m128d e1 = _mm_sub_pd(_mm_loadu_pd(d + i + 2), vc);
+        a0 = _mm_add_pd(a0, _mm_mul_pd(e0, e0));
+        a1 = _mm_add_pd(a1, _mm_mul_pd(e1, e1));
+    }
+    double s = hsum128(_mm_add_pd(a0, a1));
+    for (; i < n; ++i) s += (d[i] - c) * (d[i] - c);
+    return s;
+}
+
+HFT_TARGET("sse4.2") double dotSse4(const double* x, const double* y, size_t n) {
+    __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        a0 = _mm_add_pd(a0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+        a1 = _mm_add_pd(a1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2)));
+    }
+    double s = hsum128(_mm_add_pd(a0, a1));
+    for (; i < n; ++i) s += x[i] * y[i];
+    return s;
+}
+
+HFT_TARGET("sse4.2") CrossMoments crossSse4(const double* x, const double* y, size_t n, double mx, double my) {
+    __m128d vmx = _mm_set1_pd(mx), vmy = _mm_set1_pd(my);
+    __m128d sxx = _mm_setzero_pd(), syy = _mm_setzero_pd(), sxy = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d dx = _mm_sub_pd(_mm_loadu_pd(x + i), vmx);
+        __m128d dy = _mm_sub_pd(_mm_loadu_pd(y + i), vmy);
+        sxx = _mm_add_pd(sxx, _mm_mul_pd(dx, dx));
+        syy = _mm_add_pd(syy, _mm_mul_pd(dy, dy));
+        sxy = _mm_add_pd(sxy, _mm_mul_pd(dx, dy));
+    }
+    CrossMoments m{hsum128(sxx), hsum128(syy), hsum128(sxy)};
+    return m + crossScalar(x + i, y + i, n - i, mx, my);
+}
+
+// Drawdown: an in-register prefix max of each vector does not depend on the
+// running peak, so only one max per vector sits on the loop-carried chain
+HFT_TARGET("sse4.2") double maxDrawdownSse4(const double* d, size_t n) {
+    if (n < 2) return 0.0;
+    const __m128d neg_inf = _mm_set1_pd(-std::numeric_limits<double>::infinity());
+    __m128d peak = _mm_set1_pd(d[0]);
+    __m128d dd = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d v = _mm_loadu_pd(d + i);
+        __m128d scan = _mm_max_pd(v, _mm_unpacklo_pd(neg_inf, v));  // [v0, max(v0, v1)]
+        __m128d running = _mm_max_pd(scan, peak);
+        dd = _mm_max_pd(dd, _mm_sub_pd(running, v));
+        peak = _mm_max_pd(peak, _mm_unpackhi_pd(scan, scan));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, dd);
+    return drawdownTail(d + i, n - i, _mm_cvtsd_f64(peak), lanes[0] > lanes[1] ? lanes[0] : lanes[1]);
+}
+
+// Scan: lane j becomes sum over k <= j of decay^(j-k) * v[k], then the
+// previous register's last lane enters with decay^(j+1)
+HFT_TARGET("sse4.2") void linearScanSse4(const double* in, size_t n, double decay, double prev, double* out) {
+    const __m128d d1 = _mm_set1_pd(decay);
+    const __m128d carry_pow = _mm_set_pd(decay * decay, decay);
+    __m128d carry = _mm_set1_pd(prev);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d v = _mm_loadu_pd(in + i);
+        __m128d scan = _mm_add_pd(v, _mm_mul_pd(d1, _mm_unpacklo_pd(_mm_setzero_pd(), v)));  // [v0, v1 + d*v0]
+        scan = _mm_add_pd(scan, _mm_mul_pd(carry_pow, carry));
+        _mm_storeu_pd(out + i, scan);
+        carry = _mm_unpackhi_pd(scan, scan);
+    }
+    linearScanScalar(in + i, n - i, decay, _mm_cvtsd_f64(carry), out + i);
+}
+
+// Sliding windows: each lane's entering-minus-leaving delta is independent;
+// prefix-summing the lanes and adding the previous register's last sums
+// gives every lane's running sums, and the statistic is finished in
+// registers. The per-ISA versions differ only in width.
+HFT_TARGET("sse4.2") __m128d scan128(__m128d v) {
+    return _mm_add_pd(v, _mm_unpacklo_pd(_mm_setzero_pd(), v));
+}
+
+template<WindowStat STAT>
+HFT_TARGET("sse4.2") __m128d windowStatSse4Value(__m128d k, __m128d s1, __m128d s2, __m128d last,
+                                                 __m128d inv, __m128d inv_denom) {
+    const __m128d zero = _mm_setzero_pd();
+    if constexpr (STAT == WindowStat::MEAN) {
+        return _mm_add_pd(k, _mm_mul_pd(s1, inv));
+    } else if constexpr (STAT == WindowStat::ZSCORE) {
+        __m128d mean = _mm_mul_pd(s1, inv);
+        __m128d var = _mm_sub_pd(_mm_mul_pd(s2, inv), _mm_mul_pd(mean, mean));
+        __m128d z = _mm_div_pd(_mm_sub_pd(_mm_sub_pd(last, k), mean), _mm_sqrt_pd(var));
+        return _mm_and_pd(_mm_cmpgt_pd(var, zero), z);
+    } else {
+        __m128d m2 = _mm_sub_pd(s2, _mm_mul_pd(_mm_mul_pd(s1, s1), inv));
+        __m128d var = _mm_and_pd(_mm_cmpgt_pd(m2, zero), _mm_mul_pd(m2, inv_denom));
+        return STAT == WindowStat::STDDEV ? _mm_sqrt_pd(var) : var;
+    }
+}
+
+template<WindowStat STAT>
+HFT_TARGET("sse4.2") void windowStatSse4T(const double* x, size_t count, size_t window, double k,
+                                          double s1, double s2, double inv_denom, double* out) {
+    double inv = 1.0 / static_cast<double>(window);
+    out[0] = windowStatValue<STAT>(k, s1, s2, x[window - 1], inv, inv_denom);
+    const double* x_in = x + window - 1;
+    const __m128d vk = _mm_set1_pd(k), vinv = _mm_set1_pd(inv), vden = _mm_set1_pd(inv_denom);
+    __m128d c1 = _mm_set1_pd(s1), c2 = _mm_set1_pd(s2);
+    size_t j = 1;
+    for (; j + 2 <= count; j += 2) {
+        __m128d last = _mm_loadu_pd(x_in + j);
+        __m128d in = _mm_sub_pd(last, vk);
+        __m128d old = _mm_sub_pd(_mm_loadu_pd(x + j - 1), vk);
+        c1 = _mm_add_pd(scan128(_mm_sub_pd(in, old)), c1);
+        if constexpr (STAT != WindowStat::MEAN) {
+            c2 = _mm_add_pd(scan128(_mm_sub_pd(_mm_mul_pd(in, in), _mm_mul_pd(old, old))), c2);
+        }
+        _mm_storeu_pd(out + j, windowStatSse4Value<STAT>(vk, c1, c2, last, vinv, vden));
+        c1 = _mm_unpackhi_pd(c1, c1);
+        c2 = _mm_unpackhi_pd(c2, c2);
+    }
+    windowStatTail<STAT>(x, j, count, window, k, _mm_cvtsd_f64(c1), _mm_cvtsd_f64(c2), inv, inv_denom, out);
+}
+
+HFT_TARGET("sse4.2") void windowStatSse4(WindowStat stat, const double* x, size_t count, size_t window, double k,
+                                         double s1, double s2, double inv_denom, double* out) {
+    switch (stat) {
+        case WindowStat::MEAN: return windowStatSse4T<WindowStat::MEAN>(x, count, window, k, s1, s2, inv_denom, out);
+        case WindowStat::VARIANCE: return windowStatSse4T<WindowStat::VARIANCE>(x, count, window, k, s1, s2, inv_denom, out);
+        case WindowStat::STDDEV: return windowStatSse4T<WindowStat::STDDEV>(x, count, window, k, s1, s2, inv_denom, out);
+        case WindowStat::ZSCORE: return windowStatSse4T<WindowStat::ZSCORE>(x, count, window, k, s1, s2, inv_denom, out);
+    }
+}
+
+HFT_TARGET("sse4.2") void windowCorrelationSse4(const double* x, const double* y, size_t count, size_t window,
+                                                double kx, double ky, const WindowSums& first, double* out) {
+    double inv = 1.0 / static_cast<double>(window);
+    out[0] = correlationValue(first, inv);
+    const double* x_in = x + window - 1;
+    const double* y_in = y + window - 1;
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d vkx = _mm_set1_pd(kx), vky = _mm_set1_pd(ky), vinv = _mm_set1_pd(inv);
+    __m128d sx = _mm_set1_pd(first.sx), sy = _mm_set1_pd(first.sy);
+    __m128d sxx = _mm_set1_pd(first.sxx), syy = _mm_set1_pd(first.syy), sxy = _mm_set1_pd(first.sxy);
+    size_t j = 1;
+    for (; j + 2 <= count; j += 2) {
+        __m128d in_x = _mm_sub_pd(_mm_loadu_pd(x_in + j), vkx);
+        __m128d in_y = _mm_sub_pd(_mm_loadu_pd(y_in + j), vky);
+        __m128d old_x = _mm_sub_pd(_mm_loadu_pd(x + j - 1), vkx);
+        __m128d old_y = _mm_sub_pd(_mm_loadu_pd(y + j - 1), vky);
+        sx = _mm_add_pd(scan128(_mm_sub_pd(in_x, old_x)), sx);
+        sy = _mm_add_pd(scan128(_mm_sub_pd(in_y, old_y)), sy);
+        sxx = _mm_add_pd(scan128(_mm_sub_pd(_mm_mul_pd(in_x, in_x), _mm_mul_pd(old_x, old_x))), sxx);
+        syy = _mm_add_pd(scan128(_mm_sub_pd(_mm_mul_pd(in_y, in_y), _mm_mul_pd(old_y, old_y))), syy);
+        sxy = _mm_add_pd(scan128(_mm_sub_pd(_mm_mul_pd(in_x, in_y), _mm_mul_pd(old_x, old_y))), sxy);
+
+        __m128d vx = _mm_sub_pd(sxx, _mm_mul_pd(_mm_mul_pd(sx, sx), vinv));
+        __m128d vy = _mm_sub_pd(syy, _mm_mul_pd(_mm_mul_pd(sy, sy), vinv));
+        __m128d denom = _mm_sqrt_pd(_mm_mul_pd(vx, vy));
+        __m128d valid = _mm_and_pd(_mm_and_pd(_mm_cmpgt_pd(vx, zero), _mm_cmpgt_pd(vy, zero)),
+                                   _mm_cmpgt_pd(denom, zero));
+        __m128d cov = _mm_sub_pd(sxy, _mm_mul_pd(_mm_mul_pd(sx, sy), vinv));
+        _mm_storeu_pd(out + j, _mm_and_pd(valid, _mm_div_pd(cov, denom)));
+
+        sx = _mm_unpackhi_pd(sx, sx);
+        sy = _mm_unpackhi_pd(sy, sy);
+        sxx = _mm_unpackhi_pd(sxx, sxx);
+        syy = _mm_unpackhi_pd(syy, syy);
+        sxy = _mm_unpackhi_pd(sxy, sxy);
+    }
+    WindowSums last{_mm_cvtsd_f64(sx), _mm_cvtsd_f64(sy), _mm_cvtsd_f64(sxx), _mm_cvtsd_f64(syy), _mm_cvtsd_f64(sxy)};
+    windowCorrelationTail(x, y, j, count, window, kx, ky, last, inv, out);
+}
+
+// AVX2: four lanes, four accumulators
+
+HFT_TARGET("avx2") double hsum256(__m256d v) {
+    __m128d lo = _mm256_castpd256_pd128(v);
+    __m128d hi = _mm256_extractf128_pd(v, 1);
+    lo = _mm_add_pd(lo, hi);
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+HFT_TARGET("avx2") double hmax256(__m256d v) {
+    __m128d lo = _mm_max_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_max_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+HFT_TARGET("avx2") double sumAvx2(const double* d, size_t n) {
+    __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+    __m256d a2 = _mm256_setzero_pd(), a3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        a0 = _mm256_add_pd(a0, _mm256_loadu_pd(d + i));
+        a1 = _mm256_add_pd(a1, _mm256_loadu_pd(d + i + 4));
+        a2 = _mm256_add_pd(a2, _mm256_loadu_pd(d + i + 8));
+        a3 = _mm256_add_pd(a3, _mm256_loadu_pd(d + i + 12));
+    }
+    for (; i + 4 <= n; i += 4) {
+        a0 = _mm256_add_pd(a0, _mm256_loadu_pd(d + i));
+    }
+    double s = hsum256(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+    for (; i < n; ++i) s += d[i];
+    return s;
+}
+
+HFT_TARGET("avx2") double ssdAvx2(const double* d, size_t n, double c) {
+    __m256d vc = _mm256_set1_pd(c);
+    __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+    __m256d a2 = _mm256_setzero_pd(), a3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256d e0 = _mm256_sub_pd(_mm256_loadu_pd(d + i), vc);
+        __m256d e1 = _mm256_sub_pd(_mm256_loadu_pd(d + i + 4), vc);
+        __m256d e2 = _mm256_sub_pd(_mm256_loadu_pd(d + i + 8), vc);
+        __m256d e3 = _mm256_sub_pd(_mm256_loadu_pd(d + i + 12), vc);
+        a0 = _mm256_add_pd(a0, _mm256_mul_pd(e0, e0));
+        a1 = _mm256_add_pd(a1, _mm256_mul_pd(e1, e1));
+        a2 = _mm256_add_pd(a2, _mm256_mul_pd(e2, e2));
+        a3 = _mm256_add_pd(a3, _mm256_mul_pd(e3, e3));
+    }
+    for (; i + 4 <= n; i += 4) {
+        __m256d e = _mm256_sub_pd(_mm256_loadu_pd(d + i), vc);
+        a0 = _mm256_add_pd(a0, _mm256_mul_pd(e, e));
+    }
+    double s = hsum256(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+    for (; i < n; ++i) s += (d[i] - c) * (d[i] - c);
+    return s;
+}
+
+HFT_TARGET("avx2") double dotAvx2(const double* x, const double* y, size_t n) {
+    __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+    __m256d a2 = _mm256_setzero_pd(), a3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        a0 = _mm256_add_pd(a0, _mm256_mul_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+        a1 = _mm256_add_pd(a1, _mm256_mul_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4)));
+        a2 = _mm256_add_pd(a2, _mm256_mul_pd(_mm256_loadu_pd(x + i + 8), _mm256_loadu_pd(y + i + 8)));
+        a3 = _mm256_add_pd(a3, _mm256_mul_pd(_mm256_loadu_pd(x + i + 12), _mm256_loadu_pd(y + i + 12)));
+    }
+    for (; i + 4 <= n; i += 4) {
+        a0 = _mm256_add_pd(a0, _mm256_mul_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+    }
+    double s = hsum256(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+    for (; i < n; ++i) s += x[i] * y[i];
+    return s;
+}
+
+HFT_TARGET("avx2") CrossMoments crossAvx2(const double* x, const double* y, size_t n, double mx, double my) {
+    __m256d vmx = _mm256_set1_pd(mx), vmy = _mm256_set1_pd(my);
+    __m256d sxx0 = _mm256_setzero_pd(), syy0 = _mm256_setzero_pd(), sxy0 = _mm256_setzero_pd();
+    __m256d sxx1 = _mm256_setzero_pd(), syy1 = _mm256_setzero_pd(), sxy1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d dx0 = _mm256_sub_pd(_mm256_loadu_pd(x + i), vmx);
+        __m256d dy0 = _mm256_sub_pd(_mm256_loadu_pd(y + i), vmy);
+        __m256d dx1 = _mm256_sub_pd(_mm256_loadu_pd(x + i + 4), vmx);
+        __m256d dy1 = _mm256_sub_pd(_mm256_loadu_pd(y + i + 4), vmy);
+        sxx0 = _mm256_add_pd(sxx0, _mm256_mul_pd(dx0, dx0));
+        syy0 = _mm256_add_pd(syy0, _mm256_mul_pd(dy0, dy0));
+        sxy0 = _mm256_add_pd(sxy0, _mm256_mul_pd(dx0, dy0));
+        sxx1 = _mm256_add_pd(sxx1, _mm256_mul_pd(dx1, dx1));
+        syy1 = _mm256_add_pd(syy1, _mm256_mul_pd(dy1, dy1));
+        sxy1 = _mm256_add_pd(sxy1, _mm256_mul_pd(dx1, dy1));
+    }
+    CrossMoments m{hsum256(_mm256_add_pd(sxx0, sxx1)),
+                   hsum256(_mm256_add_pd(syy0, syy1)),
+                   hsum256(_mm256_add_pd(sxy0, sxy1))};
+    return m + crossScalar(x + i, y + i, n - i, mx, my);
+}
+
+HFT_TARGET("avx2") double maxDrawdownAvx2(const double* d, size_t n) {
+    if (n < 2) return 0.0;
+    const __m256d neg_inf = _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+    __m256d peak = _mm256_set1_pd(d[0]);
+    __m256d dd = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_loadu_pd(d + i);
+        // Prefix max in two shift-and-max steps: lanes shifted up by 1, then by 2
+        __m256d t = _mm256_blend_pd(_mm256_permute4x64_pd(v, _MM_SHUFFLE(2, 1, 0, 0)), neg_inf, 0x1);
+        __m256d scan = _mm256_max_pd(v, t);
+        t = _mm256_blend_pd(_mm256_permute4x64_pd(scan, _MM_SHUFFLE(1, 0, 0, 0)), neg_inf, 0x3);
+        scan = _mm256_max_pd(scan, t);
+
+        __m256d running = _mm256_max_pd(scan, peak);
+        dd = _mm256_max_pd(dd, _mm256_sub_pd(running, v));
+        peak = _mm256_max_pd(peak, _mm256_permute4x64_pd(scan, _MM_SHUFFLE(3, 3, 3, 3)));
+    }
+    return drawdownTail(d + i, n - i, _mm256_cvtsd_f64(peak), hmax256(dd));
+}
+
+HFT_TARGET("avx2") void linearScanAvx2(const double* in, size_t n, double decay, double prev, double* out) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d d1 = _mm256_set1_pd(decay);
+    const __m256d d2 = _mm256_set1_pd(decay * decay);
+    const __m256d carry_pow = _mm256_set_pd(decay * decay * decay * decay, decay * decay * decay, decay * decay, decay);
+    __m256d carry = _mm256_set1_pd(prev);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_loadu_pd(in + i);
+        // Shift lanes up by 1, then by 2, with zeros shifted in
+        __m256d t = _mm256_blend_pd(_mm256_permute4x64_pd(v, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x1);
+        __m256d scan = _mm256_add_pd(v, _mm256_mul_pd(d1, t));
+        t = _mm256_blend_pd(_mm256_permute4x64_pd(scan, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x3);
+        scan = _mm256_add_pd(scan, _mm256_mul_pd(d2, t));
+
+        scan = _mm256_add_pd(scan, _mm256_mul_pd(carry_pow, carry));
+        _mm256_storeu_pd(out + i, scan);
+        carry = _mm256_permute4x64_pd(scan, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    linearScanScalar(in + i, n - i, decay, _mm256_cvtsd_f64(carry), out + i);
+}
+
+HFT_TARGET("avx2") __m256d scan256(__m256d v) {
+    const __m256d zero = _mm256_setzero_pd();
+    v = _mm256_add_pd(v, _mm256_blend_pd(_mm256_permute4x64_pd(v, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x1));
+    return _mm256_add_pd(v, _mm256_blend_pd(_mm256_permute4x64_pd(v, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x3));
+}
+
+HFT_TARGET("avx2") __m256d lastLane256(__m256d v) {
+    return _mm256_permute4x64_pd(v, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+template<WindowStat STAT>
+HFT_TARGET("avx2") __m256d windowStatAvx2Value(__m256d k, __m256d s1, __m256d s2, __m256d last,
+                                               __m256d inv, __m256d inv_denom) {
+    const __m256d zero = _mm256_setzero_pd();
+    if constexpr (STAT == WindowStat::MEAN) {
+        return _mm256_add_pd(k, _mm256_mul_pd(s1, inv));
+    } else if constexpr (STAT == WindowStat::ZSCORE) {
+        __m256d mean = _mm256_mul_pd(s1, inv);
+        __m256d var = _mm256_sub_pd(_mm256_mul_pd(s2, inv), _mm256_mul_pd(mean, mean));
+        __m256d z = _mm256_div_pd(_mm256_sub_pd(_mm256_sub_pd(last, k), mean), _mm256_sqrt_pd(var));
+        return _mm256_and_pd(_mm256_cmp_pd(var, zero, _CMP_GT_OQ), z);
+    } else {
+        __m256d m2 = _mm256_sub_pd(s2, _mm256_mul_pd(_mm256_mul_pd(s1, s1), inv));
+        __m256d var = _mm256_and_pd(_mm256_cmp_pd(m2, zero, _CMP_GT_OQ), _mm256_mul_pd(m2, inv_denom));
+        return STAT == WindowStat::STDDEV ? _mm256_sqrt_pd(var) : var;
+    }
+}
+
+template<WindowStat STAT>
+HFT_TARGET("avx2") void windowStatAvx2T(const double* x, size_t count, size_t window, double k,
+                                        double s1, double s2, double inv_denom, double* out) {
+    double inv = 1.0 / static_cast<double>(window);
+    out[0] = windowStatValue<STAT>(k, s1, s2, x[window - 1], inv, inv_denom);
+    const double* x_in = x + window - 1;
+    const __m256d vk = _mm256_set1_pd(k), vinv = _mm256_set1_pd(inv), vden = _mm256_set1_pd(inv_denom);
+    __m256d c1 = _mm256_set1_pd(s1), c2 = _mm256_set1_pd(s2);
+    size_t j = 1;
+    for (; j + 4 <= count; j += 4) {
+        __m256d last = _mm256_loadu_pd(x_in + j);
+        __m256d in = _mm256_sub_pd(last, vk);
+        __m256d old = _mm256_sub_pd(_mm256_loadu_pd(x + j - 1), vk);
+        c1 = _mm256_add_pd(scan256(_mm256_sub_pd(in, old)), c1);
+        if constexpr (STAT != WindowStat::MEAN) {
+            c2 = _mm256_add_pd(scan256(_mm256_sub_pd(_mm256_mul_pd(in, in), _mm256_mul_pd(old, old))), c2);
+        }
+        _mm256_storeu_pd(out + j, windowStatAvx2Value<STAT>(vk, c1, c2, last, vinv, vden));
+        c1 = lastLane256(c1);
+        c2 = lastLane256(c2);
+    }
+    windowStatTail<STAT>(x, j, count, window, k, _mm256_cvtsd_f64(c1), _mm256_cvtsd_f64(c2), inv, inv_denom, out);
+}
+
+HFT_TARGET("avx2") void windowStatAvx2(WindowStat stat, const double* x, size_t count, size_t window, double k,
+                                       double s1, double s2, double inv_denom, double* out) {
+    switch (stat) {
+        case WindowStat::MEAN: return windowStatAvx2T<WindowStat::MEAN>(x, count, window, k, s1, s2, inv_denom, out);
+        case WindowStat::VARIANCE: return windowStatAvx2T<WindowStat::VARIANCE>(x, count, window, k, s1, s2, inv_denom, out);
+        case WindowStat::STDDEV: return windowStatAvx2T<WindowStat::STDDEV>(x, count, window, k, s1, s2, inv_denom, out);
+        case WindowStat::ZSCORE: return windowStatAvx2T<WindowStat::ZSCORE>(x, count, window, k, s1, s2, inv_denom, out);
+    }
+}
+
+HFT_TARGET("avx2") void windowCorrelationAvx2(const double* x, const double* y, size_t count, size_t window,
+                                              double kx, double ky, const WindowSums& first, double* out) {
+    double inv = 1.0 / static_cast<double>(window);
+    out[0] = correlationValue(first, inv);
+    const double* x_in = x + window - 1;
+    const double* y_in = y + window - 1;
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d vkx = _mm256_set1_pd(kx), vky = _mm256_set1_pd(ky), vinv = _mm256_set1_pd(inv);
+    __m256d sx = _mm256_set1_pd(first.sx), sy = _mm256_set1_pd(first.sy);
+    __m256d sxx = _mm256_set1_pd(first.sxx), syy = _mm256_set1_pd(first.syy), sxy = _mm256_set1_pd(first.sxy);
+    size_t j = 1;
+    for (; j + 4 <= count; j += 4) {
+        __m256d in_x = _mm256_sub_pd(_mm256_loadu_pd(x_in + j), vkx);
+        __m256d in_y = _mm256_sub_pd(_mm256_loadu_pd(y_in + j), vky);
+        __m256d old_x = _mm256_sub_pd(_mm256_loadu_pd(x + j - 1), vkx);
+        __m256d old_y = _mm256_sub_pd(_mm256_loadu_pd(y + j - 1), vky);
+        sx = _mm256_add_pd(scan256(_mm256_sub_pd(in_x, old_x)), sx);
+        sy = _mm256_add_pd(scan256(_mm256_sub_pd(in_y, old_y)), sy);
+        sxx = _mm256_add_pd(scan256(_mm256_sub_pd(_mm256_mul_pd(in_x, in_x), _mm256_mul_pd(old_x, old_x))), sxx);
+        syy = _mm256_add_pd(scan256(_mm256_sub_pd(_mm256_mul_pd(in_y, in_y), _mm256_mul_pd(old_y, old_y))), syy);
+        sxy = _mm256_add_pd(scan256(_mm256_sub_pd(_mm256_mul_pd(in_x, in_y), _mm256_mul_pd(old_x, old_y))), sxy);
+
+        __m256d vx = _mm256_sub_pd(sxx, _mm256_mul_pd(_mm256_mul_pd(sx, sx), vinv));
+        __m256d vy = _mm256_sub_pd(syy, _mm256_mul_pd(_mm256_mul_pd(sy, sy), vinv));
+        __m256d denom = _mm256_sqrt_pd(_mm256_mul_pd(vx, vy));
+        __m256d valid = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(vx, zero, _CMP_GT_OQ),
+                                                    _mm256_cmp_pd(vy, zero, _CMP_GT_OQ)),
+                                      _mm256_cmp_pd(denom, zero, _CMP_GT_OQ));
+        __m256d cov = _mm256_sub_pd(sxy, _mm256_mul_pd(_mm256_mul_pd(sx, sy), vinv));
+        _mm256_storeu_pd(out + j, _mm256_and_pd(valid, _mm256_div_pd(cov, denom)));
+
+        sx = lastLane256(sx);
+        sy = lastLane256(sy);
+        sxx = lastLane256(sxx);
+        syy = lastLane256(syy);
+        sxy = lastLane256(sxy);
+    }
+    WindowSums last{_mm256_cvtsd_f64(sx), _mm256_cvtsd_f64(sy), _mm256_cvtsd_f64(sxx),
+                    _mm256_cvtsd_f64(syy), _mm256_cvtsd_f64(sxy)};
+    windowCorrelationTail(x, y, j, count, window, kx, ky, last, inv, out);
+}
+
+// AVX-512: eight lanes, four accumulators
+
+// GCC 12's AVX-512 headers self-initialize _mm512_undefined_pd() operands,
+// which -Wuninitialized reports at every inlined max/reduce
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+HFT_TARGET("avx512f") double sumAvx512(const double* d, size_t n) {
+    __m512d a0 = _mm512_setzero_pd(), a1 = _mm512_setzero_pd();
+    __m512d a2 = _mm512_setzero_pd(), a3 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        a0 = _mm512_add_pd(a0, _mm512_loadu_pd(d + i));
+        a1 = _mm512_add_pd(a1, _mm512_loadu_pd(d + i + 8));
+        a2 = _mm512_add_pd(a2, _mm512_loadu_pd(d + i + 16));
+        a3 = _mm512_add_pd(a3, _mm512_loadu_pd(d + i + 24));
+    }
+    for (; i + 8 <= n; i += 8) {
+        a0 = _mm512_add_pd(a0, _mm512_loadu_pd(d + i));
+    }
+    if (i < n) {
+        __mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+        a1 = _mm512_add_pd(a1, _mm512_maskz_loadu_pd(tail, d + i));
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(a0, a1), _mm512_add_pd(a2, a3)));
+}
+
+HFT_TARGET("avx512f") double ssdAvx512(const double* d, size_t n, double c) {
+    __m512d vc = _mm512_set1_pd(c);
+    __m512d a0 = _mm512_setzero_pd(), a1 = _mm512_setzero_pd();
+    __m512d a2 = _mm512_setzero_pd(), a3 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512d e0 = _mm512_sub_pd(_mm512_loadu_pd(d + i), vc);
+        __m512d e1 = _mm512_sub_pd(_mm512_loadu_pd(d + i + 8), vc);
+        __m512d e2 = _mm512_sub_pd(_mm512_loadu_pd(d + i + 16), vc);
+        __m512d e3 = _mm512_sub_pd(_mm512_loadu_pd(d + i + 24), vc);
+        a0 = _mm512_add_pd(a0, _mm512_mul_pd(e0, e0));
+        a1 = _mm512_add_pd(a1, _mm512_mul_pd(e1, e1));
+        a2 = _mm512_add_pd(a2, _mm512_mul_pd(e2, e2));
+        a3 = _mm512_add_pd(a3, _mm512_mul_pd(e3, e3));
+    }
+    for (; i + 8 <= n; i += 8) {
+        __m512d e = _mm512_sub_pd(_mm512_loadu_pd(d + i), vc);
+        a0 = _mm512_add_pd(a0, _mm512_mul_pd(e, e));
+    }
+    if (i < n) {
+        // Masked-off lanes load as c, contributing zero
+        __mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+        __m512d e = _mm512_sub_pd(_mm512_mask_loadu_pd(vc, tail, d + i), vc);
+        a1 = _mm512_add_pd(a1, _mm512_mul_pd(e, e));
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(a0, a1), _mm512_add_pd(a2, a3)));
+}
+
+HFT_TARGET("avx512f") double dotAvx512(const double* x, const double* y, size_t n) {
+    __m512d a0 = _mm512_setzero_pd(), a1 = _mm512_setzero_pd();
+    __m512d a2 = _mm512_setzero_pd(), a3 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        a0 = _mm512_add_pd(a0, _mm512_mul_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+        a1 = _mm512_add_pd(a1, _mm512_mul_pd(_mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8)));
+        a2 = _mm512_add_pd(a2, _mm512_mul_pd(_mm512_loadu_pd(x + i + 16), _mm512_loadu_pd(y + i + 16)));
+        a3 = _mm512_add_pd(a3, _mm512_mul_pd(_mm512_loadu_pd(x + i + 24), _mm512_loadu_pd(y + i + 24)));
+    }
+    for (; i + 8 <= n; i += 8) {
+        a0 = _mm512_add_pd(a0, _mm512_mul_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+    }
+    if (i < n) {
+        __mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+        a1 = _mm512_add_pd(a1, _mm512_mul_pd(_mm512_maskz_loadu_pd(tail, x + i), _mm512_maskz_loadu_pd(tail, y + i)));
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(a0, a1), _mm512_add_pd(a2, a3)));
+}
+
+HFT_TARGET("avx512f") CrossMoments crossAvx512(const double* x, const double* y, size_t n, double mx, double my) {
+    __m512d vmx = _mm512_set1_pd(mx), vmy = _mm512_set1_pd(my);
+    __m512d sxx = _mm512_setzero_pd(), syy = _mm512_setzero_pd(), sxy = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(x + i), vmx);
+        __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(y + i), vmy);
+        sxx = _mm512_add_pd(sxx, _mm512_mul_pd(dx, dx));
+        syy = _mm512_add_pd(syy, _mm512_mul_pd(dy, dy));
+        sxy = _mm512_add_pd(sxy, _mm512_mul_pd(dx, dy));
+    }
+    if (i < n) {
+        __mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+        __m512d dx = _mm512_sub_pd(_mm512_mask_loadu_pd(vmx, tail, x + i), vmx);
+        __m512d dy = _mm512_sub_pd(_mm512_mask_loadu_pd(vmy, tail, y + i), vmy);
+        sxx = _mm512_add_pd(sxx, _mm512_mul_pd(dx, dx));
+        syy = _mm512_add_pd(syy, _mm512_mul_pd(dy, dy));
+        sxy = _mm512_add_pd(sxy, _mm512_mul_pd(dx, dy));
+    }
+    return {_mm512_reduce_add_pd(sxx), _mm512_reduce_add_pd(syy), _mm512_reduce_add_pd(sxy)};
+}
+
+HFT_TARGET("avx512f") double maxDrawdownAvx512(const double* d, size_t n) {
+    if (n < 2) return 0.0;
+    const __m512d neg_inf = _mm512_set1_pd(-std::numeric_limits<double>::infinity());
+    const __m512i shift1 = _mm512_set_epi64(6, 5, 4, 3, 2, 1, 0, 0);
+    const __m512i shift2 = _mm512_set_epi64(5, 4, 3, 2, 1, 0, 0, 0);
+    const __m512i shift4 = _mm512_set_epi64(3, 2, 1, 0, 0, 0, 0, 0);
+    const __m512i last = _mm512_set1_epi64(7);
+    __m512d peak = _mm512_set1_pd(d[0]);
+    __m512d dd = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d v = _mm512_loadu_pd(d + i);
+        // Prefix max in three shift-and-max steps; shifted-in lanes are -inf
+        __m512d scan = _mm512_max_pd(v, _mm512_mask_permutexvar_pd(neg_inf, 0xFE, shift1, v));
+        scan = _mm512_max_pd(scan, _mm512_mask_permutexvar_pd(neg_inf, 0xFC, shift2, scan));
+        scan = _mm512_max_pd(scan, _mm512_mask_permutexvar_pd(neg_inf, 0xF0, shift4, scan));
+
+        __m512d running = _mm512_max_pd(scan, peak);
+        dd = _mm512_max_pd(dd, _mm512_sub_pd(running, v));
+        peak = _mm512_max_pd(peak, _mm512_permutexvar_pd(last, scan));
+    }
+    return drawdownTail(d + i, n - i, _mm512_cvtsd_f64(peak), _mm512_reduce_max_pd(dd));
+}
+
+HFT_TARGET("avx512f") void linearScanAvx512(const double* in, size_t n, double decay, double prev, double* out) {
+    const __m512i shift1 = _mm512_set_epi64(6, 5, 4, 3, 2, 1, 0, 0);
+    const __m512i shift2 = _mm512_set_epi64(5, 4, 3, 2, 1, 0, 0, 0);
+    const __m512i shift4 = _mm512_set_epi64(3, 2, 1, 0, 0, 0, 0, 0);
+    const __m512i last = _mm512_set1_epi64(7);
+    double powers[8];
+    powers[0] = decay;
+    for (int k = 1; k < 8; ++k) {
+        powers[k] = powers[k - 1] * decay;
+    }
+    const __m512d d1 = _mm512_set1_pd(powers[0]);
+    const __m512d d2 = _mm512_set1_pd(powers[1]);
+    const __m512d d4 = _mm512_set1_pd(powers[3]);
+    const __m512d carry_pow = _mm512_loadu_pd(powers);
+    __m512d carry = _mm512_set1_pd(prev);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d v = _mm512_loadu_pd(in + i);
+        // Shift by 1, 2 and 4 lanes; shifted-in lanes are zero
+        __m512d scan = _mm512_add_pd(v, _mm512_mul_pd(d1, _mm512_maskz_permutexvar_pd(0xFE, shift1, v)));
+        scan = _mm512_add_pd(scan, _mm512_mul_pd(d2, _mm512_maskz_permutexvar_pd(0xFC, shift2, scan)));
+        scan = _mm512_add_pd(scan, _mm512_mul_pd(d4, _mm512_maskz_permutexvar_pd(0xF0, shift4, scan)));
+
+        scan = _mm512_add_pd(scan, _mm512_mul_pd(carry_pow, carry));
+        _mm512_storeu_pd(out + i, scan);
+        carry = _mm512_permutexvar_pd(last, scan);
+    }
+    linearScanScalar(in + i, n - i, decay, _mm512_cvtsd_f64(carry), out + i);
+}
+
+HFT_TARGET("avx512f") __m512d scan512(__m512d v) {
+    const __m512i shift1 = _mm512_set_epi64(6, 5, 4, 3, 2, 1, 0, 0);
+    const __m512i shift2 = _mm512_set_epi64(5, 4, 3, 2, 1, 0, 0, 0);
+    const __m512i shift4 = _mm512_set_epi64(3, 2, 1, 0, 0, 0, 0, 0);
+    v = _mm512_add_pd(v, _mm512_maskz_permutexvar_pd(0xFE, shift1, v));
+    v = _mm512_add_pd(v, _mm512_maskz_permutexvar_pd(0xFC, shift2, v));
+    return _mm512_add_pd(v, _mm512_maskz_permutexvar_pd(0xF0, shift4, v));
+}
+
+HFT_TARGET("avx512f") __m512d lastLane512(__m512d v) {
+    return _mm512_permutexvar_pd(_mm512_set1_epi64(7), v);
+}
+
+template<WindowStat STAT>
+HFT_TARGET("avx512f") __m512d windowStatAvx512Value(__m512d k, __m512d s1, __m512d s2, __m512d last,
+                                                    __m512d inv, __m512d inv_denom) {
+    const __m512d zero = _mm512_setzero_pd();
+    if constexpr (STAT == WindowStat::MEAN) {
+        return _mm512_add_pd(k, _mm512_mul_pd(s1, inv));
+    } else if constexpr (STAT == WindowStat::ZSCORE) {
+        __m512d mean = _mm512_mul_pd(s1, inv);
+        __m512d var = _mm512_sub_pd(_mm512_mul_pd(s2, inv), _mm512_mul_pd(mean, mean));
+        __mmask8 valid = _mm512_cmp_pd_mask(var, zero, _CMP_GT_OQ);
+        return _mm512_maskz_div_pd(valid, _mm512_sub_pd(_mm512_sub_pd(last, k), mean),
+                                   _mm512_maskz_sqrt_pd(valid, var));
+    } else {
+        __m512d m2 = _mm512_sub_pd(s2, _mm512_mul_pd(_mm512_mul_pd(s1, s1), inv));
+        __m512d var = _mm512_maskz_mul_pd(_mm512_cmp_pd_mask(m2, zero, _CMP_GT_OQ), m2, inv_denom);
+        return STAT == WindowStat::STDDEV ? _mm512_sqrt_pd(var) : var;
+    }
+}
+
+template<WindowStat STAT>
+HFT_TARGET("avx512f") void windowStatAvx512T(const double* x, size_t count, size_t window, double k,
+                                             double s1, double s2, double inv_denom, double* out) {
+    double inv = 1.0 / static_cast<double>(window);
+    out[0] = windowStatValue<STAT>(k, s1, s2, x[window - 1], inv, inv_denom);
+    const double* x_in = x + window - 1;
+    const __m512d vk = _mm512_set1_pd(k), vinv = _mm512_set1_pd(inv), vden = _mm512_set1_pd(inv_denom);
+    __m512d c1 = _mm512_set1_pd(s1), c2 = _mm512_set1_pd(s2);
+    size_t j = 1;
+    for (; j + 8 <= count; j += 8) {
+        __m512d last = _mm512_loadu_pd(x_in + j);
+        __m512d in = _mm512_sub_pd(last, vk);
+        __m512d old = _mm512_sub_pd(_mm512_loadu_pd(x + j - 1), vk);
+        c1 = _mm512_add_pd(scan512(_mm512_sub_pd(in, old)), c1);
+        if constexpr (STAT != WindowStat::MEAN) {
+            c2 = _mm512_add_pd(scan512(_mm512_sub_pd(_mm512_mul_pd(in, in), _mm512_mul_pd(old, old))), c2);
+        }
+        _mm512_storeu_pd(out + j, windowStatAvx512Value<STAT>(vk, c1, c2, last, vinv, vden));
+        c1 = lastLane512(c1);
+        c2 = lastLane512(c2);
+    }
+    windowStatTail<STAT>(x, j, count, window, k, _mm512_cvtsd_f64(c1), _mm512_cvtsd_f64(c2), inv, inv_denom, out);
+}
+
+HFT_TARGET("avx512f") void windowStatAvx512(WindowStat stat, const double* x, size_t count, size_t window, double k,
+                                            double s1, double s2, double inv_denom, double* out) {
+    switch (stat) {
+        case WindowStat::MEAN: return windowStatAvx512T<WindowStat::MEAN>(x, count, window, k, s1, s2, inv_denom, out);
+        case WindowStat::VARIANCE: return windowStatAvx512T<WindowStat::VARIANCE>(x, count, window, k, s1, s2, inv_denom, out);
+        case WindowStat::STDDEV: return windowStatAvx512T<WindowStat::STDDEV>(x, count, window, k, s1, s2, inv_denom, out);
+        case WindowStat::ZSCORE: return windowStatAvx512T<WindowStat::ZSCORE>(x, count, window, k, s1, s2, inv_denom, out);
+    }
+}
+
+HFT_TARGET("avx512f") void windowCorrelationAvx512(const double* x, const double* y, size_t count, size_t window,
+                                                   double kx, double ky, const WindowSums& first, double* out) {
+    double inv = 1.0 / static_cast<double>(window);
+    out[0] = correlationValue(first, inv);
+    const double* x_in = x + window - 1;
+    const double* y_in = y + window - 1;
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d vkx = _mm512_set1_pd(kx), vky = _mm512_set1_pd(ky), vinv = _mm512_set1_pd(inv);
+    __m512d sx = _mm512_set1_pd(first.sx), sy = _mm512_set1_pd(first.sy);
+    __m512d sxx = _mm512_set1_pd(first.sxx), syy = _mm512_set1_pd(first.syy), sxy = _mm512_set1_pd(first.sxy);
+    size_t j = 1;
+    for (; j + 8 <= count; j += 8) {
+        __m512d in_x = _mm512_sub_pd(_mm512_loadu_pd(x_in + j), vkx);
+        __m512d in_y = _mm512_sub_pd(_mm512_loadu_pd(y_in + j), vky);
+        __m512d old_x = _mm512_sub_pd(_mm512_loadu_pd(x + j - 1), vkx);
+        __m512d old_y = _mm512_sub_pd(_mm512_loadu_pd(y + j - 1), vky);
+        sx = _mm512_add_pd(scan512(_mm512_sub_pd(in_x, old_x)), sx);
+        sy = _mm512_add_pd(scan512(_mm512_sub_pd(in_y, old_y)), sy);
+        sxx = _mm512_add_pd(scan512(_mm512_sub_pd(_mm512_mul_pd(in_x, in_x), _mm512_mul_pd(old_x, old_x))), sxx);
+        syy = _mm512_add_pd(scan512(_mm512_sub_pd(_mm512_mul_pd(in_y, in_y), _mm512_mul_pd(old_y, old_y))), syy);
+        sxy = _mm512_add_pd(scan512(_mm512_sub_pd(_mm512_mul_pd(in_x, in_y), _mm512_mul_pd(old_x, old_y))), sxy);
+
+        __m512d vx = _mm512_sub_pd(sxx, _mm512_mul_pd(_mm512_mul_pd(sx, sx), vinv));
+        __m512d vy = _mm512_sub_pd(syy, _mm512_mul_pd(_mm512_mul_pd(sy, sy), vinv));
+        __mmask8 valid = _mm512_cmp_pd_mask(vx, zero, _CMP_GT_OQ) & _mm512_cmp_pd_mask(vy, zero, _CMP_GT_OQ);
+        __m512d denom = _mm512_maskz_sqrt_pd(valid, _mm512_mul_pd(vx, vy));
+        valid &= _mm512_cmp_pd_mask(denom, zero, _CMP_GT_OQ);
+        __m512d cov = _mm512_sub_pd(sxy, _mm512_mul_pd(_mm512_mul_pd(sx, sy), vinv));
+        _mm512_storeu_pd(out + j, _mm512_maskz_div_pd(valid, cov, denom));
+
+        sx = lastLane512(sx);
+        sy = lastLane512(sy);
+        sxx = lastLane512(sxx);
+        syy = lastLane512(syy);
+        sxy = lastLane512(sxy);
+    }
+    WindowSums last{_mm512_cvtsd_f64(sx), _mm512_cvtsd_f64(sy), _mm512_cvtsd_f64(sxx),
+                    _mm512_cvtsd_f64(syy), _mm512_cvtsd_f64(sxy)};
+    windowCorrelationTail(x, y, j, count, window, kx, ky, last, inv, out);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // HFT_X86_KERNELS
+
+const KernelTable SCALAR_TABLE = {Isa::SCALAR, sumScalar, ssdScalar, dotScalar, crossScalar, maxDrawdownScalar,
+                                  linearScanScalar, windowStatScalar, windowCorrelationScalar};
+#ifdef HFT_X86_KERNELS
+const KernelTable SSE4_TABLE = {Isa::SSE4, sumSse4, ssdSse4, dotSse4, crossSse4, maxDrawdownSse4, linearScanSse4,
+                                windowStatSse4, windowCorrelationSse4};
+const KernelTable AVX2_TABLE = {Isa::AVX2, sumAvx2, ssdAvx2, dotAvx2, crossAvx2, maxDrawdownAvx2, linearScanAvx2,
+                                windowStatAvx2, windowCorrelationAvx2};
+const KernelTable AVX512_TABLE = {Isa::AVX512, sumAvx512, ssdAvx512, dotAvx512, crossAvx512, maxDrawdownAvx512,
+                                  linearScanAvx512, windowStatAvx512,
+                                  windowCorrelationAvx512};
+#endif
+
+const KernelTable* tableFor(Isa isa) {
+    switch (isa) {
+#ifdef HFT_X86_KERNELS
+        case Isa::SSE4: return &SSE4_TABLE;
+        case Isa::AVX2: return &AVX2_TABLE;
+        case Isa::AVX512: return &AVX512_TABLE;
+#endif
+        default: return &SCALAR_TABLE;
+    }
+}
+
+std::atomic<const KernelTable*> active_table{nullptr};
+
+const KernelTable& table() {
+    const KernelTable* current = active_table.load(std::memory_order_acquire);
+    if (current == nullptr) {
+        current = tableFor(bestSupportedIsa());
+        active_table.store(current, std::memory_order_release);
+    }
+    return *current;
+}
+
+} // namespace
+
+double sum(const double* data, size_t n) {
+    auto leaf = table().sum_leaf;
+    return pairwise<double>(0, n, [&](size_t begin, size_t count) { return leaf(data + begin, count); });
+}
+
+double sumSquaredDeviations(const double* data, size_t n, double center) {
+    auto leaf = table().ssd_leaf;
+    return pairwise<double>(0, n, [&](size_t begin, size_t count) { return leaf(data + begin, count, center); });
+}
+
+double dot(const double* x, const double* y, size_t n) {
+    auto leaf = table().dot_leaf;
+    return pairwise<double>(0, n, [&](size_t begin, size_t count) { return leaf(x + begin, y + begin, count); });
+}
+
+CrossMoments crossMoments(const double* x, const double* y, size_t n, double mean_x, double mean_y) {
+    auto leaf = table().cross_leaf;
+    return pairwise<CrossMoments>(0, n, [&](size_t begin, size_t count) {
+        return leaf(x + begin, y + begin, count, mean_x, mean_y);
+    });
+}
+
+double maxDrawdown(const double* values, size_t n) {
+    return table().max_drawdown(values, n);
+}
+
+void linearScan(const double* in, size_t n, double decay, double init, double* out) {
+    table().linear_scan(in, n, decay, init, out);
+}
+
+void windowStat(WindowStat stat, const double* x, size_t count, size_t window, double k,
+                double s1, double s2, double inv_denom, double* out) {
+    if (count > 0) {
+        table().window_stat(stat, x, count, window, k, s1, s2, inv_denom, out);
+    }
+}
+
+void windowCorrelation(const double* x, const double* y, size_t count, size_t window,
+                       double kx, double ky, const WindowSums& first, double* out) {
+    if (count > 0) {
+        table().window_correlation(x, y, count, window, kx, ky, first, out);
+    }
+}
+
+double mean(const double* data, size_t n) {
+    return n > 0 ? sum(data, n) / static_cast<double>(n) : 0.0;
+}
+
+double variance(const double* data, size_t n, bool sample) {
+    size_t denom = sample ? n - 1 : n;
+    if (n == 0 || denom == 0) {
+        return 0.0;
+    }
+    return sumSquaredDeviations(data, n, mean(data, n)) / static_cast<double>(denom);
+}
+
+Isa activeIsa() {
+    return table().isa;
+}
+
+bool isSupported(Isa isa) {
+    switch (isa) {
+        case Isa::SCALAR:
+            return true;
+#ifdef HFT_X86_KERNELS
+        case Isa::SSE4:
+            return __builtin_cpu_supports("sse4.2");
+        case Isa::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case Isa::AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+    }
+}
+
+Isa bestSupportedIsa() {
+    for (Isa isa : {Isa::AVX512, Isa::AVX2, Isa::SSE4}) {
+        if (isSupported(isa)) {
+            return isa;
+        }
+    }
+    return Isa::SCALAR;
+}
+
+bool setIsa(Isa isa) {
+    if (!isSupported(isa)) {
+        return false;
+    }
+    active_table.store(tableFor(isa), std::memory_order_release);
+    return true;
+}
+
+const char* isaName(Isa isa) {
+    switch (isa) {
+        case Isa::SCALAR: return "scalar";
+        case Isa::SSE4: return "sse4";
+        case Isa::AVX2: return "avx2";
+        case Isa::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+} // namespace kernels
+} // namespace hft
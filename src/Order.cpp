@@ -1,4 +1,5 @@
 #include "Order.h"
+#include "Clock.h"
 #include <sstream>
 #include <iomanip>
 
@@ -8,8 +9,7 @@ Order::Order(uint64_t id, const std::string& sym, OrderSide s, OrderType t,
              double p, double qty)
     : order_id(id), symbol(sym), side(s), type(t), price(p), quantity(qty),
       filled_quantity(0.0), status(OrderStatus::PENDING),
-      timestamp(std::chrono::system_clock::now()),
-      created_time(std::chrono::system_clock::now()) {
+      timestamp(Clock::now()), created_time(timestamp) {
 }
 
 bool Order::isActive() const {
@@ -30,7 +30,7 @@ void Order::updateFill(double fill_qty) {
     }
     
     filled_quantity += fill_qty;
-    timestamp = std::chrono::system_clock::now();
+    timestamp = Clock::now();
     
     if (filled_quantity >= quantity) {
         status = OrderStatus::FILLED;
@@ -42,14 +42,12 @@ void Order::updateFill(double fill_qty) {
 void Order::cancel() {
     if (isActive()) {
         status = OrderStatus::CANCELLED;
-        timestamp = std::chrono::system_clock::now();
+        timestamp = Clock::now();
     }
 }
 
 uint64_t Order::getAgeMs() const {
-    auto now = std::chrono::system_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - created_time);
-    return duration.count();
+    return Clock::toNanos(Clock::now() - created_time) / 1000000;
 }
 
 // Helper function to convert OrderSide to string
@@ -1,4 +1,6 @@
 #include "OrderBook.h"
+#include "Trace.h"
+#include "Clock.h"
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -11,7 +13,8 @@ OrderBook::OrderBook(const std::string& sym) : symbol(sym) {
 }
 
 uint64_t OrderBook::addOrder(OrderSide side, OrderType type, double price, double quantity) {
-    std::lock_guard<std::mutex> lock(order_book_mutex);
+    TraceScope trace("book", "OrderBook::addOrder");
+    std::lock_guard<ProfiledMutex> lock(order_book_mutex);
     
     uint64_t order_id = generateOrderId();
     auto order = std::make_shared<Order>(order_id, symbol, side, type, price, quantity);
@@ -33,7 +36,8 @@ uint64_t OrderBook::addOrder(OrderSide side, OrderType type, double price, doubl
 }
 
 bool OrderBook::cancelOrder(uint64_t order_id) {
-    std::lock_guard<std::mutex> lock(order_book_mutex);
+    TraceScope trace("book", "OrderBook::cancelOrder");
+    std::lock_guard<ProfiledMutex> lock(order_book_mutex);
     
     auto it = order_lookup.find(order_id);
     if (it == order_lookup.end()) {
@@ -65,39 +69,55 @@ bool OrderBook::cancelOrder(uint64_t order_id) {
 }
 
 bool OrderBook::modifyOrder(uint64_t order_id, double new_price, double new_quantity) {
-    std::lock_guard<std::mutex> lock(order_book_mutex);
+    TraceScope trace("book", "OrderBook::modifyOrder");
+    std::lock_guard<ProfiledMutex> lock(order_book_mutex);
     
     auto it = order_lookup.find(order_id);
     if (it == order_lookup.end()) {
         return false;
     }
     
-    auto order = it->second;
-    if (!order->isActive()) {
+    auto old_order = it->second;
+    if (!old_order->isActive()) {
         return false;
     }
     
-    // Cancel old order
-    cancelOrder(order_id);
+    // Cancel old order (cancelOrder/addOrder would re-lock the book)
+    old_order->cancel();
+    if (old_order->side == OrderSide::BUY) {
+        removeOrderFromPriceLevel(bids, old_order->price, order_id);
+    } else {
+        removeOrderFromPriceLevel(asks, old_order->price, order_id);
+    }
+    cleanupEmptyPriceLevels();
     
-    // Add new order
-    addOrder(order->side, order->type, new_price, new_quantity);
+    // Re-queue under the same id at the back of the new price level
+    auto order = std::make_shared<Order>(order_id, symbol, old_order->side, old_order->type, new_price, new_quantity);
+    if (order->side == OrderSide::BUY) {
+        bids[new_price].push_back(order);
+    } else {
+        asks[new_price].push_back(order);
+    }
+    it->second = order;
+    
+    total_orders_processed++;
+    total_volume_processed += new_quantity;
     
     return true;
 }
 
 double OrderBook::getBestBid() const {
-    std::lock_guard<std::mutex> lock(order_book_mutex);
+    std::lock_guard<ProfiledMutex> lock(order_book_mutex);
     return getBestBidUnsafe();
 }
 
 double OrderBook::getBestAsk() const {
-    std::lock_guard<std::mutex> lock(order_book_mutex);
+    std::lock_guard<ProfiledMutex> lock(order_book_mutex);
     return getBestAskUnsafe();
 }
 
 double OrderBook::getMidPrice() const {
-    std::lock_guard<std::mutex> lock(order_book_mutex);
+    std::lock_guard<ProfiledMutex> lock(order_book_mutex);
     
     double best_bid = getBestBidUnsafe();
     double best_ask = getBestAskUnsafe();
@@ -110,7 +130,7 @@ double OrderBook::getMidPrice() const {
 }
 
 double OrderBook::getSpread() const {
-    std::lock_guard<std::mutex> lock(order_book_mutex);
+    std::lock_guard<ProfiledMutex> lock(order_book_mutex);
     
     double best_bid = getBestBidUnsafe();
     double best_ask = getBestAskUnsafe();
@@ -123,7 +143,7 @@ double OrderBook::getSpread() const {
 }
 
 double OrderBook::getBidVolume() const {
-    std::lock_guard<std::mutex> lock(order_book_mutex);
+    std::lock_guard<ProfiledMutex> lock(order_book_mutex);
     
     double total_volume = 0.0;
     for (const auto& [price, orders] : bids) {
@@ -137,7 +157,7 @@ double OrderBook::getBidVolume() const {
 }
 
 double OrderBook::getAskVolume() const {
-    std::lock_guard<std::mutex> lock(order_book_mutex);
+    std::lock_guard<ProfiledMutex> lock(order_book_mutex);
     
     double total_volume = 0.0;
     for (const auto& [price, orders] : asks) {
@@ -150,54 +170,37 @@ double OrderBook::getAskVolume() const {
     return total_volume;
 }
 
-std::vector<std::pair<double, double>> OrderBook::getTopBids(int levels) const {
-    std::lock_guard<std::mutex> lock(order_book_mutex);
-    
-    std::vector<std::pair<double, double>> result;
-    int count = 0;
+TopOfBook OrderBook::getTopOfBook() const {
+    std::lock_guard<ProfiledMutex> lock(order_book_mutex);
     
-    for (const auto& [price, orders] : bids) {
-        if (count >= levels) break;
-        
-        double total_volume = 0.0;
+    auto levelSize = [](const std::vector<std::shared_ptr<Order>>& orders) {
+        double size = 0.0;
         for (const auto& order : orders) {
             if (order->isActive()) {
-                total_volume += order->getRemainingQuantity();
+                size += order->getRemainingQuantity();
             }
         }
-        
-        if (total_volume > 0) {
-            result.emplace_back(price, total_volume);
-            count++;
-        }
-    }
-    
-    return result;
+        return size;
+    };
+    
+    TopOfBook top;
+    top.best_bid = getBestBidUnsafe();
+    top.best_ask = getBestAskUnsafe();
+    top.bid_size = bids.empty() ? 0.0 : levelSize(bids.begin()->second);
+    top.ask_size = asks.empty() ? 0.0 : levelSize(asks.begin()->second);
+    top.bid_levels = bids.size();
+    top.ask_levels = asks.size();
+    return top;
+}
+
+std::vector<std::pair<double, double>> OrderBook::getTopBids(int levels) const {
+    std::lock_guard<ProfiledMutex> lock(order_book_mutex);
+    return getTopLevelsUnsafe(bids, levels);
 }
 
 std::vector<std::pair<double, double>> OrderBook::getTopAsks(int levels) const {
-    std::lock_guard<std::mutex> lock(order_book_mutex);
-    
-    std::vector<std::pair<double, double>> result;
-    int count = 0;
-    
-    for (const auto& [price, orders] : asks) {
-        if (count >= levels) break;
-        
-        double total_volume = 0.0;
-        for (const auto& order : orders) {
-            if (order->isActive()) {
-                total_volume += order->getRemainingQuantity();
-            }
-        }
-        
-        if (total_volume > 0) {
-            result.emplace_back(price, total_volume);
-            count++;
-        }
-    }
-    
-    return result;
+    std::lock_guard<ProfiledMutex> lock(order_book_mutex);
+    return getTopLevelsUnsafe(asks, levels);
 }
 
 void OrderBook::printOrderBook(int levels) const {
@@ -205,14 +208,14 @@ void OrderBook::printOrderBook(int levels) const {
 }
 
 std::string OrderBook::getOrderBookString(int levels) const {
-    std::lock_guard<std::mutex> lock(order_book_mutex);
+    std::lock_guard<ProfiledMutex> lock(order_book_mutex);
     
     std::ostringstream oss;
     oss << "\n=== Order Book: " << symbol << " ===\n";
     oss << std::fixed << std::setprecision(2);
     
-    // Print asks (descending order)
-    auto ask_levels = getTopAsks(levels);
+    // Print asks (descending order); the book is already locked
+    auto ask_levels = getTopLevelsUnsafe(asks, levels);
     std::reverse(ask_levels.begin(), ask_levels.end());
     
     for (const auto& [price, volume] : ask_levels) {
@@ -222,7 +225,7 @@ std::string OrderBook::getOrderBookString(int levels) const {
     oss << "-------------------\n";
     
     // Print bids
-    auto bid_levels = getTopBids(levels);
+    auto bid_levels = getTopLevelsUnsafe(bids, levels);
     for (const auto& [price, volume] : bid_levels) {
         oss << std::setw(10) << price << " | " << std::setw(10) << volume << "\n";
     }
@@ -236,55 +239,13 @@ std::string OrderBook::getOrderBookString(int levels) const {
 }
 
 bool OrderBook::processMarketOrder(OrderSide side, double quantity) {
-    std::lock_guard<std::mutex> lock(order_book_mutex);
+    TraceScope trace("book", "OrderBook::processMarketOrder");
+    std::lock_guard<ProfiledMutex> lock(order_book_mutex);
     
-    if (side == OrderSide::BUY) {
-        // Market buy order - match against asks
-        double remaining_qty = quantity;
-        
-        for (auto& [price, orders] : asks) {
-            if (remaining_qty <= 0) break;
-            
-            for (auto& order : orders) {
-                if (!order->isActive()) continue;
-                
-                double fill_qty = std::min(remaining_qty, order->getRemainingQuantity());
-                order->updateFill(fill_qty);
-                remaining_qty -= fill_qty;
-                
-                if (order->isFilled()) {
-                    total_orders_filled++;
-                }
-                
-                if (remaining_qty <= 0) break;
-            }
-        }
-        
-        return remaining_qty <= 0;
-    } else {
-        // Market sell order - match against bids
-        double remaining_qty = quantity;
-        
-        for (auto& [price, orders] : bids) {
-            if (remaining_qty <= 0) break;
-            
-            for (auto& order : orders) {
-                if (!order->isActive()) continue;
-                
-                double fill_qty = std::min(remaining_qty, order->getRemainingQuantity());
-                order->updateFill(fill_qty);
-                remaining_qty -= fill_qty;
-                
-                if (order->isFilled()) {
-                    total_orders_filled++;
-                }
-                
-                if (remaining_qty <= 0) break;
-            }
-        }
-        
-        return remaining_qty <= 0;
-    }
+    // Market buys match against asks, market sells against bids
+    double remaining_qty = (side == OrderSide::BUY) ? fillAgainstUnsafe(asks, quantity)
+                                                    : fillAgainstUnsafe(bids, quantity);
+    return remaining_qty <= 0;
 }
 
 void OrderBook::updatePrice(double new_price) {
@@ -295,12 +256,12 @@ void OrderBook::updatePrice(double new_price) {
 }
 
 bool OrderBook::isEmpty() const {
-    std::lock_guard<std::mutex> lock(order_book_mutex);
+    std::lock_guard<ProfiledMutex> lock(order_book_mutex);
     return bids.empty() && asks.empty();
 }
 
 void OrderBook::clear() {
-    std::lock_guard<std::mutex> lock(order_book_mutex);
+    std::lock_guard<ProfiledMutex> lock(order_book_mutex);
     bids.clear();
     asks.clear();
     order_lookup.clear();
@@ -322,6 +283,68 @@ void OrderBook::removeOrderFromPriceLevel(std::map<double, std::vector<std::shar
                                }), orders.end());
 }
 
+template<typename Compare>
+std::vector<std::pair<double, double>> OrderBook::getTopLevelsUnsafe(
+    const std::map<double, std::vector<std::shared_ptr<Order>>, Compare>& price_levels, int levels) const {
+    std::vector<std::pair<double, double>> result;
+    int count = 0;
+    
+    for (const auto& [price, orders] : price_levels) {
+        if (count >= levels) break;
+        
+        double total_volume = 0.0;
+        for (const auto& order : orders) {
+            if (order->isActive()) {
+                total_volume += order->getRemainingQuantity();
+            }
+        }
+        
+        if (total_volume > 0) {
+            result.emplace_back(price, total_volume);
+            count++;
+        }
+    }
+    
+    return result;
+}
+
+template<typename Compare>
+double OrderBook::fillAgainstUnsafe(std::map<double, std::vector<std::shared_ptr<Order>>, Compare>& price_levels,
+                                    double quantity) {
+    double remaining_qty = quantity;
+    
+    for (auto level = price_levels.begin(); level != price_levels.end() && remaining_qty > 0;) {
+        auto& orders = level->second;
+        
+        for (auto& order : orders) {
+            if (remaining_qty <= 0) break;
+            if (!order->isActive()) continue;
+            
+            double fill_qty = std::min(remaining_qty, order->getRemainingQuantity());
+            order->updateFill(fill_qty);
+            remaining_qty -= fill_qty;
+            
+            if (order->isFilled()) {
+                total_orders_filled++;
+                order_lookup.erase(order->order_id);
+            }
+        }
+        
+        // Fills are in time priority, so filled orders form the front of the level
+        auto first_active = std::find_if(orders.begin(), orders.end(),
+                                         [](const std::shared_ptr<Order>& order) { return order->isActive(); });
+        orders.erase(orders.begin(), first_active);
+        
+        if (orders.empty()) {
+            level = price_levels.erase(level);
+        } else {
+            ++level;
+        }
+    }
+    
+    return remaining_qty;
+}
+
 void OrderBook::cleanupEmptyPriceLevels() {
     // Remove empty bid levels
     for (auto it = bids.begin(); it != bids.end();) {
@@ -344,7 +367,7 @@ void OrderBook::cleanupEmptyPriceLevels() {
 
 void OrderBook::updateOrderStatus(std::shared_ptr<Order> order, OrderStatus status) {
     order->status = status;
-    order->timestamp = std::chrono::system_clock::now();
+    order->timestamp = Clock::now();
 }
 
 uint64_t OrderBook::generateOrderId() {
@@ -1,25 +1,41 @@
 #include "PnLCalculator.h"
+#include "Trace.h"
+#include "Clock.h"
+#include "CsvWriter.h"
+#include "ColumnarFile.h"
+#include "NumericKernels.h"
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
 #include <numeric>
 #include <cmath>
+#include <limits>
 
 namespace hft {
 
-PnLCalculator::PnLCalculator(size_t history_size, bool daily_tracking)
-    : current_position(0.0), average_cost(0.0), mark_price(0.0),
+PnLCalculator::PnLCalculator(size_t history_size, bool daily_tracking,
+                             CostBasisMethod cost_method)
+    : trade_history(history_size),
+      pnl_history(history_size),
+      pnl_bars(std::min<size_t>(history_size, 1024)),
+      updates_since_snapshot(0),
+      lot_engine(cost_method), mark_price(0.0),
+      realized_pnl(0.0), unrealized_pnl(0.0), total_pnl(0.0),
+      update_count(0),
       daily_pnl(0.0), daily_high(0.0), daily_low(0.0),
       max_drawdown(0.0), peak_value(0.0),
+      returns(std::min<size_t>(history_size, 1024)), return_stats(252),
+      winning_trades(0), losing_trades(0), gross_profit(0.0), gross_loss(0.0),
       max_history_size(history_size), track_daily_metrics(daily_tracking) {
     
     last_reset = std::chrono::system_clock::now();
+    publishState();
 }
 
 void PnLCalculator::recordTrade(double price, double quantity, double side) {
     Trade trade;
-    trade.timestamp = std::chrono::system_clock::now();
+    trade.timestamp = Clock::wallNow();
     trade.price = price;
     trade.quantity = quantity;
     trade.side = side;
@@ -30,19 +46,22 @@ void PnLCalculator::recordTrade(double price, double quantity, double side) {
 }
 
 void PnLCalculator::recordTrade(const Trade& trade) {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
+    TraceScope trace("pnl", "PnLCalculator::recordTrade");
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
     
     addToHistory(trade);
-    updatePosition(trade.quantity, trade.price);
+    updatePosition(trade.quantity * trade.side, trade.price);
     updatePnL();
     
     if (track_daily_metrics) {
         updateDailyMetrics();
+        publishState();
     }
 }
 
 void PnLCalculator::updateMarkPrice(double new_price) {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
+    TraceScope trace("pnl", "PnLCalculator::updateMarkPrice");
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
     mark_price = new_price;
     updatePnL();
 }
@@ -51,239 +70,301 @@ void PnLCalculator::updatePnL() {
     calculateRealizedPnL();
     calculateUnrealizedPnL();
     
-    total_pnl.store(realized_pnl.load() + unrealized_pnl.load());
+    total_pnl = realized_pnl + unrealized_pnl;
     
     // Update drawdown metrics
     updateDrawdownMetrics();
     
-    // Add to PnL history
-    PnLSnapshot snapshot;
-    snapshot.timestamp = std::chrono::system_clock::now();
-    snapshot.realized_pnl = realized_pnl.load();
-    snapshot.unrealized_pnl = unrealized_pnl.load();
-    snapshot.total_pnl = total_pnl.load();
-    snapshot.position = current_position;
-    snapshot.mark_price = mark_price;
-    snapshot.daily_pnl = daily_pnl;
-    snapshot.cumulative_pnl = total_pnl.load();
+    // Add to PnL history according to the snapshot policy
+    recordSnapshot();
     
-    addToPnLHistory(snapshot);
+    update_count++;
+    publishState();
 }
 
 void PnLCalculator::calculateRealizedPnL() {
-    // Realized PnL is already calculated when trades are recorded
-    // This method can be used for additional calculations if needed
+    // Realized PnL is accumulated by the lot engine as fills close lots
+    realized_pnl = lot_engine.getRealizedPnL();
 }
 
 void PnLCalculator::calculateUnrealizedPnL() {
-    if (current_position == 0.0 || mark_price == 0.0) {
-        unrealized_pnl.store(0.0);
+    if (lot_engine.getPosition() == 0.0 || mark_price == 0.0) {
+        unrealized_pnl = 0.0;
         return;
     }
     
-    // Unrealized PnL = (Mark Price - Average Cost) * Position
-    double unrealized = (mark_price - average_cost) * current_position;
-    unrealized_pnl.store(unrealized);
+    // Unrealized PnL = Position * Mark Price - Open Lot Cost
+    unrealized_pnl = lot_engine.getUnrealizedPnL(mark_price);
 }
 
 void PnLCalculator::updatePosition(double quantity, double price) {
-    if (quantity <= 0) return;
-    
-    double trade_value = quantity * price;
-    
-    if (current_position == 0.0) {
-        // First trade
-        current_position = quantity;
-        average_cost = price;
-    } else {
-        // Update average cost using weighted average
-        double total_value = current_position * average_cost + trade_value;
-        current_position += quantity;
-        average_cost = total_value / current_position;
+    double realized = lot_engine.applyFill(quantity, price);
+    
+    // Running trade outcome counters; scratch fills count as neither
+    if (realized > 0.0) {
+        winning_trades++;
+        gross_profit += realized;
+    } else if (realized < 0.0) {
+        losing_trades++;
+        gross_loss -= realized;
     }
 }
 
 double PnLCalculator::getCurrentPosition() const {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
-    return current_position;
+    return published_state.load().position;
 }
 
 double PnLCalculator::getAverageCost() const {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
-    return average_cost;
+    return published_state.load().average_cost;
+}
+
+size_t PnLCalculator::getOpenLotCount() const {
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
+    return lot_engine.getOpenLotCount();
 }
 
 double PnLCalculator::getMarkToMarketPnL() const {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
-    return total_pnl.load();
+    return published_state.load().total_pnl;
 }
 
 double PnLCalculator::getSharpeRatio(size_t lookback) const {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
-    
-    if (returns.size() < lookback) {
-        return 0.0;
-    }
-    
-    size_t start_idx = returns.size() - lookback;
-    std::vector<double> recent_returns(returns.begin() + start_idx, returns.end());
-    
-    return calculateSharpeRatio(recent_returns);
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
+    return getSharpeRatioUnsafe(lookback);
 }
 
 double PnLCalculator::getMaxDrawdown() const {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
-    return max_drawdown;
+    return published_state.load().max_drawdown;
 }
 
 double PnLCalculator::getVolatility(size_t lookback) const {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
-    
-    if (returns.size() < lookback) {
-        return 0.0;
-    }
-    
-    size_t start_idx = returns.size() - lookback;
-    std::vector<double> recent_returns(returns.begin() + start_idx, returns.end());
-    
-    return calculateVolatility(recent_returns);
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
+    return getVolatilityUnsafe(lookback);
 }
 
 double PnLCalculator::getWinRate() const {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
-    
-    if (trade_history.empty()) {
-        return 0.0;
-    }
-    
-    int winning_trades = 0;
-    for (const auto& trade : trade_history) {
-        // A trade is "winning" if it reduces position or improves average cost
-        if (trade.side * (trade.price - average_cost) > 0) {
-            winning_trades++;
-        }
-    }
-    
-    return static_cast<double>(winning_trades) / trade_history.size();
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
+    return getWinRateUnsafe();
 }
 
 double PnLCalculator::getProfitFactor() const {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
-    
-    if (trade_history.empty()) {
-        return 0.0;
-    }
-    
-    double gross_profit = 0.0;
-    double gross_loss = 0.0;
-    
-    for (const auto& trade : trade_history) {
-        double trade_pnl = trade.side * (trade.price - average_cost) * trade.quantity;
-        if (trade_pnl > 0) {
-            gross_profit += trade_pnl;
-        } else {
-            gross_loss += std::abs(trade_pnl);
-        }
-    }
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
+    return getProfitFactorUnsafe();
+}
+
+void PnLCalculator::setMetricsWindow(size_t window) {
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
     
-    if (gross_loss == 0.0) {
-        return gross_profit > 0.0 ? std::numeric_limits<double>::max() : 0.0;
+    // Rebuild the accumulator from the retained returns
+    return_stats = RollingMoments(window);
+    size_t start = returns.size() > window ? returns.size() - window : 0;
+    for (size_t i = start; i < returns.size(); ++i) {
+        return_stats.add(returns[i]);
     }
-    
-    return gross_profit / gross_loss;
+}
+
+size_t PnLCalculator::getMetricsWindow() const {
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
+    return return_stats.getWindow();
 }
 
 double PnLCalculator::getDailyPnL() const {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
-    return daily_pnl;
+    return published_state.load().daily_pnl;
 }
 
 double PnLCalculator::getDailyHigh() const {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
     return daily_high;
 }
 
 double PnLCalculator::getDailyLow() const {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
     return daily_low;
 }
 
 void PnLCalculator::resetDailyMetrics() {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
     
     daily_pnl = 0.0;
     daily_high = 0.0;
     daily_low = 0.0;
     last_reset = std::chrono::system_clock::now();
+    publishState();
 }
 
-std::vector<PnLSnapshot> PnLCalculator::getPnLHistory() const {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
-    return std::vector<PnLSnapshot>(pnl_history.begin(), pnl_history.end());
+void PnLCalculator::setSnapshotConfig(const SnapshotConfig& config) {
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
+    snapshot_config = config;
+    if (snapshot_config.every_n_ticks == 0) {
+        snapshot_config.every_n_ticks = 1;
+    }
+    if (snapshot_config.bucket_interval.count() <= 0) {
+        snapshot_config.bucket_interval = std::chrono::milliseconds(1);
+    }
+    updates_since_snapshot = 0;
+}
+
+SnapshotConfig PnLCalculator::getSnapshotConfig() const {
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
+    return snapshot_config;
+}
+
+LockedRef<PnLHistory, ProfiledMutex> PnLCalculator::getPnLHistory() const {
+    std::unique_lock<ProfiledMutex> lock(pnl_mutex);
+    return LockedRef<PnLHistory, ProfiledMutex>(std::move(lock), pnl_history);
+}
+
+LockedRef<TradeHistory, ProfiledMutex> PnLCalculator::getTradeColumns() const {
+    std::unique_lock<ProfiledMutex> lock(pnl_mutex);
+    return LockedRef<TradeHistory, ProfiledMutex>(std::move(lock), trade_history);
+}
+
+LockedRingView<PnLBar, ProfiledMutex> PnLCalculator::getPnLBars() const {
+    std::unique_lock<ProfiledMutex> lock(pnl_mutex);
+    auto view = pnl_bars.view();
+    return LockedRingView<PnLBar, ProfiledMutex>(std::move(lock), view);
 }
 
 std::vector<Trade> PnLCalculator::getTradeHistory() const {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
-    return std::vector<Trade>(trade_history.begin(), trade_history.end());
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
+    std::vector<Trade> trades;
+    trades.reserve(trade_history.size());
+    for (size_t i = 0; i < trade_history.size(); ++i) {
+        trades.push_back(trade_history[i]);
+    }
+    return trades;
 }
 
 std::vector<double> PnLCalculator::getReturns() const {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
-    return returns;
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
+    std::vector<double> result;
+    result.reserve(returns.size());
+    returns.view().forEach([&result](double ret) { result.push_back(ret); });
+    return result;
+}
+
+bool PnLCalculator::enableHistorySpill(const std::string& directory, size_t segment_rows) {
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
+    
+    if (!trade_history.enableSpill(directory, segment_rows) ||
+        !pnl_history.enableSpill(directory, segment_rows)) {
+        trade_history.disableSpill();
+        pnl_history.disableSpill();
+        return false;
+    }
+    return true;
+}
+
+void PnLCalculator::disableHistorySpill() {
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
+    trade_history.disableSpill();
+    pnl_history.disableSpill();
+}
+
+bool PnLCalculator::isHistorySpillEnabled() const {
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
+    return trade_history.isSpilling();
+}
+
+uint64_t PnLCalculator::getSpilledTradeCount() const {
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
+    return trade_history.spilledCount();
+}
+
+uint64_t PnLCalculator::getSpilledSnapshotCount() const {
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
+    return pnl_history.spilledCount();
+}
+
+std::vector<Trade> PnLCalculator::getTradesBetween(std::chrono::system_clock::time_point from,
+                                                   std::chrono::system_clock::time_point to) const {
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
+    return trade_history.range(from, to);
+}
+
+std::vector<PnLSnapshot> PnLCalculator::getSnapshotsBetween(std::chrono::system_clock::time_point from,
+                                                            std::chrono::system_clock::time_point to) const {
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
+    return pnl_history.range(from, to);
 }
 
 void PnLCalculator::exportToCSV(const std::string& filename) const {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
+    TraceScope trace("pnl", "PnLCalculator::exportToCSV");
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
     
     std::string actual_filename = filename.empty() ? "pnl_data.csv" : filename;
     
-    std::ofstream file(actual_filename);
-    if (!file.is_open()) {
+    CsvWriter csv(actual_filename);
+    if (!csv.isOpen()) {
         return;
     }
     
-    // Write header
-    file << "Timestamp,RealizedPnL,UnrealizedPnL,TotalPnL,Position,MarkPrice,DailyPnL,CumulativePnL\n";
-    
-    // Write data
-    for (const auto& snapshot : pnl_history) {
-        auto time_t = std::chrono::system_clock::to_time_t(snapshot.timestamp);
-        std::tm* tm = std::localtime(&time_t);
-        
-        file << std::put_time(tm, "%Y-%m-%d %H:%M:%S") << ","
-             << snapshot.realized_pnl << ","
-             << snapshot.unrealized_pnl << ","
-             << snapshot.total_pnl << ","
-             << snapshot.position << ","
-             << snapshot.mark_price << ","
-             << snapshot.daily_pnl << ","
-             << snapshot.cumulative_pnl << "\n";
-    }
+    csv.writeHeader("Timestamp,RealizedPnL,UnrealizedPnL,TotalPnL,Position,MarkPrice,DailyPnL,CumulativePnL");
+    
+    const int64_t* timestamps = pnl_history.timestampColumn();
+    const double* realized = pnl_history.realizedPnLColumn();
+    const double* unrealized = pnl_history.unrealizedPnLColumn();
+    const double* total = pnl_history.totalPnLColumn();
+    const double* positions = pnl_history.positionColumn();
+    const double* marks = pnl_history.markPriceColumn();
+    const double* daily = pnl_history.dailyPnLColumn();
+    const double* cumulative = pnl_history.cumulativePnLColumn();
+    
+    pnl_history.forEachSegment([&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            csv.timestampField(timestamps[i]);
+            csv.field(realized[i]);
+            csv.field(unrealized[i]);
+            csv.field(total[i]);
+            csv.field(positions[i]);
+            csv.field(marks[i]);
+            csv.field(daily[i]);
+            csv.field(cumulative[i]);
+            csv.endRow();
+        }
+    });
     
-    file.close();
+    csv.close();
+}
+
+bool PnLCalculator::exportToColumnar(const std::string& filename) const {
+    TraceScope trace("pnl", "PnLCalculator::exportToColumnar");
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
+    
+    std::string actual_filename = filename.empty() ? "pnl_data.hftc" : filename;
+    
+    ColumnarFileWriter writer(pnl_history.size());
+    writer.addInt64("Timestamp", pnl_history.timestamps().toVector());
+    writer.addFloat64("RealizedPnL", pnl_history.realizedPnL().toVector());
+    writer.addFloat64("UnrealizedPnL", pnl_history.unrealizedPnL().toVector());
+    writer.addFloat64("TotalPnL", pnl_history.totalPnL().toVector());
+    writer.addFloat64("Position", pnl_history.positions().toVector());
+    writer.addFloat64("MarkPrice", pnl_history.markPrices().toVector());
+    writer.addFloat64("DailyPnL", pnl_history.dailyPnL().toVector());
+    writer.addFloat64("CumulativePnL", pnl_history.cumulativePnL().toVector());
+    return writer.write(actual_filename);
 }
 
 std::string PnLCalculator::generateReport() const {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
     
     std::ostringstream oss;
     oss << std::fixed << std::setprecision(2);
     
     oss << "=== PnL Calculator Report ===\n";
-    oss << "Current Position: " << current_position << "\n";
-    oss << "Average Cost: " << average_cost << "\n";
+    oss << "Current Position: " << lot_engine.getPosition() << "\n";
+    oss << "Average Cost: " << lot_engine.getAverageCost() << "\n";
     oss << "Mark Price: " << mark_price << "\n";
-    oss << "Realized PnL: " << realized_pnl.load() << "\n";
-    oss << "Unrealized PnL: " << unrealized_pnl.load() << "\n";
-    oss << "Total PnL: " << total_pnl.load() << "\n";
+    oss << "Realized PnL: " << realized_pnl << "\n";
+    oss << "Unrealized PnL: " << unrealized_pnl << "\n";
+    oss << "Total PnL: " << total_pnl << "\n";
     oss << "Daily PnL: " << daily_pnl << "\n";
     oss << "Daily High: " << daily_high << "\n";
     oss << "Daily Low: " << daily_low << "\n";
     oss << "Max Drawdown: " << max_drawdown << "\n";
-    oss << "Sharpe Ratio: " << getSharpeRatio() << "\n";
-    oss << "Volatility: " << getVolatility() << "\n";
-    oss << "Win Rate: " << (getWinRate() * 100.0) << "%\n";
-    oss << "Profit Factor: " << getProfitFactor() << "\n";
+    oss << "Sharpe Ratio: " << getSharpeRatioUnsafe(return_stats.getWindow()) << "\n";
+    oss << "Volatility: " << getVolatilityUnsafe(return_stats.getWindow()) << "\n";
+    oss << "Win Rate: " << (getWinRateUnsafe() * 100.0) << "%\n";
+    oss << "Profit Factor: " << getProfitFactorUnsafe() << "\n";
     oss << "Total Trades: " << trade_history.size() << "\n";
     oss << "======================\n";
     
@@ -291,19 +372,25 @@ std::string PnLCalculator::generateReport() const {
 }
 
 void PnLCalculator::clear() {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
     
     trade_history.clear();
     pnl_history.clear();
+    pnl_bars.clear();
     returns.clear();
-    
-    current_position = 0.0;
-    average_cost = 0.0;
+    return_stats.clear();
+    winning_trades = 0;
+    losing_trades = 0;
+    gross_profit = 0.0;
+    gross_loss = 0.0;
+    updates_since_snapshot = 0;
+    
+    lot_engine.reset();
     mark_price = 0.0;
     
-    realized_pnl.store(0.0);
-    unrealized_pnl.store(0.0);
-    total_pnl.store(0.0);
+    realized_pnl = 0.0;
+    unrealized_pnl = 0.0;
+    total_pnl = 0.0;
     
     daily_pnl = 0.0;
     daily_high = 0.0;
@@ -311,45 +398,125 @@ void PnLCalculator::clear() {
     
     max_drawdown = 0.0;
     peak_value = 0.0;
+    update_count = 0;
+    
+    publishState();
 }
 
 void PnLCalculator::setMaxHistorySize(size_t size) {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
+    std::lock_guard<ProfiledMutex> lock(pnl_mutex);
     max_history_size = size;
     trimHistory();
+    publishState();
 }
 
 size_t PnLCalculator::getTradeCount() const {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
-    return trade_history.size();
+    return published_state.load().trade_count;
 }
 
 bool PnLCalculator::isEmpty() const {
-    std::lock_guard<std::mutex> lock(pnl_mutex);
-    return trade_history.empty();
+    return published_state.load().trade_count == 0;
 }
 
 void PnLCalculator::addToHistory(const Trade& trade) {
-    trade_history.push_back(trade);
+    trade_history.push(trade);
     
     // Calculate return if we have a previous PnL value
     if (!pnl_history.empty()) {
-        double current_value = total_pnl.load();
-        double previous_value = pnl_history.back().total_pnl;
+        double current_value = total_pnl;
+        double previous_value = pnl_history.backTotalPnL();
         double ret = calculateReturn(current_value, previous_value);
+        if (!returns.empty() && returns.size() >= max_history_size) {
+            returns.pop_front();
+        }
         returns.push_back(ret);
+        return_stats.add(ret);
     }
-    
-    trimHistory();
 }
 
 void PnLCalculator::addToPnLHistory(const PnLSnapshot& snapshot) {
-    pnl_history.push_back(snapshot);
-    trimHistory();
+    pnl_history.push(snapshot);
+}
+
+void PnLCalculator::recordSnapshot() {
+    ++updates_since_snapshot;
+    
+    switch (snapshot_config.policy) {
+        case SnapshotPolicy::EVERY_TICK:
+            addToPnLHistory(makeSnapshot(Clock::wallNow()));
+            break;
+            
+        case SnapshotPolicy::EVERY_N_TICKS:
+            if (updates_since_snapshot >= snapshot_config.every_n_ticks) {
+                addToPnLHistory(makeSnapshot(Clock::wallNow()));
+                updates_since_snapshot = 0;
+            }
+            break;
+            
+        case SnapshotPolicy::ON_CHANGE: {
+            bool changed = pnl_history.empty() ||
+                std::abs(total_pnl - pnl_history.backTotalPnL()) > snapshot_config.change_epsilon ||
+                lot_engine.getPosition() != pnl_history.backPosition();
+            if (changed) {
+                addToPnLHistory(makeSnapshot(Clock::wallNow()));
+                updates_since_snapshot = 0;
+            }
+            break;
+        }
+            
+        case SnapshotPolicy::TIME_BUCKET_OHLC:
+            updateBar(Clock::wallNow());
+            break;
+    }
+}
+
+void PnLCalculator::updateBar(std::chrono::system_clock::time_point now) {
+    auto interval = snapshot_config.bucket_interval;
+    auto bucket_start = std::chrono::system_clock::time_point(
+        (now.time_since_epoch() / interval) * interval);
+    double current_total = total_pnl;
+    
+    if (pnl_bars.empty() || pnl_bars.back().bucket_start != bucket_start) {
+        // Open a new bucket: one bar and one snapshot, both updated in place
+        if (!pnl_bars.empty() && pnl_bars.size() >= max_history_size) {
+            pnl_bars.pop_front();
+        }
+        PnLBar bar;
+        bar.bucket_start = bucket_start;
+        bar.open = current_total;
+        bar.high = current_total;
+        bar.low = current_total;
+        bar.updates = 0;
+        pnl_bars.push_back(bar);
+        addToPnLHistory(makeSnapshot(now));
+    }
+    
+    PnLBar& bar = pnl_bars.back();
+    bar.high = std::max(bar.high, current_total);
+    bar.low = std::min(bar.low, current_total);
+    bar.close = current_total;
+    bar.position = lot_engine.getPosition();
+    bar.mark_price = mark_price;
+    bar.updates++;
+    
+    pnl_history.replaceBack(makeSnapshot(now));
+}
+
+PnLSnapshot PnLCalculator::makeSnapshot(std::chrono::system_clock::time_point now) const {
+    PnLSnapshot snapshot;
+    snapshot.timestamp = now;
+    snapshot.realized_pnl = realized_pnl;
+    snapshot.unrealized_pnl = unrealized_pnl;
+    snapshot.total_pnl = total_pnl;
+    snapshot.position = lot_engine.getPosition();
+    snapshot.mark_price = mark_price;
+    snapshot.daily_pnl = daily_pnl;
+    snapshot.cumulative_pnl = total_pnl;
+    return snapshot;
 }
 
 void PnLCalculator::updateDailyMetrics() {
-    double current_total = total_pnl.load();
+    double current_total = total_pnl;
     
     if (current_total > daily_high) {
         daily_high = current_total;
@@ -362,7 +529,7 @@ void PnLCalculator::updateDailyMetrics() {
 }
 
 void PnLCalculator::updateDrawdownMetrics() {
-    double current_value = total_pnl.load();
+    double current_value = total_pnl;
     
     if (current_value > peak_value) {
         peak_value = current_value;
@@ -374,6 +541,21 @@ void PnLCalculator::updateDrawdownMetrics() {
     }
 }
 
+void PnLCalculator::publishState() {
+    PnLState state;
+    state.realized_pnl = realized_pnl;
+    state.unrealized_pnl = unrealized_pnl;
+    state.total_pnl = total_pnl;
+    state.position = lot_engine.getPosition();
+    state.average_cost = lot_engine.getAverageCost();
+    state.mark_price = mark_price;
+    state.max_drawdown = max_drawdown;
+    state.daily_pnl = daily_pnl;
+    state.trade_count = trade_history.size();
+    state.update_count = update_count;
+    published_state.store(state);
+}
+
 double PnLCalculator::calculateReturn(double current_value, double previous_value) const {
     if (previous_value == 0.0) {
         return 0.0;
@@ -382,35 +564,92 @@ double PnLCalculator::calculateReturn(double current_value, double previous_valu
 }
 
 void PnLCalculator::trimHistory() {
-    if (trade_history.size() > max_history_size) {
-        trade_history.erase(trade_history.begin(), 
-                           trade_history.begin() + (trade_history.size() - max_history_size));
+    if (trade_history.capacity() != max_history_size) {
+        trade_history.setCapacity(max_history_size);
+    }
+    
+    if (pnl_history.capacity() != max_history_size) {
+        pnl_history.setCapacity(max_history_size);
     }
     
-    if (pnl_history.size() > max_history_size) {
-        pnl_history.erase(pnl_history.begin(), 
-                         pnl_history.begin() + (pnl_history.size() - max_history_size));
+    while (pnl_bars.size() > max_history_size) {
+        pnl_bars.pop_front();
     }
     
-    if (returns.size() > max_history_size) {
-        returns.erase(returns.begin(), 
-                     returns.begin() + (returns.size() - max_history_size));
+    while (returns.size() > max_history_size) {
+        returns.pop_front();
     }
 }
 
-double PnLCalculator::calculateVolatility(const std::vector<double>& returns) const {
-    if (returns.empty()) return 0.0;
+double PnLCalculator::getSharpeRatioUnsafe(size_t lookback) const {
+    double mean = 0.0;
+    double variance = 0.0;
+    returnMomentsUnsafe(lookback, mean, variance);
     
-    double mean = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
+    double volatility = std::sqrt(variance);
+    if (volatility == 0.0) return 0.0;
     
+    // Assuming risk-free rate is 0 for simplicity
+    return mean / volatility;
+}
+
+double PnLCalculator::getVolatilityUnsafe(size_t lookback) const {
+    double mean = 0.0;
     double variance = 0.0;
-    for (double ret : returns) {
-        double diff = ret - mean;
-        variance += diff * diff;
+    returnMomentsUnsafe(lookback, mean, variance);
+    return std::sqrt(variance);
+}
+
+double PnLCalculator::getWinRateUnsafe() const {
+    uint64_t closed_trades = winning_trades + losing_trades;
+    if (closed_trades == 0) {
+        return 0.0;
     }
-    variance /= returns.size();
+    return static_cast<double>(winning_trades) / closed_trades;
+}
+
+double PnLCalculator::getProfitFactorUnsafe() const {
+    if (gross_loss == 0.0) {
+        return gross_profit > 0.0 ? std::numeric_limits<double>::max() : 0.0;
+    }
+    return gross_profit / gross_loss;
+}
+
+void PnLCalculator::returnMomentsUnsafe(size_t lookback, double& mean, double& variance) const {
+    mean = 0.0;
+    variance = 0.0;
     
-    return std::sqrt(variance);
+    if (lookback == 0 || returns.size() < lookback) {
+        return;
+    }
+    
+    // O(1) when the lookback matches the streaming window
+    if (lookback == return_stats.getWindow()) {
+        mean = return_stats.mean();
+        variance = return_stats.variance();
+        return;
+    }
+    
+    // Other lookbacks: two vectorized passes over the tail of the ring,
+    // which is at most two contiguous spans
+    RingView<double> view = returns.view();
+    size_t skip = returns.size() - lookback;
+    Span<const double> head = view.getFirst();
+    size_t head_skip = std::min(skip, head.size());
+    const double* a = head.data() + head_skip;
+    size_t a_len = head.size() - head_skip;
+    const double* b = view.getSecond().data() + (skip - head_skip);
+    size_t b_len = lookback - a_len;
+    
+    mean = (kernels::sum(a, a_len) + kernels::sum(b, b_len)) / lookback;
+    variance = (kernels::sumSquaredDeviations(a, a_len, mean) +
+                kernels::sumSquaredDeviations(b, b_len, mean)) / lookback;
+}
+
+double PnLCalculator::calculateVolatility(const std::vector<double>& returns) const {
+    if (returns.empty()) return 0.0;
+    
+    return std::sqrt(kernels::variance(returns.data(), returns.size(), false));
 }
 
 double PnLCalculator::calculateSharpeRatio(const std::vector<double>& returns) const {
@@ -419,30 +658,14 @@ double PnLCalculator::calculateSharpeRatio(const std::vector<double>& returns) c
     double volatility = calculateVolatility(returns);
     if (volatility == 0.0) return 0.0;
     
-    double mean_return = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
+    double mean_return = kernels::mean(returns.data(), returns.size());
     
     // Assuming risk-free rate is 0 for simplicity
     return mean_return / volatility;
 }
 
 double PnLCalculator::calculateMaxDrawdown(const std::vector<double>& values) const {
-    if (values.empty()) return 0.0;
-    
-    double max_dd = 0.0;
-    double peak = values[0];
-    
-    for (double value : values) {
-        if (value > peak) {
-            peak = value;
-        }
-        
-        double drawdown = peak - value;
-        if (drawdown > max_dd) {
-            max_dd = drawdown;
-        }
-    }
-    
-    return max_dd;
+    return kernels::maxDrawdown(values.data(), values.size());
 }
 
 } // namespace hft
@@ -0,0 +1,216 @@
+#include "PnLHistory.h"
+#include <cstring>
+
+namespace hft {
+
+namespace {
+
+int64_t toNanos(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point fromNanos(int64_t nanos) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(nanos)));
+}
+
+// Fixed-size on-disk rows (timestamp first, as SpillLog expects)
+struct TradeRow {
+    int64_t timestamp_ns;
+    double price;
+    double quantity;
+    double side;
+    double trade_value;
+    uint64_t trade_id;
+};
+
+struct SnapshotRow {
+    int64_t timestamp_ns;
+    double realized_pnl;
+    double unrealized_pnl;
+    double total_pnl;
+    double position;
+    double mark_price;
+    double daily_pnl;
+    double cumulative_pnl;
+};
+
+template<typename Row>
+Row readRow(const void* record) {
+    Row row;
+    std::memcpy(&row, record, sizeof(Row));
+    return row;
+}
+
+Trade toTrade(const TradeRow& row) {
+    return Trade{fromNanos(row.timestamp_ns), row.price, row.quantity, row.side,
+                 row.trade_value, row.trade_id};
+}
+
+PnLSnapshot toSnapshot(const SnapshotRow& row) {
+    return PnLSnapshot{fromNanos(row.timestamp_ns), row.realized_pnl, row.unrealized_pnl,
+                       row.total_pnl, row.position, row.mark_price, row.daily_pnl,
+                       row.cumulative_pnl};
+}
+
+} // namespace
+
+TradeHistory::TradeHistory(size_t capacity) : ColumnarRing<TradeHistory>(capacity) {
+    initColumns();
+}
+
+void TradeHistory::push(const Trade& trade) {
+    size_t slot = appendSlot();
+    timestamp_ns[slot] = toNanos(trade.timestamp);
+    price[slot] = trade.price;
+    quantity[slot] = trade.quantity;
+    side[slot] = trade.side;
+    trade_value[slot] = trade.trade_value;
+    trade_id[slot] = trade.trade_id;
+}
+
+void TradeHistory::clear() {
+    ColumnarRing<TradeHistory>::clear();
+    if (spill) {
+        spill->clear();
+    }
+}
+
+bool TradeHistory::enableSpill(const std::string& directory, size_t segment_rows) {
+    // Close the current log first: it trims its segment files on close, and
+    // the new log reopens the same paths in the same directory
+    spill.reset();
+    spill.reset(new SpillLog(directory, "trades", sizeof(TradeRow), segment_rows));
+    if (!spill->isOpen()) {
+        spill.reset();
+        return false;
+    }
+    return true;
+}
+
+std::vector<Trade> TradeHistory::range(std::chrono::system_clock::time_point from,
+                                       std::chrono::system_clock::time_point to) const {
+    std::vector<Trade> result;
+    int64_t from_ns = toNanos(from);
+    int64_t to_ns = toNanos(to);
+    
+    if (spill) {
+        spill->forEachInRange(from_ns, to_ns, [&result](const void* record) {
+            result.push_back(toTrade(readRow<TradeRow>(record)));
+        });
+    }
+    for (size_t i = 0; i < count; ++i) {
+        int64_t ts = timestamp_ns[slot(i)];
+        if (ts >= from_ns && ts <= to_ns) {
+            result.push_back((*this)[i]);
+        }
+    }
+    return result;
+}
+
+void TradeHistory::evictRow(size_t s) {
+    if (!spill) {
+        return;
+    }
+    TradeRow row{timestamp_ns[s], price[s], quantity[s], side[s], trade_value[s], trade_id[s]};
+    spill->append(&row);
+}
+
+Trade TradeHistory::operator[](size_t i) const {
+    size_t s = slot(i);
+    Trade trade;
+    trade.timestamp = fromNanos(timestamp_ns[s]);
+    trade.price = price[s];
+    trade.quantity = quantity[s];
+    trade.side = side[s];
+    trade.trade_value = trade_value[s];
+    trade.trade_id = trade_id[s];
+    return trade;
+}
+
+PnLHistory::PnLHistory(size_t capacity) : ColumnarRing<PnLHistory>(capacity) {
+    initColumns();
+}
+
+void PnLHistory::push(const PnLSnapshot& snapshot) {
+    write(appendSlot(), snapshot);
+}
+
+void PnLHistory::replaceBack(const PnLSnapshot& snapshot) {
+    write(backSlot(), snapshot);
+}
+
+void PnLHistory::clear() {
+    ColumnarRing<PnLHistory>::clear();
+    if (spill) {
+        spill->clear();
+    }
+}
+
+bool PnLHistory::enableSpill(const std::string& directory, size_t segment_rows) {
+    // Close the current log first: it trims its segment files on close, and
+    // the new log reopens the same paths in the same directory
+    spill.reset();
+    spill.reset(new SpillLog(directory, "pnl", sizeof(SnapshotRow), segment_rows));
+    if (!spill->isOpen()) {
+        spill.reset();
+        return false;
+    }
+    return true;
+}
+
+std::vector<PnLSnapshot> PnLHistory::range(std::chrono::system_clock::time_point from,
+                                           std::chrono::system_clock::time_point to) const {
+    std::vector<PnLSnapshot> result;
+    int64_t from_ns = toNanos(from);
+    int64_t to_ns = toNanos(to);
+    
+    if (spill) {
+        spill->forEachInRange(from_ns, to_ns, [&result](const void* record) {
+            result.push_back(toSnapshot(readRow<SnapshotRow>(record)));
+        });
+    }
+    for (size_t i = 0; i < count; ++i) {
+        int64_t ts = timestamp_ns[slot(i)];
+        if (ts >= from_ns && ts <= to_ns) {
+            result.push_back((*this)[i]);
+        }
+    }
+    return result;
+}
+
+void PnLHistory::evictRow(size_t s) {
+    if (!spill) {
+        return;
+    }
+    SnapshotRow row{timestamp_ns[s], realized_pnl[s], unrealized_pnl[s], total_pnl[s],
+                    position[s], mark_price[s], daily_pnl[s], cumulative_pnl[s]};
+    spill->append(&row);
+}
+
+PnLSnapshot PnLHistory::operator[](size_t i) const {
+    size_t s = slot(i);
+    PnLSnapshot snapshot;
+    snapshot.timestamp = fromNanos(timestamp_ns[s]);
+    snapshot.realized_pnl = realized_pnl[s];
+    snapshot.unrealized_pnl = unrealized_pnl[s];
+    snapshot.total_pnl = total_pnl[s];
+    snapshot.position = position[s];
+    snapshot.mark_price = mark_price[s];
+    snapshot.daily_pnl = daily_pnl[s];
+    snapshot.cumulative_pnl = cumulative_pnl[s];
+    return snapshot;
+}
+
+void PnLHistory::write(size_t slot, const PnLSnapshot& snapshot) {
+    timestamp_ns[slot] = toNanos(snapshot.timestamp);
+    realized_pnl[slot] = snapshot.realized_pnl;
+    unrealized_pnl[slot] = snapshot.unrealized_pnl;
+    total_pnl[slot] = snapshot.total_pnl;
+    position[slot] = snapshot.position;
+    mark_price[slot] = snapshot.mark_price;
+    daily_pnl[slot] = snapshot.daily_pnl;
+    cumulative_pnl[slot] = snapshot.cumulative_pnl;
+}
+
+} // namespace hft
@@ -0,0 +1,334 @@
+#include "PortfolioPnL.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+namespace hft {
+
+namespace {
+// Below this many slots per worker a single pass beats waking the pool
+constexpr size_t MIN_SLOTS_PER_WORKER = 4096;
+
+// Lot ring size given to a new slot (must be a power of two)
+constexpr uint32_t INITIAL_SLOT_LOTS = 8;
+
+size_t defaultWorkers(size_t threads) {
+    return threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+uint64_t slotKey(StrategyId strategy, SymbolId symbol) {
+    return (static_cast<uint64_t>(strategy) << 32) | symbol;
+}
+}
+
+struct PortfolioPnL::SlotLots {
+    PortfolioPnL& book;
+    uint32_t slot;
+
+    bool empty() const { return book.lot_count[slot] == 0; }
+    Lot& front() { return book.lotAt(slot, 0); }
+    Lot& back() { return book.lotAt(slot, book.lot_count[slot] - 1); }
+    void pop_front() {
+        book.lot_head[slot] = (book.lot_head[slot] + 1) & (book.lot_capacity[slot] - 1);
+        --book.lot_count[slot];
+    }
+    void pop_back() { --book.lot_count[slot]; }
+};
+
+PortfolioPnL::PortfolioPnL(CostBasisMethod method, size_t threads)
+    : lot_pool_dead(0), cost_method(method), workers(defaultWorkers(threads)) {
+}
+
+SymbolId PortfolioPnL::registerSymbol(const std::string& symbol) {
+    std::lock_guard<std::mutex> lock(portfolio_mutex);
+    
+    auto it = symbol_ids.find(symbol);
+    if (it != symbol_ids.end()) {
+        return it->second;
+    }
+    
+    SymbolId id = static_cast<SymbolId>(symbol_names.size());
+    symbol_ids.emplace(symbol, id);
+    symbol_names.push_back(symbol);
+    symbol_marks.push_back(0.0);
+    return id;
+}
+
+StrategyId PortfolioPnL::registerStrategy(const std::string& strategy) {
+    std::lock_guard<std::mutex> lock(portfolio_mutex);
+    
+    auto it = strategy_ids.find(strategy);
+    if (it != strategy_ids.end()) {
+        return it->second;
+    }
+    
+    StrategyId id = static_cast<StrategyId>(strategy_names.size());
+    strategy_ids.emplace(strategy, id);
+    strategy_names.push_back(strategy);
+    return id;
+}
+
+SymbolId PortfolioPnL::getSymbolId(const std::string& symbol) const {
+    std::lock_guard<std::mutex> lock(portfolio_mutex);
+    
+    auto it = symbol_ids.find(symbol);
+    if (it == symbol_ids.end()) {
+        throw std::out_of_range("Unknown symbol: " + symbol);
+    }
+    return it->second;
+}
+
+std::string PortfolioPnL::getSymbolName(SymbolId id) const {
+    std::lock_guard<std::mutex> lock(portfolio_mutex);
+    return symbol_names.at(id);
+}
+
+size_t PortfolioPnL::getSymbolCount() const {
+    std::lock_guard<std::mutex> lock(portfolio_mutex);
+    return symbol_names.size();
+}
+
+size_t PortfolioPnL::getSlotCount() const {
+    std::lock_guard<std::mutex> lock(portfolio_mutex);
+    return slot_symbol.size();
+}
+
+size_t PortfolioPnL::getOpenLotCount(StrategyId strategy, SymbolId symbol) const {
+    std::lock_guard<std::mutex> lock(portfolio_mutex);
+    
+    auto it = slot_lookup.find(slotKey(strategy, symbol));
+    if (it == slot_lookup.end()) {
+        return 0;
+    }
+    if (cost_method == CostBasisMethod::AVERAGE_COST) {
+        return position[it->second] != 0.0 ? 1 : 0;
+    }
+    return lot_count[it->second];
+}
+
+double PortfolioPnL::applyFill(StrategyId strategy, SymbolId symbol, double quantity, double price) {
+    std::lock_guard<std::mutex> lock(portfolio_mutex);
+    
+    if (symbol >= symbol_names.size() || strategy >= strategy_names.size()) {
+        throw std::out_of_range("Fill for unregistered symbol or strategy");
+    }
+    
+    uint32_t slot = getOrCreateSlot(strategy, symbol);
+    double realized_delta = 0.0;
+    
+    if (quantity != 0.0) {
+        // LotEngine's matching step, run against the slot's ring in lot_pool
+        SlotLots lots{*this, slot};
+        double open_quantity;
+        realized_delta = LotEngine::matchFill(cost_method, lots, position[slot], open_cost[slot],
+                                              quantity, price, open_quantity);
+        if (open_quantity != 0.0) {
+            pushLot(slot, Lot{open_quantity, price});
+        }
+        realized[slot] += realized_delta;
+    }
+    
+    double mark = symbol_marks[symbol];
+    unrealized[slot] = mark > 0.0 ? position[slot] * mark - open_cost[slot] : 0.0;
+    
+    return realized_delta;
+}
+
+void PortfolioPnL::updateMark(SymbolId symbol, double price) {
+    std::lock_guard<std::mutex> lock(portfolio_mutex);
+    
+    if (symbol >= symbol_marks.size()) {
+        throw std::out_of_range("Mark for unregistered symbol");
+    }
+    symbol_marks[symbol] = price;
+    
+    // Single-symbol update: only touch that symbol's slots
+    for (size_t i = 0; i < slot_symbol.size(); ++i) {
+        if (slot_symbol[i] == symbol) {
+            unrealized[i] = price > 0.0 ? position[i] * price - open_cost[i] : 0.0;
+        }
+    }
+}
+
+void PortfolioPnL::markToMarket(const double* marks, size_t count) {
+    std::lock_guard<std::mutex> lock(portfolio_mutex);
+    
+    size_t n = std::min(count, symbol_marks.size());
+    std::copy(marks, marks + n, symbol_marks.begin());
+    revalueAll();
+}
+
+PnLTotals PortfolioPnL::getBookTotals() const {
+    std::lock_guard<std::mutex> lock(portfolio_mutex);
+    
+    size_t slots = slot_symbol.size();
+    size_t chunks = std::min(workers.size(), std::max<size_t>(1, slots / MIN_SLOTS_PER_WORKER));
+    if (chunks <= 1) {
+        return reduceRange(0, slots);
+    }
+    
+    // Each pool thread reduces one contiguous chunk of slots
+    std::vector<PnLTotals> partials(chunks);
+    size_t chunk = (slots + chunks - 1) / chunks;
+    auto reduce_chunk = [this, &partials, chunk, slots](size_t c) {
+        size_t begin = std::min(slots, c * chunk);
+        partials[c] = reduceRange(begin, std::min(slots, begin + chunk));
+    };
+    workers.run(chunks, reduce_chunk);
+    
+    // Combine partial sums pairwise (tree reduction)
+    for (size_t stride = 1; stride < chunks; stride *= 2) {
+        for (size_t i = 0; i + stride < chunks; i += 2 * stride) {
+            partials[i] += partials[i + stride];
+        }
+    }
+    
+    return partials[0];
+}
+
+std::vector<PnLTotals> PortfolioPnL::getTotalsBySymbol() const {
+    std::lock_guard<std::mutex> lock(portfolio_mutex);
+    
+    std::vector<PnLTotals> totals(symbol_names.size());
+    for (size_t i = 0; i < slot_symbol.size(); ++i) {
+        totals[slot_symbol[i]] += slotTotals(i);
+    }
+    return totals;
+}
+
+std::vector<PnLTotals> PortfolioPnL::getTotalsByStrategy() const {
+    std::lock_guard<std::mutex> lock(portfolio_mutex);
+    
+    std::vector<PnLTotals> totals(strategy_names.size());
+    for (size_t i = 0; i < slot_strategy.size(); ++i) {
+        totals[slot_strategy[i]] += slotTotals(i);
+    }
+    return totals;
+}
+
+double PortfolioPnL::getPosition(StrategyId strategy, SymbolId symbol) const {
+    std::lock_guard<std::mutex> lock(portfolio_mutex);
+    
+    auto it = slot_lookup.find(slotKey(strategy, symbol));
+    return it != slot_lookup.end() ? position[it->second] : 0.0;
+}
+
+void PortfolioPnL::setWorkerThreads(size_t threads) {
+    std::lock_guard<std::mutex> lock(portfolio_mutex);
+    workers.resize(threads);
+}
+
+void PortfolioPnL::clear() {
+    std::lock_guard<std::mutex> lock(portfolio_mutex);
+    
+    slot_lookup.clear();
+    slot_symbol.clear();
+    slot_strategy.clear();
+    position.clear();
+    open_cost.clear();
+    realized.clear();
+    unrealized.clear();
+    lot_pool.clear();
+    lot_offset.clear();
+    lot_capacity.clear();
+    lot_head.clear();
+    lot_count.clear();
+    lot_pool_dead = 0;
+    std::fill(symbol_marks.begin(), symbol_marks.end(), 0.0);
+}
+
+uint32_t PortfolioPnL::getOrCreateSlot(StrategyId strategy, SymbolId symbol) {
+    auto it = slot_lookup.find(slotKey(strategy, symbol));
+    if (it != slot_lookup.end()) {
+        return it->second;
+    }
+    
+    uint32_t slot = static_cast<uint32_t>(slot_symbol.size());
+    slot_lookup.emplace(slotKey(strategy, symbol), slot);
+    slot_symbol.push_back(symbol);
+    slot_strategy.push_back(strategy);
+    position.push_back(0.0);
+    open_cost.push_back(0.0);
+    realized.push_back(0.0);
+    unrealized.push_back(0.0);
+    
+    uint32_t lots = cost_method == CostBasisMethod::AVERAGE_COST ? 0 : INITIAL_SLOT_LOTS;
+    lot_offset.push_back(static_cast<uint32_t>(lot_pool.size()));
+    lot_capacity.push_back(lots);
+    lot_head.push_back(0);
+    lot_count.push_back(0);
+    lot_pool.resize(lot_pool.size() + lots);
+    return slot;
+}
+
+void PortfolioPnL::revalueAll() {
+    const size_t slots = slot_symbol.size();
+    const SymbolId* symbols = slot_symbol.data();
+    const double* marks = symbol_marks.data();
+    const double* pos = position.data();
+    const double* cost = open_cost.data();
+    double* upnl = unrealized.data();
+    
+    // One branch-free pass over every slot
+    for (size_t i = 0; i < slots; ++i) {
+        double mark = marks[symbols[i]];
+        double value = pos[i] * mark - cost[i];
+        upnl[i] = mark > 0.0 ? value : 0.0;
+    }
+}
+
+void PortfolioPnL::pushLot(uint32_t slot, const Lot& lot) {
+    if (lot_count[slot] == lot_capacity[slot]) {
+        // Full ring: move it to a region twice the size at the end of the pool
+        lot_pool_dead += lot_capacity[slot];
+        moveLots(slot, lot_capacity[slot] * 2, lot_pool);
+        if (lot_pool_dead > lot_pool.size() / 2) {
+            compactLots();
+        }
+    }
+    lotAt(slot, lot_count[slot]++) = lot;
+}
+
+void PortfolioPnL::moveLots(uint32_t slot, uint32_t capacity, std::vector<Lot>& pool) {
+    size_t offset = pool.size();
+    pool.resize(offset + capacity);
+    for (uint32_t i = 0; i < lot_count[slot]; ++i) {
+        pool[offset + i] = lotAt(slot, i);
+    }
+    lot_offset[slot] = static_cast<uint32_t>(offset);
+    lot_capacity[slot] = capacity;
+    lot_head[slot] = 0;
+}
+
+void PortfolioPnL::compactLots() {
+    // Repack every ring in slot order, dropping the regions left behind by moves
+    std::vector<Lot> packed;
+    packed.reserve(lot_pool.size() - lot_pool_dead);
+    for (uint32_t slot = 0; slot < lot_offset.size(); ++slot) {
+        moveLots(slot, lot_capacity[slot], packed);
+    }
+    lot_pool.swap(packed);
+    lot_pool_dead = 0;
+}
+
+PnLTotals PortfolioPnL::reduceRange(size_t begin, size_t end) const {
+    PnLTotals totals;
+    for (size_t i = begin; i < end; ++i) {
+        totals += slotTotals(i);
+    }
+    return totals;
+}
+
+PnLTotals PortfolioPnL::slotTotals(size_t slot) const {
+    PnLTotals totals;
+    double exposure = position[slot] * symbol_marks[slot_symbol[slot]];
+    totals.realized_pnl = realized[slot];
+    totals.unrealized_pnl = unrealized[slot];
+    totals.total_pnl = realized[slot] + unrealized[slot];
+    totals.net_exposure = exposure;
+    totals.gross_exposure = std::abs(exposure);
+    return totals;
+}
+
+} // namespace hft
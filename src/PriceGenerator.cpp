@@ -1,8 +1,10 @@
 #include "PriceGenerator.h"
+#include "NumericKernels.h"
+#include "Trace.h"
+#include "Clock.h"
 #include <cmath>
 #include <algorithm>
 #include <stdexcept>
-#include <mutex>
 
 namespace hft {
 
@@ -11,21 +13,17 @@ PriceGenerator::PriceGenerator(double initial_p, double drift_rate, double vol,
     : initial_price(initial_p), current_price(initial_p), drift(drift_rate), 
       volatility(vol), time_step(time_step_years), history_window(history_size) {
     
-    // Initialize random number generator with current time
-    auto now = std::chrono::system_clock::now();
-    auto time_since_epoch = now.time_since_epoch();
-    auto seed = static_cast<uint32_t>(time_since_epoch.count());
-    rng.seed(seed);
-    
-    // Initialize normal distribution
-    normal_dist = std::normal_distribution<double>(0.0, 1.0);
+    // Derive this generator's seed from the thread stream so runs with a
+    // fixed master seed are reproducible
+    rng.seed(rng::threadGenerator()());
     
     // Initialize price history
     price_history.push_back(initial_price);
 }
 
 double PriceGenerator::generateNextPrice() {
-    std::lock_guard<std::mutex> lock(price_mutex);
+    TraceScope trace("price", "PriceGenerator::generateNextPrice");
+    std::lock_guard<ProfiledMutex> lock(price_mutex);
     
     double random_shock = getRandomShock();
     double new_price = calculateGBMPrice(current_price, drift, volatility, time_step, random_shock);
@@ -34,12 +32,13 @@ double PriceGenerator::generateNextPrice() {
     updatePriceStatistics(new_price);
     addToHistory(new_price);
     ticks_generated++;
+    last_tick_ticks.store(Clock::nowPrecise(), std::memory_order_release);
     
     return new_price;
 }
 
 double PriceGenerator::generateNextPrice(double current_p) {
-    std::lock_guard<std::mutex> lock(price_mutex);
+    std::lock_guard<ProfiledMutex> lock(price_mutex);
     
     double random_shock = getRandomShock();
     double new_price = calculateGBMPrice(current_p, drift, volatility, time_step, random_shock);
@@ -48,23 +47,31 @@ double PriceGenerator::generateNextPrice(double current_p) {
     updatePriceStatistics(new_price);
     addToHistory(new_price);
     ticks_generated++;
+    last_tick_ticks.store(Clock::nowPrecise(), std::memory_order_release);
     
     return new_price;
 }
 
 std::vector<double> PriceGenerator::generatePriceSeries(size_t count) {
-    std::vector<double> prices;
-    prices.reserve(count);
+    std::vector<double> prices(count);
+    std::lock_guard<ProfiledMutex> lock(price_mutex);
     
+    // Draw all shocks in one batch, then walk the path in place
+    rng.fillNormal(prices.data(), count);
     for (size_t i = 0; i < count; ++i) {
-        prices.push_back(generateNextPrice());
+        current_price = calculateGBMPrice(current_price, drift, volatility, time_step, prices[i]);
+        prices[i] = current_price;
+        updatePriceStatistics(current_price);
+        addToHistory(current_price);
     }
+    ticks_generated += count;
+    last_tick_ticks.store(Clock::nowPrecise(), std::memory_order_release);
     
     return prices;
 }
 
 double PriceGenerator::calculateRealizedVolatility(size_t lookback) const {
-    std::lock_guard<std::mutex> lock(price_mutex);
+    std::lock_guard<ProfiledMutex> lock(price_mutex);
     
     if (price_history.size() < lookback + 1) {
         return 0.0;
@@ -85,20 +92,7 @@ double PriceGenerator::calculateRealizedVolatility(size_t lookback) const {
     
     if (returns.empty()) return 0.0;
     
-    // Calculate mean return
-    double mean_return = 0.0;
-    for (double ret : returns) {
-        mean_return += ret;
-    }
-    mean_return /= returns.size();
-    
-    // Calculate variance
-    double variance = 0.0;
-    for (double ret : returns) {
-        double diff = ret - mean_return;
-        variance += diff * diff;
-    }
-    variance /= returns.size();
+    double variance = kernels::variance(returns.data(), returns.size(), false);
     
     // Annualize volatility (assuming time_step is in years)
     double daily_vol = std::sqrt(variance);
@@ -112,27 +106,27 @@ double PriceGenerator::calculateRollingVolatility(size_t window) const {
 }
 
 double PriceGenerator::getCurrentPrice() const {
-    std::lock_guard<std::mutex> lock(price_mutex);
+    std::lock_guard<ProfiledMutex> lock(price_mutex);
     return current_price;
 }
 
 void PriceGenerator::updateDrift(double new_drift) {
-    std::lock_guard<std::mutex> lock(price_mutex);
+    std::lock_guard<ProfiledMutex> lock(price_mutex);
     drift = new_drift;
 }
 
 void PriceGenerator::updateVolatility(double new_vol) {
-    std::lock_guard<std::mutex> lock(price_mutex);
+    std::lock_guard<ProfiledMutex> lock(price_mutex);
     volatility = new_vol;
 }
 
 void PriceGenerator::updateTimeStep(double new_time_step) {
-    std::lock_guard<std::mutex> lock(price_mutex);
+    std::lock_guard<ProfiledMutex> lock(price_mutex);
     time_step = new_time_step;
 }
 
 void PriceGenerator::reset(double new_initial_price) {
-    std::lock_guard<std::mutex> lock(price_mutex);
+    std::lock_guard<ProfiledMutex> lock(price_mutex);
     
     initial_price = new_initial_price;
     current_price = new_initial_price;
@@ -144,8 +138,8 @@ void PriceGenerator::reset(double new_initial_price) {
     max_price = std::numeric_limits<double>::lowest();
 }
 
-void PriceGenerator::setSeed(uint32_t seed) {
-    std::lock_guard<std::mutex> lock(price_mutex);
+void PriceGenerator::setSeed(uint64_t seed) {
+    std::lock_guard<ProfiledMutex> lock(price_mutex);
     rng.seed(seed);
 }
 
@@ -193,7 +187,7 @@ void PriceGenerator::addToHistory(double price) {
 }
 
 double PriceGenerator::getRandomShock() {
-    return normal_dist(rng);
+    return rng.normal();
 }
 
 } // namespace hft
@@ -0,0 +1,76 @@
+#include "ProfiledMutex.h"
+#include <cstdio>
+#include <map>
+#include <memory>
+
+namespace hft {
+
+namespace {
+
+std::mutex& registryMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+// unique_ptr keeps LockStats addresses stable as the map grows
+std::map<std::string, std::unique_ptr<LockStats>>& registry() {
+    static std::map<std::string, std::unique_ptr<LockStats>> entries;
+    return entries;
+}
+
+} // namespace
+
+LockStats& LockProfiler::stats(const char* name) {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    auto& entry = registry()[name];
+    if (!entry) {
+        entry.reset(new LockStats(name));
+    }
+    return *entry;
+}
+
+std::vector<const LockStats*> LockProfiler::all() {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    std::vector<const LockStats*> out;
+    for (const auto& entry : registry()) {
+        out.push_back(entry.second.get());
+    }
+    return out;
+}
+
+void LockProfiler::reset() {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    for (auto& entry : registry()) {
+        LockStats& stats = *entry.second;
+        stats.acquisitions.store(0, std::memory_order_relaxed);
+        stats.contended.store(0, std::memory_order_relaxed);
+        stats.wait_ns.reset();
+        stats.hold_ns.reset();
+    }
+}
+
+std::string LockProfiler::report() {
+    if (!isEnabled()) {
+        return "  Lock profiling disabled (build with HFT_LOCK_PROFILING)\n";
+    }
+    std::string out;
+    for (const LockStats* stats : all()) {
+        uint64_t acquisitions = stats->acquisitions.load(std::memory_order_relaxed);
+        uint64_t contended = stats->contended.load(std::memory_order_relaxed);
+        char line[160];
+        std::snprintf(line, sizeof(line), "  %s: %llu acquisitions, %llu contended (%.2f%%), total wait %s\n",
+                      stats->name.c_str(), static_cast<unsigned long long>(acquisitions),
+                      static_cast<unsigned long long>(contended),
+                      acquisitions > 0 ? 100.0 * contended / acquisitions : 0.0,
+                      formatNanos(static_cast<double>(stats->wait_ns.getTotal())).c_str());
+        out += line;
+        out += "    wait: " + stats->wait_ns.summary() + "\n";
+        out += "    hold: " + stats->hold_ns.summary() + "\n";
+    }
+    if (out.empty()) {
+        out = "  No profiled locks\n";
+    }
+    return out;
+}
+
+} // namespace hft
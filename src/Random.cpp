@@ -0,0 +1,236 @@
+#include "Random.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <random>
+#include <vector>
+
+namespace hft {
+
+namespace {
+
+constexpr double TWO_PI = 6.283185307179586476925286766559;
+
+// Uniform in (0, 1], safe to take the log of
+double openUniform(uint64_t bits) {
+    return (static_cast<double>(bits >> 11) + 1.0) * 0x1.0p-53;
+}
+
+} // namespace
+
+uint64_t Xoshiro256pp::splitMix64(uint64_t& x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void Xoshiro256pp::seed(uint64_t seed_value) {
+    uint64_t x = seed_value;
+    for (uint64_t& word : state) {
+        word = splitMix64(x);
+    }
+    has_spare = false;
+    spare_normal = 0.0;
+}
+
+void Xoshiro256pp::jump() {
+    static const uint64_t JUMP[] = {0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+                                    0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL};
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (uint64_t word : JUMP) {
+        for (int b = 0; b < 64; ++b) {
+            if (word & (uint64_t{1} << b)) {
+                s0 ^= state[0];
+                s1 ^= state[1];
+                s2 ^= state[2];
+                s3 ^= state[3];
+            }
+            (*this)();
+        }
+    }
+    state[0] = s0;
+    state[1] = s1;
+    state[2] = s2;
+    state[3] = s3;
+    has_spare = false;
+}
+
+int64_t Xoshiro256pp::uniformInt(int64_t min_value, int64_t max_value) {
+    if (max_value <= min_value) {
+        return min_value;
+    }
+    uint64_t range = static_cast<uint64_t>(max_value) - static_cast<uint64_t>(min_value) + 1;
+    if (range == 0) {
+        return static_cast<int64_t>((*this)());  // Full 64-bit range
+    }
+
+    // Reject the lowest 2^64 mod range outputs so every residue is equally likely
+    uint64_t threshold = (0 - range) % range;
+    uint64_t x = (*this)();
+    while (x < threshold) {
+        x = (*this)();
+    }
+    return static_cast<int64_t>(static_cast<uint64_t>(min_value) + x % range);
+}
+
+double Xoshiro256pp::normal() {
+    if (has_spare) {
+        has_spare = false;
+        return spare_normal;
+    }
+    // Box-Muller: one log/sqrt and one sincos per two normals
+    double radius = std::sqrt(-2.0 * std::log(openUniform((*this)())));
+    double angle = TWO_PI * nextDouble();
+    spare_normal = radius * std::sin(angle);
+    has_spare = true;
+    return radius * std::cos(angle);
+}
+
+double Xoshiro256pp::exponential(double rate) {
+    return -std::log(openUniform((*this)())) / rate;
+}
+
+void Xoshiro256pp::fillUniform(double* out, size_t n, double min_value, double max_value) {
+    double scale = (max_value - min_value) * 0x1.0p-53;
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = min_value + static_cast<double>((*this)() >> 11) * scale;
+    }
+}
+
+void Xoshiro256pp::fillNormal(double* out, size_t n, double mean, double stddev) {
+    size_t i = 0;
+    if (has_spare && n > 0) {
+        out[i++] = mean + stddev * spare_normal;
+        has_spare = false;
+    }
+
+    // Draw the uniforms for a whole run of pairs first, then transform them in a
+    // separate loop without the generator's serial dependency
+    constexpr size_t CHUNK = 256;
+    double u1[CHUNK / 2];
+    double u2[CHUNK / 2];
+    while (i + 1 < n) {
+        size_t pairs = std::min((n - i) / 2, CHUNK / 2);
+        for (size_t p = 0; p < pairs; ++p) {
+            u1[p] = openUniform((*this)());
+            u2[p] = nextDouble();
+        }
+        for (size_t p = 0; p < pairs; ++p) {
+            double radius = stddev * std::sqrt(-2.0 * std::log(u1[p]));
+            double angle = TWO_PI * u2[p];
+            out[i + 2 * p] = mean + radius * std::cos(angle);
+            out[i + 2 * p + 1] = mean + radius * std::sin(angle);
+        }
+        i += 2 * pairs;
+    }
+    if (i < n) {
+        out[i] = mean + stddev * normal();
+    }
+}
+
+void Xoshiro256pp::fillExponential(double* out, size_t n, double rate) {
+    double inv_rate = 1.0 / rate;
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = openUniform((*this)());
+    }
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = -std::log(out[i]) * inv_rate;
+    }
+}
+
+namespace rng {
+
+namespace {
+
+uint64_t initialMasterSeed() {
+    std::random_device rd;
+    return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+}
+
+std::atomic<uint64_t> master_seed{initialMasterSeed()};
+std::atomic<uint64_t> seed_generation{1};   // Bumped by setMasterSeed
+std::atomic<uint64_t> next_stream{RESERVED_STREAMS};  // Next stream index handed to a new thread
+
+// Start of every stream handed out so far under one (generation, seed): a
+// new stream costs one jump past the furthest cached start instead of
+// `stream` jumps from the master, however many threads came before it
+struct StreamStarts {
+    std::mutex mutex;
+    uint64_t generation = 0;
+    uint64_t seed = 0;
+    std::vector<Xoshiro256pp> starts;  // starts[i]: master jumped i times
+};
+
+Xoshiro256pp streamStart(uint64_t generation, uint64_t seed, uint64_t stream) {
+    static StreamStarts cache;
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    if (cache.starts.empty() || cache.generation != generation || cache.seed != seed) {
+        cache.generation = generation;
+        cache.seed = seed;
+        cache.starts.assign(1, Xoshiro256pp(seed));
+    }
+    while (cache.starts.size() <= stream) {
+        Xoshiro256pp next = cache.starts.back();
+        next.jump();
+        cache.starts.push_back(next);
+    }
+    return cache.starts[stream];
+}
+
+struct ThreadState {
+    Xoshiro256pp generator;
+    uint64_t stream = 0;
+    uint64_t generation = 0;  // 0: not seeded yet
+    bool bound = false;
+
+    void reseed() {
+        if (!bound) {
+            stream = next_stream.fetch_add(1, std::memory_order_relaxed);
+            bound = true;
+        }
+        // Generation first: the acquire makes the seed stored before it
+        // visible. A setMasterSeed racing in between leaves a newer seed
+        // with an older generation, which the next draw reseeds again
+        uint64_t seen_generation = seed_generation.load(std::memory_order_acquire);
+        generator = streamStart(seen_generation, master_seed.load(std::memory_order_relaxed), stream);
+        generation = seen_generation;
+    }
+};
+
+thread_local ThreadState thread_state;
+
+} // namespace
+
+void setMasterSeed(uint64_t seed) {
+    master_seed.store(seed, std::memory_order_relaxed);
+    seed_generation.fetch_add(1, std::memory_order_release);
+}
+
+uint64_t getMasterSeed() {
+    return master_seed.load(std::memory_order_relaxed);
+}
+
+void bindThreadStream(uint64_t stream_index) {
+    thread_state.stream = stream_index;
+    thread_state.bound = true;
+    thread_state.reseed();
+}
+
+uint64_t getThreadStream() {
+    threadGenerator();
+    return thread_state.stream;
+}
+
+Xoshiro256pp& threadGenerator() {
+    ThreadState& state = thread_state;
+    if (state.generation != seed_generation.load(std::memory_order_acquire)) {
+        state.reseed();
+    }
+    return state.generator;
+}
+
+} // namespace rng
+
+} // namespace hft
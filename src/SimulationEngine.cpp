@@ -1,4 +1,10 @@
 #include "SimulationEngine.h"
+#include "CsvWriter.h"
+#include "ColumnarFile.h"
+#include "ProfiledMutex.h"
+#include "Trace.h"
+#include "Clock.h"
+#include "Random.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -11,6 +17,9 @@ namespace hft {
 SimulationEngine::SimulationEngine(const SystemConfig& sys_cfg, const MarketMakerConfig& mm_cfg)
     : system_config(sys_cfg), mm_config(mm_cfg) {
     
+    // Run the one-off TSC calibration here rather than inside the first tick
+    Clock::calibration();
+    
     // Initialize components
     order_book = std::make_shared<OrderBook>(system_config.symbol);
     price_generator = std::make_shared<PriceGenerator>(
@@ -24,6 +33,13 @@ SimulationEngine::SimulationEngine(const SystemConfig& sys_cfg, const MarketMake
     market_maker = std::make_shared<MarketMaker>(order_book, price_generator, mm_config);
     pnl_calculator = std::make_shared<PnLCalculator>(10000, true);
     
+    // Only keep snapshots that carry new information; ticks that leave
+    // PnL and position unchanged are conflated
+    SnapshotConfig snapshot_config;
+    snapshot_config.policy = SnapshotPolicy::ON_CHANGE;
+    snapshot_config.change_epsilon = 0.01;
+    pnl_calculator->setSnapshotConfig(snapshot_config);
+    
     start_time = std::chrono::system_clock::now();
 }
 
@@ -46,7 +62,22 @@ void SimulationEngine::start() {
     std::cout << "Duration: " << system_config.simulation_duration_ms << " ms\n";
     std::cout << "Tick Interval: " << system_config.tick_interval_ms << " ms\n";
     
+    // A configured seed makes the run reproducible: the simulation thread
+    // draws from a fixed stream of it (see runSimulation)
+    if (system_config.seed != 0) {
+        rng::setMasterSeed(system_config.seed);
+        std::cout << "Seed: " << system_config.seed << "\n";
+    }
+    
     running.store(true);
+    if (market_maker) {
+        market_maker->resetTickToQuoteLatency();  // Reported per run
+        market_maker->start();
+    }
+    if (event_log) {
+        double initial_price = system_config.initial_price;
+        event_log->append(EventType::SIMULATION_START, Clock::toWallNs(Clock::now()), &initial_price, 1);
+    }
     simulation_thread = std::thread(&SimulationEngine::runSimulation, this);
 }
 
@@ -133,16 +164,19 @@ std::string SimulationEngine::getStatusString() const {
         oss << "\n--- Market Maker Status ---\n";
         oss << "Current Position: " << market_maker->getConfig().max_position_size << "\n";
         oss << "Emergency Stop: " << (market_maker->isRiskLimitExceeded() ? "YES" : "NO") << "\n";
+        oss << "Tick-to-Quote Latency: " << market_maker->getTickToQuoteLatency().summary() << "\n";
     }
     
     // PnL status
     if (pnl_calculator) {
+        // One consistent lock-free read of the published PnL state
+        PnLState pnl_state = pnl_calculator->getState();
         oss << "\n--- PnL Status ---\n";
-        oss << "Total PnL: " << pnl_calculator->getTotalPnL() << "\n";
-        oss << "Realized PnL: " << pnl_calculator->getRealizedPnL() << "\n";
-        oss << "Unrealized PnL: " << pnl_calculator->getUnrealizedPnL() << "\n";
-        oss << "Current Position: " << pnl_calculator->getCurrentPosition() << "\n";
-        oss << "Trade Count: " << pnl_calculator->getTradeCount() << "\n";
+        oss << "Total PnL: " << pnl_state.total_pnl << "\n";
+        oss << "Realized PnL: " << pnl_state.realized_pnl << "\n";
+        oss << "Unrealized PnL: " << pnl_state.unrealized_pnl << "\n";
+        oss << "Current Position: " << pnl_state.position << "\n";
+        oss << "Trade Count: " << pnl_state.trade_count << "\n";
     }
     
     oss << "==============================\n";
@@ -151,6 +185,7 @@ std::string SimulationEngine::getStatusString() const {
 }
 
 void SimulationEngine::generateReport(const std::string& filename) const {
+    TraceScope trace("engine", "SimulationEngine::generateReport");
     std::string actual_filename = filename.empty() ? "simulation_report.txt" : filename;
     
     std::ofstream file(actual_filename);
@@ -188,7 +223,11 @@ void SimulationEngine::generateReport(const std::string& filename) const {
     file << "  Ticks per Second: " << (total_ticks_processed > 0 ? 
                                        (total_ticks_processed * 1000.0 / 
                                         std::chrono::duration_cast<std::chrono::milliseconds>(
-                                            std::chrono::system_clock::now() - start_time).count()) : 0.0) << "\n\n";
+                                            std::chrono::system_clock::now() - start_time).count()) : 0.0) << "\n";
+    if (market_maker) {
+        file << "  Tick-to-Quote Latency: " << market_maker->getTickToQuoteLatency().summary() << "\n";
+    }
+    file << "\n";
     
     // Order book summary
     if (order_book) {
@@ -201,18 +240,23 @@ void SimulationEngine::generateReport(const std::string& filename) const {
     
     // PnL summary
     if (pnl_calculator) {
+        PnLState pnl_state = pnl_calculator->getState();
         file << "PnL Summary:\n";
-        file << "  Total PnL: " << pnl_calculator->getTotalPnL() << "\n";
-        file << "  Realized PnL: " << pnl_calculator->getRealizedPnL() << "\n";
-        file << "  Unrealized PnL: " << pnl_calculator->getUnrealizedPnL() << "\n";
-        file << "  Max Drawdown: " << pnl_calculator->getMaxDrawdown() << "\n";
+        file << "  Total PnL: " << pnl_state.total_pnl << "\n";
+        file << "  Realized PnL: " << pnl_state.realized_pnl << "\n";
+        file << "  Unrealized PnL: " << pnl_state.unrealized_pnl << "\n";
+        file << "  Max Drawdown: " << pnl_state.max_drawdown << "\n";
         file << "  Sharpe Ratio: " << pnl_calculator->getSharpeRatio() << "\n";
         file << "  Volatility: " << pnl_calculator->getVolatility() << "\n";
         file << "  Win Rate: " << (pnl_calculator->getWinRate() * 100.0) << "%\n";
         file << "  Profit Factor: " << pnl_calculator->getProfitFactor() << "\n";
-        file << "  Total Trades: " << pnl_calculator->getTradeCount() << "\n\n";
+        file << "  Total Trades: " << pnl_state.trade_count << "\n\n";
     }
     
+    // Lock contention (order book, PnL and price generator mutexes)
+    file << "Lock Contention:\n";
+    file << LockProfiler::report() << "\n";
+    
     file << "=== End of Report ===\n";
     file.close();
     
@@ -220,6 +264,7 @@ void SimulationEngine::generateReport(const std::string& filename) const {
 }
 
 void SimulationEngine::exportOrderBookData(const std::string& filename) const {
+    TraceScope trace("engine", "SimulationEngine::exportOrderBookData");
     if (!order_book) return;
     
     std::string actual_filename = filename.empty() ? "orderbook_data.csv" : filename;
@@ -240,32 +285,40 @@ void SimulationEngine::exportOrderBookData(const std::string& filename) const {
 }
 
 void SimulationEngine::exportTradeData(const std::string& filename) const {
+    TraceScope trace("engine", "SimulationEngine::exportTradeData");
     if (!pnl_calculator) return;
     
     std::string actual_filename = filename.empty() ? "trade_data.csv" : filename;
     
-    std::ofstream file(actual_filename);
-    if (!file.is_open()) {
+    CsvWriter csv(actual_filename);
+    if (!csv.isOpen()) {
         std::cerr << "Could not open file for writing: " << actual_filename << "\n";
         return;
     }
     
-    file << "Timestamp,Price,Quantity,Side,TradeValue,TradeID\n";
-    
-    auto trades = pnl_calculator->getTradeHistory();
-    for (const auto& trade : trades) {
-        auto time_t = std::chrono::system_clock::to_time_t(trade.timestamp);
-        std::tm* tm = std::localtime(&time_t);
-        
-        file << std::put_time(tm, "%Y-%m-%d %H:%M:%S") << ","
-             << trade.price << ","
-             << trade.quantity << ","
-             << (trade.side > 0 ? "BUY" : "SELL") << ","
-             << trade.trade_value << ","
-             << trade.trade_id << "\n";
-    }
+    csv.writeHeader("Timestamp,Price,Quantity,Side,TradeValue,TradeID");
+    
+    auto trades = pnl_calculator->getTradeColumns();
+    const int64_t* timestamps = trades->timestampColumn();
+    const double* prices = trades->priceColumn();
+    const double* quantities = trades->quantityColumn();
+    const double* sides = trades->sideColumn();
+    const double* values = trades->tradeValueColumn();
+    const uint64_t* ids = trades->tradeIdColumn();
+    
+    trades->forEachSegment([&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            csv.timestampField(timestamps[i]);
+            csv.field(prices[i]);
+            csv.field(quantities[i]);
+            csv.field(sides[i] > 0 ? std::string_view("BUY") : std::string_view("SELL"));
+            csv.field(values[i]);
+            csv.field(ids[i]);
+            csv.endRow();
+        }
+    });
     
-    file.close();
+    csv.close();
     
     std::cout << "Trade data exported: " << actual_filename << "\n";
 }
@@ -276,24 +329,120 @@ void SimulationEngine::exportPnLData(const std::string& filename) const {
     pnl_calculator->exportToCSV(filename);
 }
 
+bool SimulationEngine::exportBinaryData(const std::string& directory) const {
+    TraceScope trace("engine", "SimulationEngine::exportBinaryData");
+    if (!pnl_calculator) return false;
+    
+    std::string prefix = directory.empty() ? "" : directory + "/";
+    bool ok = true;
+    
+    {
+        auto trades = pnl_calculator->getTradeColumns();
+        std::vector<int8_t> sides;
+        sides.reserve(trades->size());
+        trades->sides().forEach([&sides](double side) { sides.push_back(side > 0 ? 1 : -1); });
+        
+        ColumnarFileWriter writer(trades->size());
+        writer.addInt64("Timestamp", trades->timestamps().toVector());
+        writer.addFloat64("Price", trades->prices().toVector());
+        writer.addFloat64("Quantity", trades->quantities().toVector());
+        writer.addInt8("Side", sides);
+        writer.addFloat64("TradeValue", trades->tradeValues().toVector());
+        writer.addUInt64("TradeID", trades->tradeIds().toVector());
+        ok = writer.write(prefix + "trade_data.hftc") && ok;
+    }
+    
+    ok = pnl_calculator->exportToColumnar(prefix + "pnl_data.hftc") && ok;
+    
+    {
+        std::lock_guard<std::mutex> lock(book_mutex);
+        ColumnarFileWriter writer(book_history.size());
+        writer.addInt64("Timestamp", book_history.timestamps().toVector());
+        writer.addFloat64("BestBid", book_history.bestBids().toVector());
+        writer.addFloat64("BestAsk", book_history.bestAsks().toVector());
+        writer.addFloat64("BidSize", book_history.bidSizes().toVector());
+        writer.addFloat64("AskSize", book_history.askSizes().toVector());
+        writer.addUInt64("BidLevels", book_history.bidLevels().toVector());
+        writer.addUInt64("AskLevels", book_history.askLevels().toVector());
+        writer.addFloat64("MarkPrice", book_history.markPrices().toVector());
+        ok = writer.write(prefix + "orderbook_data.hftc") && ok;
+    }
+    
+    if (!ok) {
+        std::cerr << "Could not write binary data to: " << (directory.empty() ? "." : directory) << "\n";
+        return false;
+    }
+    
+    std::cout << "Binary data exported: " << (directory.empty() ? "." : directory) << "\n";
+    return true;
+}
+
+bool SimulationEngine::enableEventLog(const std::string& path, size_t capacity_records) {
+    if (running.load()) {
+        std::cerr << "Event log must be enabled before the simulation starts\n";
+        return false;
+    }
+    
+    event_log.reset(new EventLogWriter(path, capacity_records));
+    if (!event_log->isOpen()) {
+        std::cerr << "Could not open event log: " << path << "\n";
+        event_log.reset();
+        return false;
+    }
+    return true;
+}
+
+void SimulationEngine::enableTrace(const std::string& path, size_t ring_capacity) {
+    trace_path = path;
+    Tracer::setRingCapacity(ring_capacity);
+    Tracer::setEnabled(true);
+}
+
+void SimulationEngine::disableTrace() {
+    Tracer::setEnabled(false);
+}
+
+bool SimulationEngine::writeTrace() const {
+    if (trace_path.empty()) {
+        return false;
+    }
+    if (!Tracer::writeChromeTrace(trace_path)) {
+        return false;
+    }
+    std::cout << "Trace written: " << trace_path << " (" << Tracer::getEventCount() << " events)\n";
+    return true;
+}
+
 void SimulationEngine::runSimulation() {
     std::cout << "Simulation thread started.\n";
+    Tracer::setThreadName("simulation");
+    Tracer::instant("engine", "simulation_start");
+    
+    // Bind the same stream whatever threads touched the RNG first, and draw
+    // the price path from it
+    rng::bindThreadStream(SIMULATION_STREAM);
+    price_generator->setSeed(rng::threadGenerator()());
     
-    auto start_time = std::chrono::system_clock::now();
-    auto end_time = start_time + std::chrono::milliseconds(system_config.simulation_duration_ms);
+    uint64_t end_ticks = Clock::now() + Clock::fromNanos(system_config.simulation_duration_ms * 1000000);
     
-    while (running.load() && std::chrono::system_clock::now() < end_time) {
+    while (running.load() && Clock::now() < end_ticks) {
         processTick();
         
         // Sleep for the configured tick interval
         std::this_thread::sleep_for(std::chrono::milliseconds(system_config.tick_interval_ms));
     }
     
+    if (event_log) {
+        event_log->append(EventType::SIMULATION_STOP, Clock::toWallNs(Clock::now()), nullptr, 0);
+    }
+    Tracer::instant("engine", "simulation_stop");
+    
     std::cout << "Simulation completed.\n";
     running.store(false);
 }
 
 void SimulationEngine::processTick() {
+    TraceScope trace("engine", "SimulationEngine::processTick");
     try {
         // Generate new price
         double new_price = price_generator->generateNextPrice();
@@ -311,6 +460,9 @@ void SimulationEngine::processTick() {
             pnl_calculator->updateMarkPrice(new_price);
         }
         
+        TopOfBook top = sampleOrderBook(new_price);
+        publishTickEvent(new_price, top);
+        
         // Update performance metrics
         updatePerformanceMetrics();
         
@@ -326,6 +478,26 @@ void SimulationEngine::updateMarketData() {
     // For now, it's handled by the price generator
 }
 
+TopOfBook SimulationEngine::sampleOrderBook(double mark_price) {
+    TraceScope trace("engine", "SimulationEngine::sampleOrderBook");
+    if (!order_book) return TopOfBook{};
+    
+    TopOfBook top = order_book->getTopOfBook();
+    std::lock_guard<std::mutex> lock(book_mutex);
+    book_history.push(Clock::wallNow(), top, mark_price);
+    return top;
+}
+
+void SimulationEngine::publishTickEvent(double mark_price, const TopOfBook& top) {
+    TraceScope trace("engine", "SimulationEngine::publishTickEvent");
+    if (!event_log) return;
+    
+    PnLState pnl_state = pnl_calculator ? pnl_calculator->getState() : PnLState{};
+    double values[6] = {mark_price, top.best_bid, top.best_ask, pnl_state.position,
+                        pnl_state.realized_pnl, pnl_state.total_pnl};
+    event_log->append(EventType::TICK, Clock::toWallNs(Clock::now()), values, 6);
+}
+
 void SimulationEngine::updatePerformanceMetrics() {
     // Update running performance statistics
     // This could include latency measurements, throughput calculations, etc.
@@ -0,0 +1,167 @@
+#include "SlidingStats.h"
+#include "NumericKernels.h"
+#include <algorithm>
+#include <vector>
+
+namespace hft {
+namespace sliding {
+
+namespace {
+
+// Running sums are recomputed from scratch every this many outputs so
+// rounding error from the add/remove updates cannot accumulate. At least
+// four windows, so the from-scratch sums add at most a quarter pass.
+size_t reanchorInterval(size_t window) {
+    return std::max<size_t>(1024, 4 * window);
+}
+
+// Runs a kernels::windowStat over each re-anchored block of outputs.
+// Subtracting the block's first sample keeps s2 - s1^2/w well conditioned
+// for prices far from zero.
+void shiftedWindowStat(kernels::WindowStat stat, const double* data, size_t n, size_t window,
+                       double inv_denom, double* out) {
+    size_t outputs = n - window + 1;
+    size_t interval = reanchorInterval(window);
+
+    for (size_t begin = 0; begin < outputs; begin += interval) {
+        size_t count = std::min(outputs - begin, interval);
+        const double* block = data + begin;
+        double k = block[0];
+
+        double s1 = 0.0;
+        double s2 = 0.0;
+        for (size_t j = 0; j < window; ++j) {
+            double d = block[j] - k;
+            s1 += d;
+            s2 += d * d;
+        }
+        kernels::windowStat(stat, block, count, window, k, s1, s2, inv_denom, out + begin);
+    }
+}
+
+// Van Herk / Gil-Werman: prefix extrema within each window-sized block and
+// suffix extrema within the same blocks; every window spans at most two
+// blocks, so out[i] = op(suffix[i], prefix[i + window - 1]). Three
+// comparisons per sample regardless of window size.
+template<typename Op>
+void rollingExtremum(const double* data, size_t n, size_t window, double* out, Op op) {
+    std::vector<double> prefix(n);
+    std::vector<double> suffix(n);
+
+    for (size_t block = 0; block < n; block += window) {
+        size_t end = std::min(n, block + window);
+        prefix[block] = data[block];
+        for (size_t i = block + 1; i < end; ++i) {
+            prefix[i] = op(prefix[i - 1], data[i]);
+        }
+        suffix[end - 1] = data[end - 1];
+        for (size_t i = end - 1; i > block; --i) {
+            suffix[i - 1] = op(suffix[i], data[i - 1]);
+        }
+    }
+
+    size_t outputs = n - window + 1;
+    const double* tail = prefix.data() + window - 1;
+    for (size_t i = 0; i < outputs; ++i) {
+        out[i] = op(suffix[i], tail[i]);
+    }
+}
+
+} // namespace
+
+void rollingMean(const double* data, size_t n, size_t window, double* out) {
+    if (window == 0 || n < window) {
+        return;
+    }
+    shiftedWindowStat(kernels::WindowStat::MEAN, data, n, window, 0.0, out);
+}
+
+void rollingVariance(const double* data, size_t n, size_t window, double* out, bool sample) {
+    if (window == 0 || n < window) {
+        return;
+    }
+    if (sample && window < 2) {
+        std::fill(out, out + (n - window + 1), 0.0);
+        return;
+    }
+    double inv_denom = 1.0 / static_cast<double>(sample ? window - 1 : window);
+    shiftedWindowStat(kernels::WindowStat::VARIANCE, data, n, window, inv_denom, out);
+}
+
+void rollingStddev(const double* data, size_t n, size_t window, double* out, bool sample) {
+    if (window == 0 || n < window) {
+        return;
+    }
+    if (sample && window < 2) {
+        std::fill(out, out + (n - window + 1), 0.0);
+        return;
+    }
+    double inv_denom = 1.0 / static_cast<double>(sample ? window - 1 : window);
+    shiftedWindowStat(kernels::WindowStat::STDDEV, data, n, window, inv_denom, out);
+}
+
+void rollingMin(const double* data, size_t n, size_t window, double* out) {
+    if (window == 0 || n < window) {
+        return;
+    }
+    rollingExtremum(data, n, window, out, [](double a, double b) { return b < a ? b : a; });
+}
+
+void rollingMax(const double* data, size_t n, size_t window, double* out) {
+    if (window == 0 || n < window) {
+        return;
+    }
+    rollingExtremum(data, n, window, out, [](double a, double b) { return b > a ? b : a; });
+}
+
+void rollingZScore(const double* data, size_t n, size_t window, double* out) {
+    if (window == 0 || n < window) {
+        return;
+    }
+    shiftedWindowStat(kernels::WindowStat::ZSCORE, data, n, window, 0.0, out);
+}
+
+void rollingCorrelation(const double* x, const double* y, size_t n, size_t window, double* out) {
+    if (window == 0 || n < window) {
+        return;
+    }
+
+    size_t outputs = n - window + 1;
+    size_t interval = reanchorInterval(window);
+
+    // Same block scheme as shiftedWindowStat, with five co-moment sums
+    for (size_t begin = 0; begin < outputs; begin += interval) {
+        size_t count = std::min(outputs - begin, interval);
+        const double* bx = x + begin;
+        const double* by = y + begin;
+        double kx = bx[0];
+        double ky = by[0];
+
+        kernels::WindowSums sums{0.0, 0.0, 0.0, 0.0, 0.0};
+        for (size_t j = 0; j < window; ++j) {
+            double dx = bx[j] - kx;
+            double dy = by[j] - ky;
+            sums.sx += dx;
+            sums.sy += dy;
+            sums.sxx += dx * dx;
+            sums.syy += dy * dy;
+            sums.sxy += dx * dy;
+        }
+        kernels::windowCorrelation(bx, by, count, window, kx, ky, sums, out + begin);
+    }
+}
+
+void ema(const double* data, size_t n, double alpha, double* out) {
+    if (n == 0) {
+        return;
+    }
+    // out[i] = (1 - alpha) * out[i - 1] + alpha * data[i], seeded by data[0]
+    out[0] = data[0];
+    for (size_t i = 1; i < n; ++i) {
+        out[i] = alpha * data[i];
+    }
+    kernels::linearScan(out + 1, n - 1, 1.0 - alpha, data[0], out + 1);
+}
+
+} // namespace sliding
+} // namespace hft
@@ -0,0 +1,106 @@
+#include "TimestampFormatter.h"
+#include <atomic>
+#include <cstring>
+#include <ctime>
+
+namespace hft {
+
+namespace {
+
+// "00" "01" ... "99"
+struct DigitPairs {
+    char text[200];
+
+    constexpr DigitPairs() : text() {
+        for (int i = 0; i < 100; ++i) {
+            text[2 * i] = static_cast<char>('0' + i / 10);
+            text[2 * i + 1] = static_cast<char>('0' + i % 10);
+        }
+    }
+};
+
+constexpr DigitPairs DIGIT_PAIRS;
+
+inline char* writePair(char* out, uint32_t value) {
+    std::memcpy(out, DIGIT_PAIRS.text + 2 * value, 2);
+    return out + 2;
+}
+
+std::atomic<uint64_t> timezone_generation{1};
+
+struct MinuteCache {
+    int64_t minute_start = INT64_MIN;  // Epoch second at which the cached local minute begins
+    uint64_t generation = 0;
+    char prefix[16];                   // "YYYY-MM-DD HH:MM"
+};
+
+thread_local MinuteCache minute_cache;
+
+void refresh(MinuteCache& cache, int64_t second) {
+    std::time_t time = static_cast<std::time_t>(second);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &time);
+#else
+    localtime_r(&time, &local);
+#endif
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M", &local);
+    std::memcpy(cache.prefix, text, sizeof(cache.prefix));
+    cache.minute_start = second - local.tm_sec;
+    cache.generation = timezone_generation.load(std::memory_order_acquire);
+}
+
+} // namespace
+
+char* TimestampFormatter::format(char* out, int64_t nanos_since_epoch, TimestampPrecision precision) {
+    int64_t second = nanos_since_epoch / 1000000000;
+    int64_t nanos = nanos_since_epoch % 1000000000;
+    if (nanos < 0) {
+        nanos += 1000000000;
+        --second;
+    }
+
+    MinuteCache& cache = minute_cache;
+    uint64_t offset = static_cast<uint64_t>(second) - static_cast<uint64_t>(cache.minute_start);
+    if (offset >= 60 || cache.generation != timezone_generation.load(std::memory_order_relaxed)) {
+        refresh(cache, second);
+        offset = static_cast<uint64_t>(second - cache.minute_start);
+    }
+
+    std::memcpy(out, cache.prefix, sizeof(cache.prefix));
+    out += sizeof(cache.prefix);
+    *out++ = ':';
+    out = writePair(out, static_cast<uint32_t>(offset));
+
+    if (precision == TimestampPrecision::MILLIS) {
+        uint32_t millis = static_cast<uint32_t>(nanos / 1000000);
+        *out++ = '.';
+        *out++ = static_cast<char>('0' + millis / 100);
+        out = writePair(out, millis % 100);
+    } else if (precision == TimestampPrecision::MICROS) {
+        uint32_t micros = static_cast<uint32_t>(nanos / 1000);
+        *out++ = '.';
+        out = writePair(out, micros / 10000);
+        out = writePair(out, (micros / 100) % 100);
+        out = writePair(out, micros % 100);
+    }
+    return out;
+}
+
+std::string TimestampFormatter::toString(int64_t nanos_since_epoch, TimestampPrecision precision) {
+    char text[MAX_LENGTH];
+    char* end = format(text, nanos_since_epoch, precision);
+    return std::string(text, static_cast<size_t>(end - text));
+}
+
+void TimestampFormatter::resetTimezone() {
+#ifdef _WIN32
+    _tzset();
+#else
+    tzset();
+#endif
+    timezone_generation.fetch_add(1, std::memory_order_release);
+}
+
+} // namespace hft
@@ -0,0 +1,99 @@
+#include "Tokenizer.h"
+#include <charconv>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace hft {
+namespace utils {
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Trim and drop a leading '+', which from_chars rejects
+std::string_view numberText(std::string_view text) {
+    text = trimView(text);
+    if (text.size() > 1 && text[0] == '+' && text[1] != '-') {
+        text.remove_prefix(1);
+    }
+    return text;
+}
+
+template<typename T>
+bool parseWhole(std::string_view text, T& out) {
+    text = numberText(text);
+    if (text.empty()) {
+        return false;
+    }
+    T value;
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc() || ptr != text.data() + text.size()) {
+        return false;
+    }
+    out = value;
+    return true;
+}
+
+} // namespace
+
+const char* findDelimiter(const char* begin, const char* end, char delimiter) {
+    const char* p = begin;
+#if defined(__SSE2__)
+    const __m128i needle = _mm_set1_epi8(delimiter);
+    for (; end - p >= 16; p += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+        if (mask != 0) {
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+    }
+#endif
+    for (; p < end; ++p) {
+        if (*p == delimiter) {
+            return p;
+        }
+    }
+    return end;
+}
+
+size_t splitInto(std::string_view text, char delimiter, std::vector<std::string_view>& out) {
+    out.clear();
+    Tokenizer tokenizer(text, delimiter);
+    std::string_view token;
+    while (tokenizer.next(token)) {
+        out.push_back(token);
+    }
+    return out.size();
+}
+
+std::string_view trimView(std::string_view text) {
+    size_t start = 0;
+    while (start < text.size() && isSpace(text[start])) {
+        ++start;
+    }
+    size_t stop = text.size();
+    while (stop > start && isSpace(text[stop - 1])) {
+        --stop;
+    }
+    return text.substr(start, stop - start);
+}
+
+bool parseDouble(std::string_view text, double& out) {
+    return parseWhole(text, out);
+}
+
+bool parseInt64(std::string_view text, int64_t& out) {
+    return parseWhole(text, out);
+}
+
+bool parseUInt64(std::string_view text, uint64_t& out) {
+    return parseWhole(text, out);
+}
+
+} // namespace utils
+} // namespace hft
@@ -0,0 +1,195 @@
+#include "Trace.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace hft {
+
+namespace {
+
+struct TraceRing {
+    std::unique_ptr<TraceEvent[]> events;
+    size_t mask;
+    std::atomic<uint64_t> head{0};  // Total records ever written
+    uint32_t tid;
+    std::string thread_name;        // Guarded by the registry mutex
+    bool retired = false;           // Owning thread has exited
+
+    TraceRing(size_t capacity, uint32_t id) : events(new TraceEvent[capacity]), mask(capacity - 1), tid(id) {}
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TraceRing>> rings;
+    uint32_t next_tid = 1;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+std::atomic<size_t> ring_capacity{size_t(1) << 16};
+
+TraceRing* registerRing() {
+    size_t capacity = 1;
+    while (capacity < ring_capacity.load(std::memory_order_relaxed)) {
+        capacity <<= 1;
+    }
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.rings.emplace_back(new TraceRing(capacity, reg.next_tid++));
+    return reg.rings.back().get();
+}
+
+// Registers the thread's ring on first use and retires it at thread exit;
+// the ring itself stays in the registry until clear() so a later dump still
+// sees the thread's events
+struct ThreadRing {
+    TraceRing* ring = nullptr;
+
+    TraceRing* get() {
+        if (!ring) {
+            ring = registerRing();
+        }
+        return ring;
+    }
+
+    ~ThreadRing() {
+        if (ring) {
+            std::lock_guard<std::mutex> lock(registry().mutex);
+            ring->retired = true;
+        }
+    }
+};
+
+thread_local ThreadRing thread_ring;
+
+void writeJsonString(std::FILE* f, const char* text) {
+    std::fputc('"', f);
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            std::fputc('\\', f);
+            std::fputc(*c, f);
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            std::fprintf(f, "\\u%04x", *c);
+        } else {
+            std::fputc(*c, f);
+        }
+    }
+    std::fputc('"', f);
+}
+
+} // namespace
+
+std::atomic<bool> Tracer::enabled{false};
+
+void Tracer::record(const TraceEvent& event) {
+    TraceRing* ring = thread_ring.get();
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    ring->events[head & ring->mask] = event;
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void Tracer::setRingCapacity(size_t records) {
+    ring_capacity.store(std::max<size_t>(records, 16), std::memory_order_relaxed);
+}
+
+void Tracer::setThreadName(const std::string& name) {
+    TraceRing* ring = thread_ring.get();
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    ring->thread_name = name;
+}
+
+size_t Tracer::getEventCount() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    size_t count = 0;
+    for (const auto& ring : reg.rings) {
+        count += static_cast<size_t>(std::min<uint64_t>(ring->head.load(std::memory_order_acquire), ring->mask + 1));
+    }
+    return count;
+}
+
+void Tracer::clear() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.rings.erase(std::remove_if(reg.rings.begin(), reg.rings.end(),
+                                   [](const std::unique_ptr<TraceRing>& ring) { return ring->retired; }),
+                    reg.rings.end());
+    for (auto& ring : reg.rings) {
+        ring->head.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool Tracer::writeChromeTrace(const std::string& path) {
+    struct Entry {
+        TraceEvent event;
+        uint32_t tid;
+    };
+    std::vector<Entry> entries;
+    std::vector<std::pair<uint32_t, std::string>> threads;
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (const auto& ring : reg.rings) {
+            uint64_t head = ring->head.load(std::memory_order_acquire);
+            uint64_t count = std::min<uint64_t>(head, ring->mask + 1);
+            for (uint64_t i = head - count; i < head; ++i) {
+                entries.push_back(Entry{ring->events[i & ring->mask], ring->tid});
+            }
+            if (count > 0) {
+                threads.emplace_back(ring->tid, ring->thread_name.empty()
+                                                    ? "thread " + std::to_string(ring->tid)
+                                                    : ring->thread_name);
+            }
+        }
+    }
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const Entry& a, const Entry& b) { return a.event.start < b.event.start; });
+    uint64_t origin = entries.empty() ? 0 : entries.front().event.start;
+
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) {
+        std::cerr << "Could not write trace: " << path << "\n";
+        return false;
+    }
+
+    // Timestamps are microseconds in the format; keep nanosecond precision
+    std::fprintf(f, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [");
+    bool first = true;
+    for (const auto& thread : threads) {
+        std::fprintf(f, "%s\n{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": ",
+                     first ? "" : ",", thread.first);
+        writeJsonString(f, thread.second.c_str());
+        std::fprintf(f, "}}");
+        first = false;
+    }
+    for (const Entry& entry : entries) {
+        const TraceEvent& e = entry.event;
+        std::fprintf(f, "%s\n{\"ph\": \"%c\", \"cat\": ", first ? "" : ",", e.phase);
+        writeJsonString(f, e.category);
+        std::fprintf(f, ", \"name\": ");
+        writeJsonString(f, e.name);
+        std::fprintf(f, ", \"pid\": 1, \"tid\": %u, \"ts\": %.3f", entry.tid,
+                     Clock::toNanos(e.start - origin) / 1000.0);
+        if (e.phase == 'X') {
+            std::fprintf(f, ", \"dur\": %.3f}", Clock::toNanos(e.duration) / 1000.0);
+        } else {
+            std::fprintf(f, ", \"s\": \"t\"}");
+        }
+        first = false;
+    }
+    std::fprintf(f, "\n]}\n");
+    bool ok = std::ferror(f) == 0;
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Could not write trace: " << path << "\n";
+    }
+    return ok;
+}
+
+} // namespace hft
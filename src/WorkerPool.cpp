@@ -0,0 +1,106 @@
+#include "WorkerPool.h"
+#include <algorithm>
+
+namespace hft {
+
+WorkerPool::WorkerPool(size_t threads)
+    : task_fn(nullptr), task_context(nullptr), task_count(0), next_task(0),
+      busy_helpers(0), generation(0), stopping(false) {
+    resize(threads);
+}
+
+WorkerPool::~WorkerPool() {
+    stopHelpers();
+}
+
+void WorkerPool::resize(size_t threads) {
+    threads = std::max<size_t>(1, threads);
+    if (threads == size()) {
+        return;
+    }
+
+    stopHelpers();
+    stopping = false;
+    helpers.reserve(threads - 1);
+    for (size_t i = 1; i < threads; ++i) {
+        // Helpers start at the current generation so they only pick up later batches
+        helpers.emplace_back(&WorkerPool::helperLoop, this, generation);
+    }
+}
+
+void WorkerPool::dispatch(size_t tasks, TaskFn fn, void* context) {
+    if (tasks == 0) {
+        return;
+    }
+    if (helpers.empty() || tasks == 1) {
+        for (size_t i = 0; i < tasks; ++i) {
+            fn(context, i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        task_fn = fn;
+        task_context = context;
+        task_count = tasks;
+        next_task.store(0, std::memory_order_relaxed);
+        busy_helpers = helpers.size();
+        ++generation;
+    }
+    work_ready.notify_all();
+
+    drain(fn, context, tasks);
+
+    std::unique_lock<std::mutex> lock(pool_mutex);
+    work_done.wait(lock, [this]() { return busy_helpers == 0; });
+}
+
+void WorkerPool::drain(TaskFn fn, void* context, size_t tasks) {
+    for (size_t i = next_task.fetch_add(1, std::memory_order_relaxed); i < tasks;
+         i = next_task.fetch_add(1, std::memory_order_relaxed)) {
+        fn(context, i);
+    }
+}
+
+void WorkerPool::helperLoop(uint64_t seen_generation) {
+    for (;;) {
+        TaskFn fn;
+        void* context;
+        size_t tasks;
+        {
+            std::unique_lock<std::mutex> lock(pool_mutex);
+            work_ready.wait(lock, [this, seen_generation]() {
+                return stopping || generation != seen_generation;
+            });
+            if (stopping) {
+                return;
+            }
+            seen_generation = generation;
+            fn = task_fn;
+            context = task_context;
+            tasks = task_count;
+        }
+
+        drain(fn, context, tasks);
+
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        if (--busy_helpers == 0) {
+            work_done.notify_one();
+        }
+    }
+}
+
+void WorkerPool::stopHelpers() {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        stopping = true;
+    }
+    work_ready.notify_all();
+    for (auto& helper : helpers) {
+        helper.join();
+    }
+    helpers.clear();
+}
+
+} // namespace hft
@@ -6,6 +6,7 @@
 #include <thread>
 #include <string>
 #include <limits>
+#include <cstdlib>
 
 using namespace hft;
 
@@ -29,8 +30,7 @@ void printMenu() {
     std::cout << "4. Custom Simulation Settings\n";
     std::cout << "5. View System Status\n";
     std::cout << "6. Export Data\n";
-    std::cout << "7. Performance Test\n";
-    std::cout << "8. Exit\n";
+    std::cout << "7. Exit\n";
     std::cout << "================\n";
     std::cout << "Enter your choice: ";
 }
@@ -67,6 +67,7 @@ void runSimulation(SimulationEngine& engine, uint64_t duration_ms) {
                                     std::to_string(std::chrono::duration_cast<std::chrono::seconds>(
                                         std::chrono::system_clock::now().time_since_epoch()).count()) + ".txt";
         engine.generateReport(report_filename);
+        engine.writeTrace();
         
     } catch (const std::exception& e) {
         std::cerr << "Error during simulation: " << e.what() << "\n";
@@ -86,9 +87,7 @@ void customSimulation(SimulationEngine& engine) {
     std::string input;
     std::getline(std::cin, input);
     if (!input.empty()) {
-        try {
-            sys_config.initial_price = std::stod(input);
-        } catch (...) {
+        if (!utils::parseDouble(input, sys_config.initial_price)) {
             std::cout << "Invalid price, keeping current value.\n";
         }
     }
@@ -97,9 +96,10 @@ void customSimulation(SimulationEngine& engine) {
     std::cout << "Enter new duration in seconds (or press Enter to keep current): ";
     std::getline(std::cin, input);
     if (!input.empty()) {
-        try {
-            sys_config.simulation_duration_ms = std::stoul(input) * 1000;
-        } catch (...) {
+        uint64_t seconds = 0;
+        if (utils::parseUInt64(input, seconds)) {
+            sys_config.simulation_duration_ms = seconds * 1000;
+        } else {
             std::cout << "Invalid duration, keeping current value.\n";
         }
     }
@@ -109,9 +109,7 @@ void customSimulation(SimulationEngine& engine) {
     std::cout << "Enter new base spread in bps (or press Enter to keep current): ";
     std::getline(std::cin, input);
     if (!input.empty()) {
-        try {
-            mm_config.base_spread_bps = std::stod(input);
-        } catch (...) {
+        if (!utils::parseDouble(input, mm_config.base_spread_bps)) {
             std::cout << "Invalid spread, keeping current value.\n";
         }
     }
@@ -120,9 +118,7 @@ void customSimulation(SimulationEngine& engine) {
     std::cout << "Enter new order size (or press Enter to keep current): ";
     std::getline(std::cin, input);
     if (!input.empty()) {
-        try {
-            mm_config.order_size = std::stod(input);
-        } catch (...) {
+        if (!utils::parseDouble(input, mm_config.order_size)) {
             std::cout << "Invalid order size, keeping current value.\n";
         }
     }
@@ -143,7 +139,8 @@ void exportData(SimulationEngine& engine) {
     std::cout << "2. Export Trade Data\n";
     std::cout << "3. Export PnL Data\n";
     std::cout << "4. Export All Data\n";
-    std::cout << "5. Back to Main Menu\n";
+    std::cout << "5. Export All Data (binary columnar)\n";
+    std::cout << "6. Back to Main Menu\n";
     std::cout << "Enter your choice: ";
     
     int choice;
@@ -167,6 +164,9 @@ void exportData(SimulationEngine& engine) {
             std::cout << "All data exported!\n";
             break;
         case 5:
+            engine.exportBinaryData("data");
+            break;
+        case 6:
             return;
         default:
             std::cout << "Invalid choice.\n";
@@ -174,60 +174,6 @@ void exportData(SimulationEngine& engine) {
     }
 }
 
-void performanceTest() {
-    std::cout << "\n=== Performance Test ===\n";
-    std::cout << "Running performance benchmark...\n";
-    
-    // Create a simple order book for testing
-    auto order_book = std::make_shared<OrderBook>("TEST");
-    
-    // Measure order insertion performance
-    auto start_time = std::chrono::high_resolution_clock::now();
-    
-    const int num_orders = 100000;
-    for (int i = 0; i < num_orders; ++i) {
-        double price = 100.0 + (i % 100) * 0.01;
-        double quantity = 100.0 + (i % 50);
-        OrderSide side = (i % 2 == 0) ? OrderSide::BUY : OrderSide::SELL;
-        
-        order_book->addOrder(side, OrderType::LIMIT, price, quantity);
-    }
-    
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
-    
-    double orders_per_second = (num_orders * 1000000.0) / duration.count();
-    
-    std::cout << "Performance Results:\n";
-    std::cout << "  Orders inserted: " << num_orders << "\n";
-    std::cout << "  Time taken: " << duration.count() << " microseconds\n";
-    std::cout << "  Orders per second: " << std::fixed << std::setprecision(0) << orders_per_second << "\n";
-    std::cout << "  Microseconds per order: " << std::fixed << std::setprecision(2) 
-              << (duration.count() / static_cast<double>(num_orders)) << "\n";
-    
-    // Test order book queries
-    start_time = std::chrono::high_resolution_clock::now();
-    
-    for (int i = 0; i < 10000; ++i) {
-        order_book->getBestBid();
-        order_book->getBestAsk();
-        order_book->getMidPrice();
-        order_book->getSpread();
-    }
-    
-    end_time = std::chrono::high_resolution_clock::now();
-    duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
-    
-    double queries_per_second = (40000 * 1000000.0) / duration.count();
-    
-    std::cout << "\nQuery Performance:\n";
-    std::cout << "  Queries executed: " << 40000 << "\n";
-    std::cout << "  Time taken: " << duration.count() << " microseconds\n";
-    std::cout << "  Queries per second: " << std::fixed << std::setprecision(0) << queries_per_second << "\n";
-    
-    std::cout << "\nPerformance test completed!\n";
-}
-
 int main() {
     printBanner();
     
@@ -238,6 +184,11 @@ int main() {
     sys_config.simulation_duration_ms = 120000; // 2 minutes
     sys_config.tick_interval_ms = 10;           // 100 ticks per second
     
+    // HFT_SEED=<n> makes every run reproducible (see SystemConfig::seed)
+    if (const char* seed = std::getenv("HFT_SEED")) {
+        sys_config.seed = std::strtoull(seed, nullptr, 0);
+    }
+    
     MarketMakerConfig mm_config;
     mm_config.base_spread_bps = 15.0;          // 15 basis points
     mm_config.min_spread_bps = 5.0;            // 5 basis points
@@ -255,6 +206,20 @@ int main() {
     // Create simulation engine
     SimulationEngine engine(sys_config, mm_config);
     
+    // Stream ticks to a live event log that analytics can follow while running
+    utils::createDirectory("data");
+    if (engine.enableEventLog("data/events.hftlog")) {
+        std::cout << "Live event log: data/events.hftlog (follow with python_analytics/live_monitor.py)\n";
+    }
+    
+    // HFT_TRACE=trace.json records a Chrome/Perfetto timeline, rewritten
+    // after every run
+    if (const char* trace_path = std::getenv("HFT_TRACE")) {
+        Tracer::setThreadName("main");
+        engine.enableTrace(trace_path);
+        std::cout << "Tracing to " << trace_path << " (open in ui.perfetto.dev)\n";
+    }
+    
     std::cout << "System initialized with default configuration.\n";
     std::cout << "Symbol: " << sys_config.symbol << "\n";
     std::cout << "Initial Price: $" << sys_config.initial_price << "\n";
@@ -289,9 +254,7 @@ int main() {
                 exportData(engine);
                 break;
             case 7:
-                performanceTest();
-                break;
-            case 8:
+                engine.writeTrace();  // Includes exports made after the last run
                 running = false;
                 std::cout << "Goodbye!\n";
                 break;
@@ -3,6 +3,19 @@
 #include <iostream>
 #include <cassert>
 #include <memory>
+#include <vector>
+#include <numeric>
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <filesystem>
+#include <fstream>
+#include <cstdio>
+#include <ctime>
+#include <cstdlib>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
 
 using namespace hft;
 
@@ -55,6 +68,38 @@ void testOrderBook() {
     assert(order_book->cancelOrder(bid_id));
     assert(order_book->getBestBid() == 0.0);
     
+    // Test order amendment (keeps the id, moves the level)
+    assert(order_book->modifyOrder(ask_id, 150.5, 40.0));
+    assert(order_book->getBestAsk() == 150.5);
+    assert(order_book->getTopOfBook().ask_size == 40.0);
+    assert(order_book->getAskLevels() == 1);
+    assert(order_book->modifyOrder(ask_id, 150.75, 60.0));
+    assert(order_book->getBestAsk() == 150.75);
+    assert(!order_book->modifyOrder(bid_id, 149.5, 10.0));
+    assert(order_book->cancelOrder(ask_id));
+    assert(order_book->getBestAsk() == 0.0);
+
+    // Market orders remove what they fill, emptied levels included
+    uint64_t first_id = order_book->addOrder(OrderSide::SELL, OrderType::LIMIT, 151.0, 50.0);
+    uint64_t second_id = order_book->addOrder(OrderSide::SELL, OrderType::LIMIT, 151.0, 50.0);
+    order_book->addOrder(OrderSide::SELL, OrderType::LIMIT, 152.0, 100.0);
+    assert(order_book->processMarketOrder(OrderSide::BUY, 80.0));
+    assert(order_book->getBestAsk() == 151.0);
+    assert(order_book->getTopOfBook().ask_size == 20.0);
+    assert(order_book->getTotalFills() == 1);
+    assert(!order_book->cancelOrder(first_id));
+    assert(order_book->processMarketOrder(OrderSide::BUY, 20.0));
+    assert(order_book->getBestAsk() == 152.0);
+    assert(order_book->getAskLevels() == 1);
+    assert(!order_book->modifyOrder(second_id, 151.0, 10.0));
+    assert(!order_book->processMarketOrder(OrderSide::BUY, 150.0));
+    assert(order_book->getBestAsk() == 0.0);
+
+    // The book dump takes the lock once (used to self-deadlock)
+    order_book->addOrder(OrderSide::BUY, OrderType::LIMIT, 149.0, 100.0);
+    std::string dump = order_book->getOrderBookString(5);
+    assert(dump.find("149.00") != std::string::npos);
+
     std::cout << "OrderBook tests passed!\n";
 }
 
@@ -92,13 +137,1298 @@ void testPnLCalculator() {
     
     assert(pnl_calc->getTradeCount() == 2);
     assert(pnl_calc->getCurrentPosition() == 0.0);
+    assert(pnl_calc->getRealizedPnL() == 100.0);
     
     // Test mark price update
     pnl_calc->updateMarkPrice(152.0);
     
+    // Columnar history wraps at the configured capacity
+    PnLCalculator bounded(4);
+    for (int i = 1; i <= 6; ++i) {
+        bounded.recordTrade(100.0 + i, 1.0, 1.0);
+    }
+    {
+        auto trades = bounded.getTradeColumns();
+        assert(trades->size() == 4);
+        assert((*trades)[0].price == 103.0);
+        assert(trades->back().price == 106.0);
+        
+        double price_sum = 0.0;
+        trades->prices().forEach([&](double price) { price_sum += price; });
+        assert(price_sum == 103.0 + 104.0 + 105.0 + 106.0);
+    }
+    assert(bounded.getPnLHistory()->size() == 4);
+    
+    // Capacities that are not a power of two leave spare physical slots;
+    // wrapping must still keep exactly the newest rows in order
+    PnLCalculator odd(10);
+    for (int i = 1; i <= 25; ++i) {
+        odd.recordTrade(100.0 + i, 1.0, 1.0);
+    }
+    {
+        auto trades = odd.getTradeColumns();
+        assert(trades->size() == 10);
+        for (size_t i = 0; i < 10; ++i) {
+            assert((*trades)[i].price == 116.0 + i);
+        }
+        std::vector<double> prices;
+        trades->prices().forEach([&](double price) { prices.push_back(price); });
+        assert(prices.size() == 10 && prices.front() == 116.0 && prices.back() == 125.0);
+    }
+    {
+        auto history = odd.getPnLHistory();
+        assert(history->size() == 10);
+        std::vector<double> positions;
+        history->positions().forEach([&](double position) { positions.push_back(position); });
+        for (size_t i = 0; i < positions.size(); ++i) {
+            assert(positions[i] == 16.0 + i);
+        }
+    }
+    
+    BookHistory book_history(5);
+    for (int i = 1; i <= 12; ++i) {
+        book_history.push(std::chrono::system_clock::now(), TopOfBook{}, static_cast<double>(i));
+    }
+    {
+        std::vector<double> marks;
+        book_history.markPrices().forEach([&](double mark) { marks.push_back(mark); });
+        assert((marks == std::vector<double>{8.0, 9.0, 10.0, 11.0, 12.0}));
+    }
+    
+    // Evicted rows spill to mapped segments and stay queryable by time
+    {
+        PnLCalculator spilled(4);
+        assert(spilled.enableHistorySpill("test_spill", 3));
+        auto start = Clock::wallNow();  // Trades are stamped in Clock wall time
+        for (int i = 1; i <= 10; ++i) {
+            spilled.recordTrade(100.0 + i, 1.0, 1.0);
+        }
+        auto end = Clock::wallNow();
+        assert(spilled.getSpilledTradeCount() == 6);
+        assert(spilled.getSpilledSnapshotCount() == 6);
+        
+        auto trades = spilled.getTradesBetween(start, end);
+        assert(trades.size() == 10);
+        for (int i = 0; i < 10; ++i) {
+            assert(trades[i].price == 101.0 + i);
+        }
+        assert(spilled.getSnapshotsBetween(start, end).size() == 10);
+        assert(spilled.getTradesBetween(end + std::chrono::seconds(1), end + std::chrono::seconds(2)).empty());
+        
+        spilled.clear();
+        assert(spilled.getSpilledTradeCount() == 0);
+    }
+    
+    // Hot window plus spilled segments return exactly the recorded sequence
+    // when the ring capacity is not a power of two
+    {
+        auto open_fds = []() {
+            std::error_code error;
+            auto fds = std::filesystem::directory_iterator("/proc/self/fd", error);
+            return error ? 0 : std::distance(fds, std::filesystem::directory_iterator());
+        };
+        auto fds_before = open_fds();
+        PnLCalculator spilled(10);
+        assert(spilled.enableHistorySpill("test_spill", 7));
+        auto start = Clock::wallNow();
+        for (int i = 1; i <= 37; ++i) {
+            spilled.recordTrade(100.0 + i, 1.0, 1.0);
+        }
+        auto end = Clock::wallNow();
+        assert(spilled.getSpilledTradeCount() == 27);
+        assert(spilled.getSpilledSnapshotCount() == 27);
+        // Four segments per log, but only each log's active one stays open
+        assert(open_fds() - fds_before <= 2);
+        
+        auto trades = spilled.getTradesBetween(start, end);
+        assert(trades.size() == 37);
+        for (int i = 0; i < 37; ++i) {
+            assert(trades[i].price == 101.0 + i);
+        }
+        auto snapshots = spilled.getSnapshotsBetween(start, end);
+        assert(snapshots.size() == 37);
+        for (int i = 0; i < 37; ++i) {
+            assert(snapshots[i].position == 1.0 + i);
+        }
+    }
+    
+    // Enabling spill again on the same directory restarts the log in place.
+    // The first log ends with a partly filled segment, and the second writes
+    // several pages into the same file.
+    {
+        PnLCalculator respilled(4);
+        assert(respilled.enableHistorySpill("test_spill", 256));
+        for (int i = 1; i <= 5; ++i) {
+            respilled.recordTrade(100.0 + i, 1.0, 1.0);
+        }
+        assert(respilled.getSpilledTradeCount() == 1);
+        assert(respilled.enableHistorySpill("test_spill", 256));
+        assert(respilled.getSpilledTradeCount() == 0);
+        auto start = Clock::wallNow();
+        for (int i = 1; i <= 200; ++i) {
+            respilled.recordTrade(200.0 + i, 1.0, 1.0);
+        }
+        auto end = Clock::wallNow();
+        assert(respilled.getSpilledTradeCount() == 200);
+        auto trades = respilled.getTradesBetween(start, end);
+        assert(trades.size() == 200);
+        for (int i = 0; i < 200; ++i) {
+            assert(trades[i].price == 201.0 + i);
+        }
+    }
+    std::filesystem::remove_all("test_spill");
+    
+    // CSV export keeps sub-second timestamps and round-trips numbers
+    {
+        PnLCalculator exported;
+        exported.recordTrade(100.25, 3.0, 1.0);
+        exported.updateMarkPrice(101.0);
+        exported.exportToCSV("test_pnl_export.csv");
+        
+        std::ifstream csv("test_pnl_export.csv");
+        std::string header, row, last_row;
+        std::getline(csv, header);
+        assert(header == "Timestamp,RealizedPnL,UnrealizedPnL,TotalPnL,Position,MarkPrice,DailyPnL,CumulativePnL");
+        size_t rows = 0;
+        while (std::getline(csv, row)) {
+            ++rows;
+            assert(row.size() > 26 && row[19] == '.' && row[26] == ',');
+            last_row = row;
+        }
+        assert(rows == 2);
+        assert(last_row.substr(27, 12) == "0,2.25,2.25,");
+        csv.close();
+        std::remove("test_pnl_export.csv");
+    }
+    
+    // Win rate and profit factor count fills that realize PnL
+    PnLCalculator outcomes;
+    outcomes.recordTrade(100.0, 10.0, 1.0);
+    outcomes.recordTrade(103.0, 5.0, -1.0);   // +15
+    outcomes.recordTrade(99.0, 5.0, -1.0);    // -5
+    assert(outcomes.getWinRate() == 0.5);
+    assert(outcomes.getProfitFactor() == 3.0);
+    
+    // Streaming Sharpe/volatility match a direct pass over the same window
+    PnLCalculator streaming;
+    streaming.setMetricsWindow(50);
+    for (int i = 0; i < 400; ++i) {
+        streaming.updateMarkPrice(100.0 + (i % 7));
+        streaming.recordTrade(100.0 + (i % 13), 1.0 + (i % 3), (i % 2 == 0) ? 1.0 : -1.0);
+    }
+    auto all_returns = streaming.getReturns();
+    auto tail_stddev = [&all_returns](size_t n) {
+        std::vector<double> tail(all_returns.end() - n, all_returns.end());
+        double mean = std::accumulate(tail.begin(), tail.end(), 0.0) / n;
+        double variance = 0.0;
+        for (double r : tail) variance += (r - mean) * (r - mean);
+        return std::sqrt(variance / n);
+    };
+    assert(std::abs(streaming.getVolatility(50) - tail_stddev(50)) < 1e-9);   // Streaming window
+    assert(std::abs(streaming.getVolatility(30) - tail_stddev(30)) < 1e-9);   // Other lookback
+    assert(!streaming.generateReport().empty());
+    
     std::cout << "PnLCalculator tests passed!\n";
 }
 
+void testSnapshotPolicies() {
+    std::cout << "Testing PnL snapshot policies...\n";
+    
+    PnLCalculator every_n;
+    SnapshotConfig config;
+    config.policy = SnapshotPolicy::EVERY_N_TICKS;
+    config.every_n_ticks = 10;
+    every_n.setSnapshotConfig(config);
+    for (int i = 0; i < 100; ++i) {
+        every_n.updateMarkPrice(100.0 + i);
+    }
+    assert(every_n.getPnLHistory()->size() == 10);
+    
+    // Flat position and unchanged PnL only produce the first snapshot
+    PnLCalculator on_change;
+    config.policy = SnapshotPolicy::ON_CHANGE;
+    on_change.setSnapshotConfig(config);
+    for (int i = 0; i < 100; ++i) {
+        on_change.updateMarkPrice(100.0 + i);
+    }
+    assert(on_change.getPnLHistory()->size() == 1);
+    
+    // A long bucket folds every update into one OHLC bar. Buckets are aligned
+    // to the epoch, so a run crossing a bucket boundary (UTC midnight) may
+    // split the updates over two bars; the fold across bars is the same.
+    PnLCalculator ohlc;
+    config.policy = SnapshotPolicy::TIME_BUCKET_OHLC;
+    config.bucket_interval = std::chrono::hours(24);
+    ohlc.setSnapshotConfig(config);
+    auto first_bucket = Clock::wallNow().time_since_epoch() / config.bucket_interval;
+    ohlc.recordTrade(100.0, 10.0, 1.0);
+    ohlc.updateMarkPrice(105.0);
+    ohlc.updateMarkPrice(95.0);
+    ohlc.updateMarkPrice(101.0);
+    auto last_bucket = Clock::wallNow().time_since_epoch() / config.bucket_interval;
+    size_t bar_count = 0;
+    {
+        auto bars = ohlc.getPnLBars();
+        bar_count = bars.size();
+        assert(bar_count >= 1 && bar_count <= static_cast<size_t>(last_bucket - first_bucket + 1));
+        double high = bars[0].high;
+        double low = bars[0].low;
+        uint64_t updates = 0;
+        for (size_t i = 0; i < bar_count; ++i) {
+            high = std::max(high, bars[i].high);
+            low = std::min(low, bars[i].low);
+            updates += bars[i].updates;
+        }
+        assert(high == 50.0);
+        assert(low == -50.0);
+        assert(bars.back().close == 10.0);
+        assert(updates == 4);
+    }
+    // The bars view is released before taking the history view (pnl_mutex
+    // is not recursive)
+    assert(ohlc.getPnLHistory()->size() == bar_count);
+    
+    std::cout << "Snapshot policy tests passed!\n";
+}
+
+void testSeqLockPublication() {
+    std::cout << "Testing lock-free PnL state publication...\n";
+    
+    // Readers on another thread must never observe a torn state block
+    PnLCalculator pnl_calc;
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> torn_reads{0};
+    
+    std::thread reader([&]() {
+        while (!done.load()) {
+            PnLState state = pnl_calc.getState();
+            double expected_unrealized = state.mark_price > 0.0 ?
+                state.position * (state.mark_price - state.average_cost) : 0.0;
+            if (std::abs(state.unrealized_pnl - expected_unrealized) > 1e-6 ||
+                std::abs(state.total_pnl - (state.realized_pnl + state.unrealized_pnl)) > 1e-6) {
+                torn_reads++;
+            }
+        }
+    });
+    
+    pnl_calc.recordTrade(100.0, 10.0, 1.0);
+    for (int i = 0; i < 200000; ++i) {
+        pnl_calc.updateMarkPrice(100.0 + (i % 100) * 0.01);
+    }
+    done.store(true);
+    reader.join();
+    
+    assert(torn_reads.load() == 0);
+    PnLState state = pnl_calc.getState();
+    assert(state.position == 10.0);
+    assert(state.average_cost == 100.0);
+    assert(state.update_count == 200001);
+    
+    std::cout << "Lock-free publication tests passed!\n";
+}
+
+void testLotEngine() {
+    std::cout << "Testing LotEngine class...\n";
+    
+    // FIFO closes the oldest lot first
+    LotEngine fifo(CostBasisMethod::FIFO);
+    fifo.applyFill(100.0, 10.0);
+    fifo.applyFill(100.0, 12.0);
+    assert(fifo.applyFill(-150.0, 13.0) == 100.0 * 3.0 + 50.0 * 1.0);
+    assert(fifo.getPosition() == 50.0);
+    assert(fifo.getAverageCost() == 12.0);
+    assert(fifo.getOpenLotCount() == 1);
+    
+    // LIFO closes the newest lot first
+    LotEngine lifo(CostBasisMethod::LIFO);
+    lifo.applyFill(100.0, 10.0);
+    lifo.applyFill(100.0, 12.0);
+    assert(lifo.applyFill(-150.0, 13.0) == 100.0 * 1.0 + 50.0 * 3.0);
+    assert(lifo.getAverageCost() == 10.0);
+    
+    // Average cost pools all open quantity
+    LotEngine avg(CostBasisMethod::AVERAGE_COST);
+    avg.applyFill(100.0, 10.0);
+    avg.applyFill(100.0, 12.0);
+    assert(avg.applyFill(-100.0, 13.0) == 200.0);
+    assert(avg.getAverageCost() == 11.0);
+    
+    // Short positions and flipping through flat
+    LotEngine shorts(CostBasisMethod::FIFO);
+    shorts.applyFill(-100.0, 20.0);
+    assert(shorts.getUnrealizedPnL(19.0) == 100.0);
+    assert(shorts.applyFill(150.0, 19.0) == 100.0);
+    assert(shorts.getPosition() == 50.0);
+    assert(shorts.getAverageCost() == 19.0);
+    assert(shorts.getRealizedPnL() == 100.0);
+    
+    std::cout << "LotEngine tests passed!\n";
+}
+
+void testPortfolioPnL() {
+    std::cout << "Testing PortfolioPnL class...\n";
+    
+    PortfolioPnL book(CostBasisMethod::FIFO, 1);
+    SymbolId aapl = book.registerSymbol("AAPL");
+    SymbolId msft = book.registerSymbol("MSFT");
+    StrategyId mm = book.registerStrategy("market_making");
+    StrategyId arb = book.registerStrategy("stat_arb");
+    assert(book.registerSymbol("AAPL") == aapl);
+    assert(book.getSymbolId("MSFT") == msft);
+    assert(book.getSymbolName(aapl) == "AAPL");
+    
+    book.applyFill(mm, aapl, 100.0, 150.0);
+    book.applyFill(arb, aapl, -50.0, 151.0);
+    book.applyFill(mm, msft, 10.0, 300.0);
+    assert(book.getSlotCount() == 3);
+    assert(book.applyFill(mm, aapl, -40.0, 152.0) == 80.0);
+    assert(book.getPosition(mm, aapl) == 60.0);
+    
+    double marks[] = {152.0, 305.0};
+    book.markToMarket(marks, 2);
+    
+    PnLTotals totals = book.getBookTotals();
+    assert(totals.realized_pnl == 80.0);
+    assert(std::abs(totals.unrealized_pnl - (120.0 - 50.0 + 50.0)) < 1e-9);
+    assert(std::abs(totals.total_pnl - (totals.realized_pnl + totals.unrealized_pnl)) < 1e-9);
+    assert(std::abs(totals.net_exposure - (10.0 * 152.0 + 10.0 * 305.0)) < 1e-9);
+    
+    std::vector<PnLTotals> by_symbol = book.getTotalsBySymbol();
+    std::vector<PnLTotals> by_strategy = book.getTotalsByStrategy();
+    assert(std::abs(by_symbol[aapl].unrealized_pnl - 70.0) < 1e-9);
+    assert(std::abs(by_strategy[arb].unrealized_pnl + 50.0) < 1e-9);
+    
+    // Parallel reduction agrees with the single-threaded pass
+    PortfolioPnL large(CostBasisMethod::AVERAGE_COST, 4);
+    std::vector<double> large_marks;
+    for (int s = 0; s < 64; ++s) {
+        large.registerSymbol("SYM" + std::to_string(s));
+        large_marks.push_back(100.0 + s);
+    }
+    for (int a = 0; a < 400; ++a) {
+        StrategyId account = large.registerStrategy("ACCT" + std::to_string(a));
+        for (int s = 0; s < 64; ++s) {
+            large.applyFill(account, s, (a % 7) - 3.0, 100.0);
+        }
+    }
+    large.markToMarket(large_marks.data(), large_marks.size());
+    PnLTotals parallel_totals = large.getBookTotals();
+    large.setWorkerThreads(1);
+    PnLTotals serial_totals = large.getBookTotals();
+    assert(std::abs(parallel_totals.total_pnl - serial_totals.total_pnl) < 1e-6);
+    assert(std::abs(parallel_totals.gross_exposure - serial_totals.gross_exposure) < 1e-6);
+
+    // Pooled lot rings grow, wrap and compact without diverging from LotEngine
+    for (CostBasisMethod method : {CostBasisMethod::FIFO, CostBasisMethod::LIFO}) {
+        PortfolioPnL pooled(method, 1);
+        pooled.registerStrategy("MM");
+        std::vector<LotEngine> engines;
+        for (int s = 0; s < 5; ++s) {
+            pooled.registerSymbol("LOT" + std::to_string(s));
+            engines.emplace_back(method);
+        }
+        for (int i = 0; i < 600; ++i) {
+            SymbolId s = static_cast<SymbolId>((i * 7) % 5);
+            // Runs of buys build up lots; every third run sells some of them back
+            double quantity = (i / 40) % 3 == 2 ? -3.0 - (i % 4) : 1.0 + (i % 5);
+            double price = 100.0 + (i % 17) * 0.25;
+            double expected = engines[s].applyFill(quantity, price);
+            assert(pooled.applyFill(0, s, quantity, price) == expected);
+            assert(pooled.getPosition(0, s) == engines[s].getPosition());
+            assert(pooled.getOpenLotCount(0, s) == engines[s].getOpenLotCount());
+        }
+    }
+
+    // Every task of a batch runs exactly once, batch after batch
+    WorkerPool pool(4);
+    std::vector<std::atomic<int>> hits(37);
+    for (int batch = 0; batch < 50; ++batch) {
+        auto mark = [&hits](size_t i) { hits[i].fetch_add(1, std::memory_order_relaxed); };
+        pool.run(hits.size(), mark);
+    }
+    pool.resize(2);
+    auto mark = [&hits](size_t i) { hits[i].fetch_add(1, std::memory_order_relaxed); };
+    pool.run(hits.size(), mark);
+    for (auto& hit : hits) {
+        assert(hit.load() == 51);
+    }
+
+    std::cout << "PortfolioPnL tests passed!\n";
+}
+
+void testColumnarFile() {
+    std::cout << "Testing columnar binary export...\n";
+    
+    // Integer columns pick the narrowest codec and round-trip exactly
+    const size_t rows = 1000;
+    std::vector<int64_t> timestamps(rows);
+    std::vector<uint64_t> ids(rows);
+    std::vector<double> prices(rows);
+    std::vector<int8_t> sides(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        timestamps[i] = 1700000000000000000LL + static_cast<int64_t>(i) * 1000 + (i % 3);
+        ids[i] = 5000000000ULL + (i * 97) % 256;
+        prices[i] = 100.0 + i * 0.01;
+        sides[i] = (i % 2 == 0) ? 1 : -1;
+    }
+    
+    ColumnarFileWriter writer(rows);
+    writer.addInt64("Timestamp", timestamps);
+    writer.addUInt64("TradeID", ids);
+    writer.addFloat64("Price", prices);
+    writer.addInt8("Side", sides);
+    assert(writer.write("test_columns.hftc"));
+    
+    ColumnarFileReader reader("test_columns.hftc");
+    assert(reader.isValid());
+    assert(reader.getRowCount() == rows);
+    assert(reader.getColumnNames().size() == 4);
+    assert(reader.findColumn("Timestamp")->codec == static_cast<uint8_t>(ColumnCodec::DELTA_FOR));
+    assert(reader.findColumn("Timestamp")->width == 1);
+    assert(reader.findColumn("TradeID")->codec == static_cast<uint8_t>(ColumnCodec::FOR));
+    assert(reader.findColumn("TradeID")->width == 1);
+    assert(reader.findColumn("Price")->codec == static_cast<uint8_t>(ColumnCodec::RAW));
+    assert(reader.findColumn("Price")->data_offset % 64 == 0);
+    assert(reader.getInt64("Timestamp") == timestamps);
+    assert(reader.getUInt64("TradeID") == ids);
+    assert(reader.getFloat64("Price") == prices);
+    assert(reader.getInt8("Side") == sides);
+    assert(reader.getFloat64("Timestamp").empty());
+    
+    // Truncated or corrupt files are rejected instead of read out of bounds
+    std::vector<char> original;
+    {
+        std::ifstream in("test_columns.hftc", std::ios::binary);
+        original.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto rewrite = [](const std::vector<char>& bytes) {
+        std::ofstream out("test_columns.hftc", std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    };
+    auto entry_field = [](size_t column, size_t field) {
+        return sizeof(ColumnarFileHeader) + column * sizeof(ColumnEntry) + field;
+    };
+    std::vector<char> corrupt = original;
+    uint64_t more_rows = rows + 1;  // Columns now hold fewer elements than the header claims
+    std::memcpy(corrupt.data() + offsetof(ColumnarFileHeader, row_count), &more_rows, sizeof(more_rows));
+    rewrite(corrupt);
+    assert(!ColumnarFileReader("test_columns.hftc").isValid());
+    
+    corrupt = original;
+    uint64_t wrapping_offset = ~0ULL - 8;  // offset + size wraps around to a small value
+    std::memcpy(corrupt.data() + entry_field(2, offsetof(ColumnEntry, data_offset)), &wrapping_offset, 8);
+    rewrite(corrupt);
+    assert(!ColumnarFileReader("test_columns.hftc").isValid());
+    
+    corrupt = original;
+    corrupt[entry_field(0, offsetof(ColumnEntry, width))] = 3;
+    rewrite(corrupt);
+    assert(!ColumnarFileReader("test_columns.hftc").isValid());
+    
+    corrupt = original;
+    corrupt.resize(corrupt.size() - 64);  // Cut into the last column
+    rewrite(corrupt);
+    assert(!ColumnarFileReader("test_columns.hftc").isValid());
+    
+    rewrite(original);
+    assert(ColumnarFileReader("test_columns.hftc").isValid());
+    std::remove("test_columns.hftc");
+    
+    // PnL snapshots export through the same format
+    PnLCalculator pnl_calc;
+    pnl_calc.recordTrade(100.0, 10.0, 1.0);
+    pnl_calc.updateMarkPrice(101.5);
+    assert(pnl_calc.exportToColumnar("test_pnl.hftc"));
+    ColumnarFileReader pnl_reader("test_pnl.hftc");
+    assert(pnl_reader.getRowCount() == 2);
+    assert(pnl_reader.getFloat64("UnrealizedPnL").back() == 15.0);
+    std::remove("test_pnl.hftc");
+    
+    std::cout << "Columnar binary export tests passed!\n";
+}
+
+void testEventLog() {
+    std::cout << "Testing live event log...\n";
+    
+    EventLogWriter writer("test_events.hftlog", 8);
+    assert(writer.isOpen());
+    assert(writer.getCapacity() == 8);
+    
+    EventLogReader reader("test_events.hftlog");
+    assert(reader.isOpen());
+    
+    std::vector<EventRecord> batch;
+    assert(reader.poll(batch) == 0);
+    
+    for (int i = 0; i < 5; ++i) {
+        double values[6] = {100.0 + i, 99.0, 101.0, 0.0, 0.0, static_cast<double>(i)};
+        writer.append(EventType::TICK, 1000 + i, values, 6);
+    }
+    assert(reader.poll(batch) == 5);
+    assert(batch[4].timestamp_ns == 1004);
+    assert(batch[4].values[0] == 104.0);
+    assert(batch[4].type == static_cast<uint32_t>(EventType::TICK));
+    
+    // A reader that falls more than one ring behind skips what was overwritten
+    for (int i = 5; i < 25; ++i) {
+        double value = static_cast<double>(i);
+        writer.append(EventType::TICK, 1000 + i, &value, 1);
+    }
+    batch.clear();
+    assert(reader.poll(batch) == 7);
+    assert(reader.getDropped() == 13);
+    assert(batch.front().values[0] == 18.0);
+    assert(batch.back().values[0] == 24.0);
+    assert(reader.getPosition() == writer.getWriteCursor());
+    
+    // A second reader follows concurrently while the writer keeps going
+    EventLogWriter live("test_events_live.hftlog", 1024);
+    EventLogReader follower("test_events_live.hftlog");
+    std::thread producer([&live]() {
+        for (int i = 0; i < 20000; ++i) {
+            double value = static_cast<double>(i);
+            live.append(EventType::TICK, i, &value, 1);
+        }
+    });
+    uint64_t seen = 0;
+    bool ordered = true;
+    int64_t last_ts = -1;
+    std::vector<EventRecord> live_batch;
+    while (seen + follower.getDropped() < 20000) {
+        live_batch.clear();
+        follower.poll(live_batch);
+        for (const auto& record : live_batch) {
+            ordered = ordered && record.timestamp_ns > last_ts &&
+                      record.values[0] == static_cast<double>(record.timestamp_ns);
+            last_ts = record.timestamp_ns;
+        }
+        seen += live_batch.size();
+    }
+    producer.join();
+    assert(ordered);
+    assert(seen + follower.getDropped() == 20000);
+    
+    
+    // A follower opened before the log exists attaches once it appears, and
+    // switches to the new log when the writer restarts
+    std::remove("test_events_restart.hftlog");
+    EventLogReader early("test_events_restart.hftlog");
+    assert(!early.isOpen());
+    std::vector<EventRecord> restart_batch;
+    {
+        EventLogWriter first("test_events_restart.hftlog", 16);
+        for (int i = 0; i < 5; ++i) {
+            double value = static_cast<double>(i);
+            first.append(EventType::TICK, i, &value, 1);
+        }
+        assert(early.poll(restart_batch) == 5);
+        assert(early.isOpen() && early.getRestarts() == 0);
+    }
+    EventLogWriter second("test_events_restart.hftlog", 16);
+    for (int i = 0; i < 3; ++i) {
+        double value = 100.0 + i;
+        second.append(EventType::TICK, i, &value, 1);
+    }
+    restart_batch.clear();
+    assert(early.poll(restart_batch) == 3);
+    assert(restart_batch.front().values[0] == 100.0 && restart_batch.back().values[0] == 102.0);
+    assert(early.getRestarts() == 1 && early.getDropped() == 0);
+    restart_batch.clear();
+    assert(early.poll(restart_batch) == 0);
+    assert(early.getRestarts() == 1);
+    
+    std::remove("test_events.hftlog");
+    std::remove("test_events_live.hftlog");
+    std::remove("test_events_restart.hftlog");
+    
+    std::cout << "Live event log tests passed!\n";
+}
+
+void testSlidingStats() {
+    std::cout << "Testing sliding-window statistics...\n";
+    
+    // Random walk far from zero so the shifted sums matter
+    std::vector<double> prices;
+    std::vector<double> other;
+    double price = 10000.0;
+    for (int i = 0; i < 5000; ++i) {
+        price += std::sin(i * 0.37) * 0.5 + ((i * 7919) % 13 - 6) * 0.01;
+        prices.push_back(price);
+        other.push_back(std::cos(i * 0.11) + 0.3 * price);
+    }
+    
+    const size_t window = 50;
+    size_t outputs = prices.size() - window + 1;
+    std::vector<double> mean(outputs), stddev(outputs), lo(outputs), hi(outputs), z(outputs), corr(outputs);
+    sliding::rollingMean(prices.data(), prices.size(), window, mean.data());
+    sliding::rollingStddev(prices.data(), prices.size(), window, stddev.data(), true);
+    sliding::rollingMin(prices.data(), prices.size(), window, lo.data());
+    sliding::rollingMax(prices.data(), prices.size(), window, hi.data());
+    sliding::rollingZScore(prices.data(), prices.size(), window, z.data());
+    sliding::rollingCorrelation(prices.data(), other.data(), prices.size(), window, corr.data());
+    
+    RollingMoments moments(window);
+    RollingMinMax extremes(window);
+    RollingCorrelation streaming_corr(window);
+    for (size_t i = 0; i < prices.size(); ++i) {
+        moments.add(prices[i]);
+        extremes.add(prices[i]);
+        streaming_corr.add(prices[i], other[i]);
+        if (i + 1 < window) continue;
+        
+        // Naive reference over the same window
+        size_t start = i + 1 - window;
+        std::vector<double> w(prices.begin() + start, prices.begin() + i + 1);
+        std::vector<double> v(other.begin() + start, other.begin() + i + 1);
+        double naive_mean = std::accumulate(w.begin(), w.end(), 0.0) / window;
+        double ss = 0.0;
+        for (double x : w) ss += (x - naive_mean) * (x - naive_mean);
+        double naive_sd = std::sqrt(ss / (window - 1));
+        double naive_z = (w.back() - naive_mean) / std::sqrt(ss / window);
+        
+        assert(std::abs(mean[start] - naive_mean) < 1e-9);
+        assert(std::abs(stddev[start] - naive_sd) < 1e-7);
+        assert(lo[start] == *std::min_element(w.begin(), w.end()));
+        assert(hi[start] == *std::max_element(w.begin(), w.end()));
+        assert(std::abs(z[start] - naive_z) < 1e-6);
+        assert(std::abs(corr[start] - utils::calculateCorrelation(w, v)) < 1e-6);
+        
+        assert(std::abs(moments.mean() - naive_mean) < 1e-9);
+        assert(std::abs(moments.zscore(w.back()) - naive_z) < 1e-6);
+        assert(extremes.min() == lo[start]);
+        assert(extremes.max() == hi[start]);
+        assert(std::abs(streaming_corr.correlation() - corr[start]) < 1e-6);
+    }
+    
+    // The utils wrappers keep their old contract
+    auto averages = utils::calculateRollingAverage(prices, window);
+    auto vols = utils::calculateRollingVolatility(prices, window);
+    assert(averages.size() == outputs && vols.size() == outputs);
+    assert(averages[outputs - 1] == mean[outputs - 1]);
+    assert(vols[0] == stddev[0]);
+    assert(utils::calculateRollingAverage(prices, prices.size() + 1).empty());
+    assert(utils::calculateRollingVolatility(prices, 1)[0] == 0.0);
+    
+    // EMA: batch and streaming agree, first sample seeds
+    std::vector<double> smoothed(prices.size());
+    sliding::ema(prices.data(), prices.size(), 0.1, smoothed.data());
+    Ema ema(0.1);
+    for (size_t i = 0; i < prices.size(); ++i) {
+        assert(std::abs(ema.add(prices[i]) - smoothed[i]) < 1e-9);
+    }
+    assert(smoothed[0] == prices[0]);
+    assert(std::abs(Ema::fromSpan(19).getAlpha() - 0.1) < 1e-12);
+    
+    std::cout << "Sliding-window statistics tests passed!\n";
+}
+
+void testNumericKernels() {
+    std::cout << "Testing vectorized numeric kernels...\n";
+    
+    std::vector<double> x;
+    std::vector<double> y;
+    for (int i = 0; i < 10007; ++i) {
+        x.push_back(100.0 + std::sin(i * 0.013) * 5.0 + (i % 17) * 0.001);
+        y.push_back(std::cos(i * 0.029) - (i % 5) * 0.01);
+    }
+    
+    // Long double references
+    auto reference = [&](size_t n, long double& sum, long double& ssd, long double& dot,
+                         long double& sxy, double& drawdown) {
+        sum = 0.0L;
+        long double sum_y = 0.0L;
+        for (size_t i = 0; i < n; ++i) { sum += x[i]; sum_y += y[i]; }
+        long double mx = n ? sum / n : 0.0L, my = n ? sum_y / n : 0.0L;
+        ssd = dot = sxy = 0.0L;
+        for (size_t i = 0; i < n; ++i) {
+            ssd += (x[i] - mx) * (x[i] - mx);
+            dot += static_cast<long double>(x[i]) * y[i];
+            sxy += (x[i] - mx) * (y[i] - my);
+        }
+        drawdown = 0.0;
+        double peak = n ? x[0] : 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            peak = std::max(peak, x[i]);
+            drawdown = std::max(drawdown, peak - x[i]);
+        }
+    };
+    
+    kernels::Isa original = kernels::activeIsa();
+    assert(kernels::isSupported(kernels::Isa::SCALAR));
+    for (kernels::Isa isa : {kernels::Isa::SCALAR, kernels::Isa::SSE4, kernels::Isa::AVX2, kernels::Isa::AVX512}) {
+        if (!kernels::setIsa(isa)) continue;
+        assert(kernels::activeIsa() == isa);
+        
+        // Every tail length, then sizes that go through the pairwise split
+        for (size_t n : {0, 1, 2, 3, 5, 7, 8, 9, 15, 16, 17, 31, 33, 63, 511, 512, 513, 4099, 10007}) {
+            long double sum, ssd, dot, sxy;
+            double drawdown;
+            reference(n, sum, ssd, dot, sxy, drawdown);
+            double mean = n ? static_cast<double>(sum / n) : 0.0;
+            double mean_y = n ? kernels::mean(y.data(), n) : 0.0;
+            
+            assert(std::abs(kernels::sum(x.data(), n) - static_cast<double>(sum)) < 1e-9);
+            assert(std::abs(kernels::sumSquaredDeviations(x.data(), n, mean) - static_cast<double>(ssd)) < 1e-7);
+            assert(std::abs(kernels::dot(x.data(), y.data(), n) - static_cast<double>(dot)) < 1e-8);
+            assert(std::abs(kernels::crossMoments(x.data(), y.data(), n, mean, mean_y).sxy -
+                            static_cast<double>(sxy)) < 1e-8);
+            assert(kernels::maxDrawdown(x.data(), n) == drawdown);  // Exact: only max and subtract
+            
+            // Window statistics against naive per-window references
+            if (n > 40) {
+                const size_t window = 40;
+                size_t count = n - window + 1;
+                double k = x[0];
+                double ky = y[0];
+                double s1 = 0.0, s2 = 0.0;
+                kernels::WindowSums sums{0.0, 0.0, 0.0, 0.0, 0.0};
+                for (size_t j = 0; j < window; ++j) {
+                    s1 += x[j] - k;
+                    s2 += (x[j] - k) * (x[j] - k);
+                    sums.sx += x[j] - k;
+                    sums.sy += y[j] - ky;
+                    sums.sxx += (x[j] - k) * (x[j] - k);
+                    sums.syy += (y[j] - ky) * (y[j] - ky);
+                    sums.sxy += (x[j] - k) * (y[j] - ky);
+                }
+                std::vector<double> means(count), vars(count), sds(count), zs(count), corrs(count);
+                kernels::windowStat(kernels::WindowStat::MEAN, x.data(), count, window, k, s1, s2, 0.0, means.data());
+                kernels::windowStat(kernels::WindowStat::VARIANCE, x.data(), count, window, k, s1, s2,
+                                    1.0 / (window - 1), vars.data());
+                kernels::windowStat(kernels::WindowStat::STDDEV, x.data(), count, window, k, s1, s2,
+                                    1.0 / (window - 1), sds.data());
+                kernels::windowStat(kernels::WindowStat::ZSCORE, x.data(), count, window, k, s1, s2, 0.0, zs.data());
+                kernels::windowCorrelation(x.data(), y.data(), count, window, k, ky, sums, corrs.data());
+                for (size_t j = 0; j < count; ++j) {
+                    const double* w = x.data() + j;
+                    long double m = std::accumulate(w, w + window, 0.0L) / window;
+                    long double ss = 0.0L;
+                    for (size_t i = 0; i < window; ++i) ss += (w[i] - m) * (w[i] - m);
+                    assert(std::abs(means[j] - static_cast<double>(m)) < 1e-9);
+                    assert(std::abs(vars[j] - static_cast<double>(ss / (window - 1))) < 1e-8);
+                    assert(std::abs(sds[j] - std::sqrt(static_cast<double>(ss / (window - 1)))) < 1e-8);
+                    assert(std::abs(zs[j] - static_cast<double>((w[window - 1] - m) / std::sqrt(ss / window))) < 1e-6);
+                    std::vector<double> wx(w, w + window), wy(y.begin() + j, y.begin() + j + window);
+                    assert(std::abs(corrs[j] - utils::calculateCorrelation(wx, wy)) < 1e-6);
+                }
+            }
+            
+            // Flat windows are degenerate: zero variance, z-score and correlation
+            if (n == 63) {
+                std::vector<double> flat(n, 100.25), stats(n - 9);
+                for (kernels::WindowStat stat : {kernels::WindowStat::VARIANCE, kernels::WindowStat::STDDEV,
+                                                 kernels::WindowStat::ZSCORE}) {
+                    kernels::windowStat(stat, flat.data(), stats.size(), 10, 100.25, 0.0, 0.0, 1.0 / 9, stats.data());
+                    assert(std::all_of(stats.begin(), stats.end(), [](double v) { return v == 0.0; }));
+                }
+                kernels::windowCorrelation(flat.data(), y.data(), stats.size(), 10, 100.25, y[0],
+                                           kernels::WindowSums{0.0, 0.0, 0.0, 0.0, 0.0}, stats.data());
+                assert(std::all_of(stats.begin(), stats.end(), [](double v) { return v == 0.0; }));
+            }
+            
+            // Running sum and decaying recurrence, in place and out of place
+            for (double decay : {1.0, 0.9}) {
+                std::vector<double> scanned(n);
+                std::vector<double> in_place(y.begin(), y.begin() + n);
+                kernels::linearScan(y.data(), n, decay, 2.5, scanned.data());
+                kernels::linearScan(in_place.data(), n, decay, 2.5, in_place.data());
+                long double prev = 2.5L;
+                for (size_t i = 0; i < n; ++i) {
+                    prev = decay * prev + y[i];
+                    assert(std::abs(scanned[i] - static_cast<double>(prev)) < 1e-9);
+                    assert(scanned[i] == in_place[i]);
+                }
+            }
+        }
+        
+        // Sliding statistics route their running sums through the active ISA
+        const size_t window = 100;
+        std::vector<double> rolling(x.size() - window + 1);
+        sliding::rollingMean(x.data(), x.size(), window, rolling.data());
+        for (size_t i = 0; i < rolling.size(); i += 997) {
+            double naive = std::accumulate(x.begin() + i, x.begin() + i + window, 0.0) / window;
+            assert(std::abs(rolling[i] - naive) < 1e-9);
+        }
+    }
+    assert(!kernels::setIsa(static_cast<kernels::Isa>(99)));
+    kernels::setIsa(original);
+    
+    // Call sites routed through the kernels
+    std::vector<double> returns(x.begin(), x.begin() + 100);
+    double mean = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
+    double ss = 0.0;
+    for (double r : returns) ss += (r - mean) * (r - mean);
+    assert(std::abs(utils::calculateVolatility(returns) - std::sqrt(ss / 99)) < 1e-12);
+    assert(std::abs(utils::calculateSharpeRatio(returns, 1.0) - (mean - 1.0) / std::sqrt(ss / 99)) < 1e-9);
+    assert(utils::calculateMaxDrawdown({1.0, 3.0, 2.0, 5.0, 1.5, 4.0}) == 3.5);
+    assert(std::abs(utils::calculateCorrelation(x, x) - 1.0) < 1e-12);
+    
+    std::cout << "Numeric kernel tests passed (" << kernels::isaName(kernels::activeIsa()) << ")!\n";
+}
+
+void testRandom() {
+    std::cout << "Testing per-thread random generators...\n";
+    
+    // Reference values for SplitMix64 and xoshiro256++
+    uint64_t sm = 0;
+    assert(Xoshiro256pp::splitMix64(sm) == 0xE220A8397B1DCDAFULL);
+    Xoshiro256pp fixed(1, 2, 3, 4);
+    assert(fixed() == 41943041ULL);
+    
+    // Seeding is deterministic and jumped streams diverge
+    Xoshiro256pp a(42), b(42), c(42);
+    c.jump();
+    bool all_equal = true, any_equal = false;
+    for (int i = 0; i < 100; ++i) {
+        uint64_t va = a(), vb = b(), vc = c();
+        all_equal = all_equal && va == vb;
+        any_equal = any_equal || va == vc;
+    }
+    assert(all_equal && !any_equal);
+    
+    // Batch distributions have the expected moments and ranges
+    const size_t n = 200001;
+    std::vector<double> values(n);
+    a.fillUniform(values.data(), n, 2.0, 4.0);
+    assert(*std::min_element(values.begin(), values.end()) >= 2.0);
+    assert(*std::max_element(values.begin(), values.end()) < 4.0);
+    assert(std::abs(kernels::mean(values.data(), n) - 3.0) < 0.01);
+    
+    a.fillNormal(values.data(), n, 1.0, 2.0);
+    assert(std::abs(kernels::mean(values.data(), n) - 1.0) < 0.02);
+    assert(std::abs(std::sqrt(kernels::variance(values.data(), n, true)) - 2.0) < 0.02);
+    
+    a.fillExponential(values.data(), n, 4.0);
+    assert(*std::min_element(values.begin(), values.end()) > 0.0);
+    assert(std::abs(kernels::mean(values.data(), n) - 0.25) < 0.005);
+    
+    bool in_range = true, saw_min = false, saw_max = false;
+    for (int i = 0; i < 10000; ++i) {
+        int64_t v = a.uniformInt(-3, 3);
+        in_range = in_range && v >= -3 && v <= 3;
+        saw_min = saw_min || v == -3;
+        saw_max = saw_max || v == 3;
+    }
+    assert(in_range && saw_min && saw_max);
+    
+    // Same master seed and stream: same sequence, on any thread
+    rng::setMasterSeed(12345);
+    rng::bindThreadStream(0);
+    uint64_t main_first = rng::threadGenerator()();
+    double main_uniform = utils::generateRandomDouble(0.0, 1.0);
+    
+    uint64_t worker_first = 0, other_first = 0;
+    double worker_uniform = 0.0;
+    std::thread worker([&]() {
+        rng::bindThreadStream(0);
+        worker_first = rng::threadGenerator()();
+        worker_uniform = utils::generateRandomDouble(0.0, 1.0);
+    });
+    worker.join();
+    std::thread other([&]() {
+        rng::bindThreadStream(1);
+        other_first = rng::threadGenerator()();
+    });
+    other.join();
+    assert(worker_first == main_first && worker_uniform == main_uniform);
+    assert(other_first != main_first);
+    
+    // Threads that never bind a stream are kept out of the reserved ones
+    uint64_t unbound_stream = 0;
+    std::thread unbound([&]() { unbound_stream = rng::getThreadStream(); });
+    unbound.join();
+    assert(unbound_stream >= rng::RESERVED_STREAMS);
+    
+    // Reseeding the master restarts the bound stream
+    rng::setMasterSeed(12345);
+    assert(rng::threadGenerator()() == main_first);
+    assert(rng::getThreadStream() == 0);
+    
+    // A stream starts at the master generator jumped once per stream index,
+    // whether its start is computed fresh or taken from the cache
+    rng::setMasterSeed(4242);
+    Xoshiro256pp jumped(4242);
+    for (int i = 0; i < 6; ++i) {
+        jumped.jump();
+    }
+    uint64_t expected_first = jumped();
+    for (int repeat = 0; repeat < 2; ++repeat) {
+        uint64_t stream_first = 0;
+        std::thread([&stream_first]() {
+            rng::bindThreadStream(6);
+            stream_first = rng::threadGenerator()();
+        }).join();
+        assert(stream_first == expected_first);
+    }
+    rng::bindThreadStream(2);
+    rng::bindThreadStream(6);
+    assert(rng::threadGenerator()() == expected_first);
+    rng::bindThreadStream(0);
+    
+    // Price paths are reproducible from the master seed
+    rng::setMasterSeed(777);
+    PriceGenerator gen1(100.0, 0.05, 0.20);
+    auto path1 = gen1.generatePriceSeries(1000);
+    rng::setMasterSeed(777);
+    PriceGenerator gen2(100.0, 0.05, 0.20);
+    auto path2 = gen2.generatePriceSeries(1000);
+    assert(path1 == path2);
+    assert(gen1.getTicksGenerated() == 1000);
+    assert(gen1.getCurrentPrice() == path1.back());
+    
+    std::cout << "Random generator tests passed!\n";
+}
+
+void testTokenizer() {
+    std::cout << "Testing zero-copy tokenizer...\n";
+    
+    // Field splitting keeps std::getline semantics
+    std::vector<std::string_view> fields;
+    assert(utils::splitInto("a,,b", ',', fields) == 3 && fields[1].empty() && fields[2] == "b");
+    assert(utils::splitInto("a,b,", ',', fields) == 2 && fields[1] == "b");
+    assert(utils::splitInto(",a", ',', fields) == 2 && fields[0].empty());
+    assert(utils::splitInto("", ',', fields) == 0);
+    assert(utils::splitString("x;y;;z", ';') == (std::vector<std::string>{"x", "y", "", "z"}));
+    
+    // Tokens point into the source buffer
+    std::string line = "1700000000123,BUY,101.25,  50 ";
+    utils::Tokenizer tokenizer(line, ',');
+    std::string_view token;
+    assert(tokenizer.next(token) && token.data() == line.data());
+    assert(tokenizer.rest() == "BUY,101.25,  50 ");
+    
+    // Delimiter found at every offset, across the 16-byte vector steps
+    for (size_t len = 0; len < 48; ++len) {
+        std::string text(len, 'x');
+        assert(utils::findDelimiter(text.data(), text.data() + len, ',') == text.data() + len);
+        for (size_t at = 0; at < len; ++at) {
+            text[at] = ',';
+            assert(utils::findDelimiter(text.data(), text.data() + len, ',') == text.data() + at);
+            text[at] = 'x';
+        }
+    }
+    
+    assert(utils::trimView(" \t value \r\n") == "value");
+    assert(utils::trimView("   ").empty());
+    assert(utils::trimString("  keep me ") == "keep me");
+    
+    // Whole-token number parsing
+    double d = -1.0;
+    int64_t i = 0;
+    uint64_t u = 0;
+    assert(utils::parseDouble(" 101.25 ", d) && d == 101.25);
+    assert(utils::parseDouble("+1e-3", d) && d == 1e-3);
+    assert(utils::parseDouble("-0.5", d) && d == -0.5);
+    assert(!utils::parseDouble("12abc", d) && d == -0.5);
+    assert(!utils::parseDouble("", d) && !utils::parseDouble("+", d) && !utils::parseDouble("+-1", d));
+    assert(utils::parseInt64("-42", i) && i == -42);
+    assert(!utils::parseInt64("4.2", i) && i == -42);
+    assert(utils::parseUInt64("18446744073709551615", u) && u == UINT64_MAX);
+    assert(!utils::parseUInt64("18446744073709551616", u) && !utils::parseUInt64("-1", u));
+    
+    std::cout << "Tokenizer tests passed!\n";
+}
+
+void testTimestampFormatter() {
+    std::cout << "Testing cached timestamp formatter...\n";
+    
+    auto reference = [](int64_t nanos, int digits) {
+        int64_t second = nanos / 1000000000;
+        int64_t frac = nanos % 1000000000;
+        if (frac < 0) { frac += 1000000000; --second; }
+        std::time_t time = static_cast<std::time_t>(second);
+        std::tm local{};
+        localtime_r(&time, &local);
+        char text[64];
+        size_t len = std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &local);
+        if (digits == 3) std::snprintf(text + len, sizeof(text) - len, ".%03d", static_cast<int>(frac / 1000000));
+        if (digits == 6) std::snprintf(text + len, sizeof(text) - len, ".%06d", static_cast<int>(frac / 1000));
+        return std::string(text);
+    };
+    
+    // Walk across second, minute, hour and day boundaries in uneven steps
+    int64_t start = int64_t(1700000000) * 1000000000 - int64_t(3) * 3600 * 1000000000;
+    for (int64_t t = start; t < start + 26 * 3600LL * 1000000000LL; t += 7919LL * 1000000LL + 123457) {
+        assert(TimestampFormatter::toString(t) == reference(t, 6));
+        assert(TimestampFormatter::toString(t, TimestampPrecision::MILLIS) == reference(t, 3));
+        assert(TimestampFormatter::toString(t, TimestampPrecision::SECONDS) == reference(t, 0));
+    }
+    // Around the 2023-11-05 US DST change (a no-op check in zones without it)
+    int64_t dst = int64_t(1699160000) * 1000000000;
+    for (int64_t t = dst; t < dst + int64_t(4) * 3600 * 1000000000; t += int64_t(1000000000) * 13) {
+        assert(TimestampFormatter::toString(t, TimestampPrecision::SECONDS) == reference(t, 0));
+    }
+    // Backwards jumps and pre-epoch times
+    for (int64_t t : {start, start - 1, int64_t(-1), int64_t(0), int64_t(-1500000001), int64_t(start + 59999999999LL)}) {
+        assert(TimestampFormatter::toString(t) == reference(t, 6));
+    }
+    
+    char buffer[TimestampFormatter::MAX_LENGTH];
+    char* end = TimestampFormatter::format(buffer, start, TimestampPrecision::MILLIS);
+    assert(static_cast<size_t>(end - buffer) == TimestampFormatter::length(TimestampPrecision::MILLIS));
+    
+    // Per-thread caches do not interfere
+    std::atomic<bool> consistent{true};
+    std::vector<std::thread> threads;
+    for (int id = 0; id < 4; ++id) {
+        threads.emplace_back([&, id]() {
+            int64_t base = start + id * 86400LL * 1000000000LL;
+            for (int i = 0; i < 2000; ++i) {
+                int64_t t = base + i * 997LL * 1000000LL;
+                if (TimestampFormatter::toString(t) != reference(t, 6)) consistent = false;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    assert(consistent);
+    
+    auto now = std::chrono::system_clock::now();
+    int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+    assert(utils::formatTimestamp(now) == reference(now_ns, 3));
+    
+    std::cout << "Timestamp formatter tests passed!\n";
+}
+
+void testAllocTracker() {
+    std::cout << "Testing allocation tracking...\n";
+
+    // test_basic links the interposer, so counting is live
+    assert(AllocTracker::isInstalled());
+
+    {
+        // Direct calls: the optimizer may elide a new-expression/delete pair
+        AllocScope scope;
+        void* block = ::operator new(64);
+        assert(scope.allocations() == 1);
+        assert(scope.bytes() == 64);
+        ::operator delete(block);
+        assert(scope.deallocations() == 1);
+        std::vector<double> values(64);
+        assert(scope.allocations() == 2);
+        assert(scope.bytes() == 64 + 64 * sizeof(double));
+    }
+
+    // Counters are per thread
+    {
+        AllocScope scope;
+        std::thread worker([]() { std::vector<int> v(1000); v[0] = 1; });
+        worker.join();
+        assert(scope.allocations() <= 1);  // The thread's own state, not its vector
+    }
+
+    // A region that allocates is recorded as a violation
+    uint64_t violations = AllocTracker::getViolationCount();
+    {
+        NoAllocRegion region("deliberate");
+        std::string text(100, 'x');
+        assert(!region.ok());
+    }
+    assert(AllocTracker::getViolationCount() == violations + 1);
+    assert(std::string(AllocTracker::getLastViolation()) == "deliberate");
+    violations = AllocTracker::getViolationCount();
+
+    // Hot paths that must stay allocation-free
+    OrderBook book("ALLOC");
+    for (int i = 0; i < 20; ++i) {
+        book.addOrder(OrderSide::BUY, OrderType::LIMIT, 99.0 - i * 0.01, 100.0);
+        book.addOrder(OrderSide::SELL, OrderType::LIMIT, 101.0 + i * 0.01, 100.0);
+    }
+    std::vector<double> data(1000);
+    Xoshiro256pp rng(42);
+    char stamp[TimestampFormatter::MAX_LENGTH];
+    TimestampFormatter::format(stamp, 1700000000LL * 1000000000LL);  // Warm the minute cache
+    RollingMoments moments(50);
+    double parsed = 0.0;
+    {
+        NoAllocRegion region("hot paths");
+        TopOfBook top = book.getTopOfBook();
+        assert(top.best_bid == 99.0 && top.best_ask == 101.0);
+        assert(book.getMidPrice() == 100.0);
+        rng.fillNormal(data.data(), data.size());
+        assert(std::isfinite(kernels::variance(data.data(), data.size(), true)));
+        for (double v : data) moments.add(v);
+        TimestampFormatter::format(stamp, 1700000000LL * 1000000000LL + 5000);
+        assert(utils::parseDouble("150.25", parsed) && parsed == 150.25);
+        assert(region.ok());
+    }
+    assert(AllocTracker::getViolationCount() == violations);
+
+    // Today's per-order and per-tick costs, for the record
+    AllocScope per_order;
+    book.addOrder(OrderSide::BUY, OrderType::LIMIT, 98.5, 10.0);
+    std::cout << "  addOrder: " << per_order.allocations() << " allocations\n";
+
+    auto tick_book = std::make_shared<OrderBook>("TICK");
+    auto generator = std::make_shared<PriceGenerator>(100.0, 0.05, 0.2);
+    MarketMaker maker(tick_book, generator, MarketMakerConfig());
+    maker.step();
+    AllocScope per_tick;
+    for (int i = 0; i < 10; ++i) {
+        generator->generateNextPrice();
+        maker.step();
+    }
+    std::cout << "  MarketMaker::step: " << per_tick.allocations() / 10.0 << " allocations per tick\n";
+
+    std::cout << "Allocation tracking tests passed!\n";
+}
+
+void testLockProfiling() {
+    std::cout << "Testing lock profiling...\n";
+
+    // Log-linear buckets: exact below 4ns, then four per power of two
+    assert(LatencyHistogram::bucketIndex(3) == 3);
+    assert(LatencyHistogram::bucketIndex(4) == 4);
+    assert(LatencyHistogram::bucketIndex(9) == 8);
+    assert(LatencyHistogram::bucketUpperBound(8) == 9);
+    for (uint64_t v : {5ULL, 100ULL, 12345ULL, 1ULL << 40, ~0ULL}) {
+        size_t index = LatencyHistogram::bucketIndex(v);
+        assert(index < LatencyHistogram::BUCKETS);
+        assert(v <= LatencyHistogram::bucketUpperBound(index));
+        assert(index == 0 || v > LatencyHistogram::bucketUpperBound(index - 1));
+    }
+
+    LatencyHistogram histogram;
+    assert(histogram.getPercentile(50.0) == 0);
+    for (uint64_t ns = 1; ns <= 1000; ++ns) {
+        histogram.record(ns);
+    }
+    assert(histogram.getCount() == 1000);
+    assert(histogram.getMax() == 1000);
+    assert(std::abs(histogram.getMean() - 500.5) < 1e-9);
+    uint64_t p50 = histogram.getPercentile(50.0);
+    assert(p50 >= 500 && p50 <= 500 * 5 / 4);
+    assert(histogram.getPercentile(100.0) == 1000);
+    histogram.reset();
+    assert(histogram.getCount() == 0 && histogram.getMax() == 0);
+
+    if (!LockProfiler::isEnabled()) {
+        // Compiles down to a plain mutex
+        assert(sizeof(ProfiledMutex) == sizeof(std::mutex));
+        assert(LockProfiler::report().find("disabled") != std::string::npos);
+        std::cout << "Lock profiling tests passed (profiling disabled in this build)!\n";
+        return;
+    }
+
+    // Force one contended acquisition: the worker blocks while we hold the lock
+    ProfiledMutex mutex("test_mutex");
+    LockStats& stats = LockProfiler::stats("test_mutex");
+    std::atomic<bool> worker_started{false};
+    std::thread worker;
+    {
+        std::lock_guard<ProfiledMutex> hold(mutex);
+        worker = std::thread([&]() {
+            worker_started = true;
+            std::lock_guard<ProfiledMutex> lock(mutex);
+        });
+        while (!worker_started) {
+            std::this_thread::yield();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    worker.join();
+    assert(stats.acquisitions == 2);
+    assert(stats.contended == 1);
+    assert(stats.wait_ns.getCount() == 1 && stats.wait_ns.getMax() > 0);
+    assert(stats.hold_ns.getCount() == 2 && stats.hold_ns.getMax() >= 5000000);
+
+    // The component mutexes register under their member names
+    OrderBook book("LOCKS");
+    book.addOrder(OrderSide::BUY, OrderType::LIMIT, 99.0, 10.0);
+    assert(LockProfiler::stats("order_book_mutex").acquisitions > 0);
+    std::string report = LockProfiler::report();
+    assert(report.find("test_mutex: 2 acquisitions, 1 contended") != std::string::npos);
+    assert(report.find("order_book_mutex") != std::string::npos);
+
+    std::cout << "Lock profiling tests passed!\n";
+}
+
+void testTracing() {
+    std::cout << "Testing tracing...\n";
+
+    // Off by default: scopes record nothing
+    assert(!Tracer::isEnabled());
+    OrderBook book("TRACE");
+    book.addOrder(OrderSide::BUY, OrderType::LIMIT, 99.0, 10.0);
+    assert(Tracer::getEventCount() == 0);
+
+    Tracer::setRingCapacity(16);
+    Tracer::setEnabled(true);
+    Tracer::setThreadName("test main");
+    book.addOrder(OrderSide::SELL, OrderType::LIMIT, 101.0, 10.0);
+    Tracer::instant("test", "marker");
+    assert(Tracer::getEventCount() == 2);
+
+    // A full ring keeps the most recent records; exited threads stay dumpable
+    std::thread worker([]() {
+        Tracer::setThreadName("worker");
+        for (int i = 0; i < 40; ++i) {
+            TraceScope scope("test", "worker_step");
+        }
+    });
+    worker.join();
+    assert(Tracer::getEventCount() == 2 + 16);
+
+    assert(Tracer::writeChromeTrace("test_trace.json"));
+    std::ifstream file("test_trace.json");
+    std::string json((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::remove("test_trace.json");
+    assert(json.find("\"traceEvents\"") != std::string::npos);
+    assert(json.find("\"name\": \"OrderBook::addOrder\"") != std::string::npos);
+    assert(json.find("\"args\": {\"name\": \"worker\"}") != std::string::npos);
+    assert(json.find("\"args\": {\"name\": \"test main\"}") != std::string::npos);
+    size_t steps = 0;
+    for (size_t pos = json.find("worker_step"); pos != std::string::npos; pos = json.find("worker_step", pos + 1)) {
+        ++steps;
+    }
+    assert(steps == 16);
+
+    // Runtime toggle
+    Tracer::setEnabled(false);
+    book.addOrder(OrderSide::BUY, OrderType::LIMIT, 98.0, 10.0);
+    assert(Tracer::getEventCount() == 2 + 16);
+    Tracer::clear();
+    assert(Tracer::getEventCount() == 0);
+    Tracer::setRingCapacity(1 << 16);
+
+    std::cout << "Tracing tests passed!\n";
+}
+
+void testClock() {
+    std::cout << "Testing Clock...\n";
+
+    assert(std::string(Clock::source()) == (Clock::isTsc() ? "tsc" : "monotonic"));
+    assert(Clock::ticksPerSecond() > 0.0);
+
+    // Both reads are monotonic and share one tick domain
+    uint64_t a = Clock::nowPrecise();
+    uint64_t b = Clock::nowPrecise();
+    assert(b >= a);
+    uint64_t c = Clock::now();
+    uint64_t d = Clock::now();
+    assert(d >= c);
+
+    // Durations convert through the calibrated rate
+    uint64_t start = Clock::nowPrecise();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    uint64_t elapsed_ns = Clock::toNanos(Clock::nowPrecise() - start);
+    assert(elapsed_ns >= 15000000 && elapsed_ns < 200000000);
+    uint64_t round_trip = Clock::toNanos(Clock::fromNanos(1000000000));
+    assert(round_trip > 999990000 && round_trip < 1000010000);
+
+    // Wall conversion tracks system_clock
+    int64_t wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    assert(std::llabs(Clock::toWallNs(Clock::now()) - wall_ns) < 50000000);
+
+    // Order ages are measured in Clock ticks
+    Order order(1, "CLK", OrderSide::BUY, OrderType::LIMIT, 100.0, 10.0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(15));
+    assert(order.getAgeMs() >= 10);
+
+    std::cout << "Clock tests passed!\n";
+}
+
 void testMarketMaker() {
     std::cout << "Testing MarketMaker class...\n";
     
@@ -114,7 +1444,26 @@ void testMarketMaker() {
     // Test basic functionality
     assert(!market_maker->isRunning());
     assert(!market_maker->isRiskLimitExceeded());
-    
+
+    // Tick-to-quote latency: one sample per tick that gets quoted
+    const LatencyHistogram& latency = market_maker->getTickToQuoteLatency();
+    market_maker->start();
+    market_maker->step();
+    assert(latency.getCount() == 0);  // No tick generated yet
+    price_gen->generateNextPrice();
+    assert(price_gen->getLastTickTimestamp() > 0);
+    market_maker->step();
+    assert(latency.getCount() == 1);
+    assert(latency.getMax() > 0);
+    market_maker->step();
+    assert(latency.getCount() == 1);  // Same tick, quoted again
+    price_gen->generateNextPrice();
+    market_maker->step();
+    assert(latency.getCount() == 2);
+    assert(market_maker->getStatusString().find("Tick-to-Quote Latency: n=2") != std::string::npos);
+    market_maker->resetTickToQuoteLatency();
+    assert(latency.getCount() == 0);
+
     std::cout << "MarketMaker tests passed!\n";
 }
 
@@ -135,6 +1484,43 @@ void testSimulationEngine() {
     // Test basic functionality
     assert(!engine.isRunning());
     
+    // A configured seed reproduces the price path, even when other threads
+    // start drawing random numbers between the runs
+    auto seeded_marks = [&mm_config](uint64_t seed) {
+        SystemConfig seeded_config;
+        seeded_config.initial_price = 150.0;
+        seeded_config.simulation_duration_ms = 60;
+        seeded_config.tick_interval_ms = 1;
+        seeded_config.seed = seed;
+        SimulationEngine seeded(seeded_config, mm_config);
+        assert(seeded.enableEventLog("test_seeded.hftlog"));
+        seeded.start();
+        while (seeded.isRunning()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        seeded.stop();
+        
+        EventLogReader reader("test_seeded.hftlog");
+        std::vector<EventRecord> records;
+        reader.poll(records);
+        std::vector<double> marks;
+        for (const auto& record : records) {
+            if (record.type == static_cast<uint32_t>(EventType::TICK)) {
+                marks.push_back(record.values[0]);
+            }
+        }
+        std::remove("test_seeded.hftlog");
+        return marks;
+    };
+    std::vector<double> first_run = seeded_marks(2024);
+    std::thread([]() { rng::threadGenerator()(); }).join();
+    std::vector<double> second_run = seeded_marks(2024);
+    std::vector<double> other_seed = seeded_marks(2025);
+    size_t common = std::min(first_run.size(), second_run.size());
+    assert(common >= 3 && !other_seed.empty());
+    assert(std::equal(first_run.begin(), first_run.begin() + common, second_run.begin()));
+    assert(other_seed[0] != first_run[0]);
+    
     std::cout << "SimulationEngine tests passed!\n";
 }
 
@@ -147,6 +1533,21 @@ int main() {
         testOrderBook();
         testPriceGenerator();
         testPnLCalculator();
+        testLotEngine();
+        testSnapshotPolicies();
+        testSeqLockPublication();
+        testPortfolioPnL();
+        testColumnarFile();
+        testEventLog();
+        testSlidingStats();
+        testNumericKernels();
+        testRandom();
+        testTokenizer();
+        testTimestampFormatter();
+        testAllocTracker();
+        testLockProfiling();
+        testTracing();
+        testClock();
         testMarketMaker();
         testSimulationEngine();
         
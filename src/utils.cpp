@@ -1,12 +1,17 @@
 #include "Utils.h"
+#include "SlidingStats.h"
+#include "NumericKernels.h"
+#include "Random.h"
+#include "Tokenizer.h"
+#include "TimestampFormatter.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <fstream>
 #include <filesystem>
-#include <random>
 #include <algorithm>
 #include <cmath>
+#include <numeric>
 
 namespace hft {
 namespace utils {
@@ -18,18 +23,13 @@ std::string formatPrice(double price, int decimals) {
 }
 
 std::string formatTimestamp(const std::chrono::system_clock::time_point& time) {
-    auto time_t = std::chrono::system_clock::to_time_t(time);
-    std::tm* tm = std::localtime(&time_t);
-    
-    std::ostringstream oss;
-    oss << std::put_time(tm, "%Y-%m-%d %H:%M:%S");
-    
-    // Add milliseconds
-    auto duration = time.time_since_epoch();
-    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() % 1000;
-    oss << "." << std::setfill('0') << std::setw(3) << millis;
-    
-    return oss.str();
+    int64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    return TimestampFormatter::toString(nanos, TimestampPrecision::MILLIS);
+}
+
+int64_t getCurrentTimestampNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
 }
 
 double roundToTick(double price, double tick_size) {
@@ -48,37 +48,27 @@ double calculatePercentage(double value, double base) {
 }
 
 double generateRandomDouble(double min, double max) {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_real_distribution<double> dis(min, max);
-    return dis(gen);
+    return rng::threadGenerator().uniform(min, max);
 }
 
 int generateRandomInt(int min, int max) {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> dis(min, max);
-    return dis(gen);
+    return static_cast<int>(rng::threadGenerator().uniformInt(min, max));
 }
 
 std::vector<std::string> splitString(const std::string& str, char delimiter) {
     std::vector<std::string> tokens;
-    std::stringstream ss(str);
-    std::string token;
+    Tokenizer tokenizer(str, delimiter);
+    std::string_view token;
     
-    while (std::getline(ss, token, delimiter)) {
-        tokens.push_back(token);
+    while (tokenizer.next(token)) {
+        tokens.emplace_back(token);
     }
     
     return tokens;
 }
 
 std::string trimString(const std::string& str) {
-    size_t start = str.find_first_not_of(" \t\n\r");
-    if (start == std::string::npos) return "";
-    
-    size_t end = str.find_last_not_of(" \t\n\r");
-    return str.substr(start, end - start + 1);
+    return std::string(trimView(str));
 }
 
 bool fileExists(const std::string& filename) {
@@ -103,16 +93,7 @@ void createDirectory(const std::string& path) {
 double calculateVolatility(const std::vector<double>& returns) {
     if (returns.size() < 2) return 0.0;
     
-    double mean = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
-    
-    double variance = 0.0;
-    for (double ret : returns) {
-        double diff = ret - mean;
-        variance += diff * diff;
-    }
-    variance /= (returns.size() - 1); // Sample variance
-    
-    return std::sqrt(variance);
+    return std::sqrt(kernels::variance(returns.data(), returns.size(), true)); // Sample variance
 }
 
 double calculateSharpeRatio(const std::vector<double>& returns, double risk_free_rate) {
@@ -121,30 +102,14 @@ double calculateSharpeRatio(const std::vector<double>& returns, double risk_free
     double volatility = calculateVolatility(returns);
     if (volatility == 0.0) return 0.0;
     
-    double mean_return = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
+    double mean_return = kernels::mean(returns.data(), returns.size());
     double excess_return = mean_return - risk_free_rate;
     
     return excess_return / volatility;
 }
 
 double calculateMaxDrawdown(const std::vector<double>& values) {
-    if (values.empty()) return 0.0;
-    
-    double max_dd = 0.0;
-    double peak = values[0];
-    
-    for (double value : values) {
-        if (value > peak) {
-            peak = value;
-        }
-        
-        double drawdown = peak - value;
-        if (drawdown > max_dd) {
-            max_dd = drawdown;
-        }
-    }
-    
-    return max_dd;
+    return kernels::maxDrawdown(values.data(), values.size());
 }
 
 double calculateVaR(const std::vector<double>& returns, double confidence_level) {
@@ -217,54 +182,30 @@ double calculateCorrelation(const std::vector<double>& x, const std::vector<doub
     
     size_t n = x.size();
     
-    double sum_x = std::accumulate(x.begin(), x.end(), 0.0);
-    double sum_y = std::accumulate(y.begin(), y.end(), 0.0);
-    double sum_xy = 0.0;
-    double sum_x2 = 0.0;
-    double sum_y2 = 0.0;
-    
-    for (size_t i = 0; i < n; ++i) {
-        sum_xy += x[i] * y[i];
-        sum_x2 += x[i] * x[i];
-        sum_y2 += y[i] * y[i];
-    }
-    
-    double numerator = n * sum_xy - sum_x * sum_y;
-    double denominator = std::sqrt((n * sum_x2 - sum_x * sum_x) * (n * sum_y2 - sum_y * sum_y));
+    // Centered two-pass form; the raw-sum formula cancels badly for prices
+    double mean_x = kernels::mean(x.data(), n);
+    double mean_y = kernels::mean(y.data(), n);
+    kernels::CrossMoments moments = kernels::crossMoments(x.data(), y.data(), n, mean_x, mean_y);
     
+    double denominator = std::sqrt(moments.sxx * moments.syy);
     if (denominator == 0.0) return 0.0;
     
-    return numerator / denominator;
+    return moments.sxy / denominator;
 }
 
 std::vector<double> calculateRollingAverage(const std::vector<double>& data, size_t window) {
-    if (data.size() < window) return {};
-    
-    std::vector<double> result;
-    result.reserve(data.size() - window + 1);
-    
-    for (size_t i = window - 1; i < data.size(); ++i) {
-        double sum = 0.0;
-        for (size_t j = 0; j < window; ++j) {
-            sum += data[i - j];
-        }
-        result.push_back(sum / window);
-    }
-    
+    if (window == 0 || data.size() < window) return {};
+
+    std::vector<double> result(data.size() - window + 1);
+    sliding::rollingMean(data.data(), data.size(), window, result.data());
     return result;
 }
 
 std::vector<double> calculateRollingVolatility(const std::vector<double>& returns, size_t window) {
-    if (returns.size() < window) return {};
-    
-    std::vector<double> result;
-    result.reserve(returns.size() - window + 1);
-    
-    for (size_t i = window - 1; i < returns.size(); ++i) {
-        std::vector<double> window_returns(returns.begin() + i - window + 1, returns.begin() + i + 1);
-        result.push_back(calculateVolatility(window_returns));
-    }
-    
+    if (window == 0 || returns.size() < window) return {};
+
+    std::vector<double> result(returns.size() - window + 1);
+    sliding::rollingStddev(returns.data(), returns.size(), window, result.data(), true);
     return result;
 }
 
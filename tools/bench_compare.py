@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""
+Benchmark regression check for hft_bench results
+
+Compares one or more candidate result files (hft_bench --json) against a
+baseline. Each benchmark's per-repetition ns/op values are reduced to a
+median per run, the runs to their median, and the relative delta gets a
+bootstrap confidence interval from resampling runs and repetitions. Pass
+several runs per side where possible: run-to-run drift is usually larger
+than the spread within one run. A benchmark is flagged as a regression only
+when the delta exceeds the threshold AND the interval excludes zero, so
+noisy cases don't trip the check.
+
+The default baseline is the pinned file bench/baselines/baseline.json, which
+holds the key scenarios (order book operations, MarketMaker::step, PnL
+updates). Timings are machine specific: re-pin on the machine that runs the
+comparison.
+
+    ./bin/hft_bench --json new.json
+    tools/bench_compare.py --candidate new.json
+    tools/bench_compare.py --baseline old.json old2.json --candidate new.json new2.json
+    tools/bench_compare.py --candidate new.json --pin bench/baselines/baseline.json
+
+Exits with status 1 when a regression is found.
+"""
+
+import argparse
+import json
+import random
+import statistics
+import sys
+from pathlib import Path
+
+DEFAULT_BASELINE = Path(__file__).resolve().parent.parent / "bench" / "baselines" / "baseline.json"
+
+# Scenarios kept when pinning a baseline
+KEY_SCENARIOS = (
+    "orderbook/add",
+    "orderbook/cancel",
+    "orderbook/amend",
+    "orderbook/market_sweep",
+    "orderbook/top_of_book",
+    "orderbook/depth",
+    "price/next_price",
+    "market_maker/step",
+    "pnl/record_trade",
+    "pnl/mark_update",
+)
+
+
+def benchmark_key(entry):
+    params = entry.get("params") or {}
+    if not params:
+        return entry["name"]
+    return entry["name"] + "[" + ",".join(f"{k}={v}" for k, v in params.items()) + "]"
+
+
+def load_runs(paths):
+    """Return {benchmark key: [per-run lists of ns/op]} across the given files."""
+    runs = {}
+    for path in paths:
+        with open(path) as f:
+            document = json.load(f)
+        for entry in document.get("benchmarks", []):
+            # Pinned baselines keep each contributing run separately
+            entry_runs = entry.get("runs") or [entry.get("rep_ns_per_op") or [entry["p50"]]]
+            for values in entry_runs:
+                runs.setdefault(benchmark_key(entry), []).append([float(v) for v in values])
+    return runs
+
+
+def median_of_runs(runs):
+    return statistics.median(statistics.median(run) for run in runs)
+
+
+def resample(runs, rng):
+    """Resample runs (when there are several), then repetitions within each."""
+    if len(runs) > 1:
+        runs = [rng.choice(runs) for _ in runs]
+    return [[rng.choice(run) for _ in run] for run in runs]
+
+
+def compare(base_runs, cand_runs, confidence, resamples, rng):
+    """Point estimate and bootstrap interval of the relative change in ns/op."""
+    base = median_of_runs(base_runs)
+    cand = median_of_runs(cand_runs)
+    delta = cand / base - 1.0 if base > 0 else 0.0
+
+    deltas = []
+    for _ in range(resamples):
+        b = median_of_runs(resample(base_runs, rng))
+        c = median_of_runs(resample(cand_runs, rng))
+        if b > 0:
+            deltas.append(c / b - 1.0)
+    deltas.sort()
+    if not deltas:
+        return base, cand, delta, (delta, delta)
+    tail = (1.0 - confidence) / 2.0
+    low = deltas[int(tail * (len(deltas) - 1))]
+    high = deltas[int(round((1.0 - tail) * (len(deltas) - 1)))]
+    return base, cand, delta, (low, high)
+
+
+def verdict(delta, interval, threshold):
+    if delta > threshold and interval[0] > 0.0:
+        return "REGRESSION"
+    if delta < -threshold and interval[1] < 0.0:
+        return "faster"
+    return "~"
+
+
+def pin(candidate_paths, output, scenarios):
+    """Write the candidate results for the key scenarios as the pinned baseline."""
+    with open(candidate_paths[0]) as f:
+        document = json.load(f)
+    others = load_runs(candidate_paths[1:])
+
+    kept = []
+    for entry in document.get("benchmarks", []):
+        if scenarios and entry["name"] not in scenarios:
+            continue
+        entry["runs"] = [entry.pop("rep_ns_per_op", [])] + others.get(benchmark_key(entry), [])
+        kept.append(entry)
+    document["benchmarks"] = kept
+    document["pinned_from"] = [Path(p).name for p in candidate_paths]
+
+    # One benchmark per line keeps re-pinning diffs readable
+    Path(output).parent.mkdir(parents=True, exist_ok=True)
+    header = {k: v for k, v in document.items() if k != "benchmarks"}
+    with open(output, "w") as f:
+        f.write(json.dumps(header, indent=1)[:-2] + ',\n "benchmarks": [\n')
+        f.write(",\n".join("  " + json.dumps(entry) for entry in kept))
+        f.write("\n ]\n}\n")
+    print(f"Pinned {len(kept)} benchmarks to {output}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare hft_bench JSON results")
+    parser.add_argument("--baseline", nargs="+", default=[str(DEFAULT_BASELINE)],
+                        help="Baseline result files (default: the pinned baseline)")
+    parser.add_argument("--candidate", nargs="+", required=True, help="Candidate result files")
+    parser.add_argument("--threshold", type=float, default=10.0, help="Regression threshold in percent")
+    parser.add_argument("--confidence", type=float, default=0.95, help="Confidence level of the interval")
+    parser.add_argument("--resamples", type=int, default=2000, help="Bootstrap resamples")
+    parser.add_argument("--filter", default="", help="Only compare benchmarks containing this text")
+    parser.add_argument("--seed", type=int, default=1, help="Bootstrap seed")
+    parser.add_argument("--pin", metavar="FILE", help="Write the candidate's key scenarios to FILE and exit")
+    parser.add_argument("--all-scenarios", action="store_true", help="Pin every benchmark, not just the key ones")
+    args = parser.parse_args()
+
+    if args.pin:
+        pin(args.candidate, args.pin, None if args.all_scenarios else KEY_SCENARIOS)
+        return 0
+
+    base = load_runs(args.baseline)
+    cand = load_runs(args.candidate)
+    names = [name for name in base if name in cand and args.filter in name]
+    if not names:
+        print("No benchmarks in common", file=sys.stderr)
+        return 2
+
+    rng = random.Random(args.seed)
+    threshold = args.threshold / 100.0
+    width = max(len(name) for name in names)
+    regressions = 0
+
+    print(f"{'benchmark':<{width}} {'base ns':>10} {'cand ns':>10} {'delta':>8}  "
+          f"{int(args.confidence * 100)}% CI")
+    for name in names:
+        b, c, delta, (low, high) = compare(base[name], cand[name], args.confidence, args.resamples, rng)
+        flag = verdict(delta, (low, high), threshold)
+        regressions += flag == "REGRESSION"
+        print(f"{name:<{width}} {b:>10.1f} {c:>10.1f} {delta * 100:>+7.1f}%  "
+              f"[{low * 100:+.1f}%, {high * 100:+.1f}%]  {flag}")
+
+    missing = sorted(set(base) - set(cand))
+    if missing and not args.filter:
+        print(f"Missing from candidate: {', '.join(missing)}")
+    print(f"{len(names)} compared, {regressions} regression(s) above {args.threshold:g}%")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,82 @@
+// Follow the engine's live event log and print running metrics.
+//
+//   ./bin/event_tail data/events.hftlog [interval_ms]
+
+#include "EventLog.h"
+#include "Tokenizer.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+using namespace hft;
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "data/events.hftlog";
+    int64_t interval_ms = 1000;
+    if (argc > 2 && (!utils::parseInt64(argv[2], interval_ms) || interval_ms <= 0)) {
+        std::cerr << "Invalid interval: " << argv[2] << "\n";
+        return 1;
+    }
+
+    EventLogReader reader(path);
+    if (!reader.isOpen()) {
+        std::cerr << "Could not open event log: " << path << "\n";
+        return 1;
+    }
+
+    std::cout << "Following " << path << " (capacity " << reader.getCapacity() << " records)" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    std::vector<EventRecord> batch;
+    uint64_t ticks = 0;
+    double peak_pnl = 0.0;
+    double max_drawdown = 0.0;
+    double last_price = 0.0;
+    double last_pnl = 0.0;
+    double last_position = 0.0;
+
+    for (;;) {
+        batch.clear();
+        reader.poll(batch);
+
+        uint64_t interval_ticks = 0;
+        for (const auto& record : batch) {
+            switch (static_cast<EventType>(record.type)) {
+                case EventType::SIMULATION_START:
+                    std::cout << "--- simulation started at " << record.values[0] << " ---\n";
+                    ticks = 0;
+                    peak_pnl = 0.0;
+                    max_drawdown = 0.0;
+                    break;
+                case EventType::TICK:
+                    ++ticks;
+                    ++interval_ticks;
+                    last_price = record.values[0];
+                    last_position = record.values[3];
+                    last_pnl = record.values[5];
+                    peak_pnl = std::max(peak_pnl, last_pnl);
+                    max_drawdown = std::max(max_drawdown, peak_pnl - last_pnl);
+                    break;
+                case EventType::SIMULATION_STOP:
+                    std::cout << "--- simulation stopped ---\n";
+                    break;
+            }
+        }
+
+        if (interval_ticks > 0) {
+            std::cout << "ticks=" << ticks
+                      << " rate=" << (interval_ticks * 1000.0 / interval_ms) << "/s"
+                      << " price=" << last_price
+                      << " position=" << last_position
+                      << " pnl=" << last_pnl
+                      << " max_dd=" << max_drawdown
+                      << " dropped=" << reader.getDropped() << std::endl;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+    }
+}